@@ -18,23 +18,35 @@
 #include <pybind11/embed.h>
 
 #include <algorithm>
+#include <fstream>
 #include <memory>
+#include <string>
+#include <unordered_map>
 #include <utility>
 
 #include "cinn/auto_schedule/database/jsonfile_database.h"
+#include "cinn/auto_schedule/measure/sandbox_runner.h"
 #include "cinn/auto_schedule/measure/schedule_measurer.h"
 #include "cinn/auto_schedule/measure/simple_builder.h"
 #include "cinn/auto_schedule/measure/simple_runner.h"
+#include "cinn/auto_schedule/search_space/search_state.h"
 #include "cinn/auto_schedule/task/task_creator.h"
 #include "cinn/auto_schedule/task/task_registry.h"
 #include "cinn/auto_schedule/task/tune_task.h"
 #include "cinn/auto_schedule/task_scheduler/task_scheduler.h"
 #include "cinn/common/context.h"
 #include "cinn/common/type.h"
+#include "cinn/hlir/framework/kernel_cache.h"
 #include "cinn/hlir/framework/op.h"
 #include "cinn/hlir/framework/visualize_helper.h"
+#include "cinn/ir/ir_schedule.h"
+#include "cinn/ir/schedule_desc.h"
+#include "cinn/optim/ir_copy.h"
+#include "cinn/runtime/flags.h"
 #include "cinn/utils/string.h"
 
+DECLARE_bool(auto_schedule_use_cost_model);
+
 namespace cinn {
 namespace auto_schedule {
 
@@ -42,9 +54,33 @@ AutoTuner::AutoTuner(const common::Target& target, hlir::framework::Graph* graph
 
 void AutoTuner::Initialize(const Config& config, hlir::framework::GraphCompiler* graph_compiler) {
   // create builder, runner, and schedule measurer
-  builder_           = std::make_unique<SimpleBuilder>(graph_compiler);
-  runner_            = std::make_unique<SimpleRunner>(config.runner_repeat_times);
-  schedule_measurer_ = std::make_unique<ScheduleMeasurer>(builder_.get(), runner_.get());
+  builder_ = std::make_unique<SimpleBuilder>(graph_compiler);
+  runner_  = std::make_unique<SimpleRunner>(config.runner_repeat_times);
+  // the sandboxed candidates can run at the same time on their own cores
+  int num_measure_threads = 1;
+  if (config.use_sandbox_runner) {
+    // the sandbox forks its servers on construction, so it is created before the measuring threads start
+    SandboxRunner::Config sandbox_config;
+    sandbox_config.cores      = config.sandbox_cores;
+    sandbox_config.timeout_ms = config.sandbox_timeout_ms;
+    runner_                   = std::make_unique<SandboxRunner>(std::move(runner_), sandbox_config);
+    num_measure_threads       = std::max<int>(config.sandbox_cores.size(), 1);
+  }
+  schedule_measurer_ = std::make_unique<ScheduleMeasurer>(builder_.get(), runner_.get(), num_measure_threads);
+  if (config.num_build_threads > 0) {
+    // GraphCompiler is not thread-safe, so every other build thread compiles with its own one and scope
+    std::vector<ScheduleBuilder*> build_workers = {builder_.get()};
+    worker_graph_compilers_.clear();
+    worker_builders_.clear();
+    const auto& graph = graph_compiler->GetGraph();
+    for (int i = 1; i < config.num_build_threads; ++i) {
+      auto scope = hlir::framework::BuildScope(target_, graph);
+      worker_graph_compilers_.emplace_back(std::make_unique<hlir::framework::GraphCompiler>(target_, scope, graph));
+      worker_builders_.emplace_back(std::make_unique<SimpleBuilder>(worker_graph_compilers_.back().get()));
+      build_workers.push_back(worker_builders_.back().get());
+    }
+    schedule_measurer_->EnablePipeline(build_workers, 0, config.runner_core);
+  }
 
   // initialize database
   database_ = std::move(Database::Make(config.database_config));
@@ -75,16 +111,51 @@ void AutoTuner::Initialize(const Config& config, hlir::framework::GraphCompiler*
     VLOG(3) << "Add a task, id:" << i << ", serialized_key:\n" << task.serialized_key;
   }
 
+  // create the shared cost model after the tasks are registered, so their records can be replayed
+  if (config.cost_model_warm_start && FLAGS_auto_schedule_use_cost_model) {
+    cost_model_      = std::make_unique<ExprCostModel>();
+    cost_model_path_ = config.cost_model_path;
+    WarmStartCostModel();
+  }
+
   // create task optimizers
   task_optimizers_.resize(tasks_.size());
   std::transform(tasks_.begin(), tasks_.end(), task_optimizers_.begin(), [&](const TuneTask& task) {
-    return std::make_unique<TaskOptimizer>(task, schedule_measurer_.get(), database_.get());
+    return std::make_unique<TaskOptimizer>(task, schedule_measurer_.get(), database_.get(), cost_model_.get());
   });
 
   // create task scheduler
   task_scheduler_ = TaskScheduler::Make(tasks_, config.task_schedule_config, config.task_schedule_strategy);
 }
 
+void AutoTuner::WarmStartCostModel() {
+  // rebuild the scheduled ModuleExprs of the records by replaying their traces on the initial ones
+  InitialTaskRegistry* task_registry = InitialTaskRegistry::Global();
+  std::vector<ir::ModuleExpr> samples;
+  std::vector<float> labels;
+  for (const TuneTask& task : tasks_) {
+    for (const TuningRecord& record : database_->LookUp(task.serialized_key)) {
+      ir::IRSchedule ir_sch(optim::IRCopy(task_registry->Get(task.serialized_key)->module_expr));
+      ir::ScheduleDesc::ReplayWithProto(record.trace, &ir_sch);
+      samples.emplace_back(ir_sch.GetModule());
+      labels.emplace_back(record.execution_cost);
+    }
+  }
+
+  if (!samples.empty()) {
+    std::vector<const ir::ModuleExpr*> sample_ptrs(samples.size());
+    std::transform(
+        samples.begin(), samples.end(), sample_ptrs.begin(), [](const ir::ModuleExpr& sample) { return &sample; });
+    cost_model_->Train(sample_ptrs, labels, target_);
+    VLOG(3) << "Warm start the cost model with " << samples.size() << " tuning records";
+  } else if (!cost_model_path_.empty() && std::ifstream(cost_model_path_).good()) {
+    cost_model_->Load(cost_model_path_);
+    if (cost_model_->num_trees() > 0) {
+      VLOG(3) << "Warm start the cost model from file: " << cost_model_path_;
+    }
+  }
+}
+
 void PrintResult(const TuningResult::TunedSubGraph& sub_graph) {
   if (!VLOG_IS_ON(3)) {
     return;
@@ -162,6 +233,7 @@ TuningResult AutoTuner::Tune(const TuningOptions& options) {
       VLOG(3) << "Start tuning task id:" << run_id;
       auto* opt           = task_optimizers_.at(run_id).get();
       auto optimized_expr = opt->Optimize(options);
+      task_scheduler_->UpdateTaskCost(run_id, opt->best_cost());
       VLOG(3) << "Task finished, print optimized Expr:\n";
       PrintResult(optimized_expr);
       // update the best schedules searched so far.
@@ -169,9 +241,56 @@ TuningResult AutoTuner::Tune(const TuningOptions& options) {
     }
   }
 
+  // the tasks sharing the same serialized_key are the same group, the schedulers such as gradient_allocation
+  // only tune the first of them, so the others reuse its result
+  std::unordered_map<std::string, int> tuned_task_ids;
+  for (auto i = 0; i < tasks_.size(); ++i) {
+    if (!tasks_[i].serialized_key.empty() && !result.optimized_exprs[i].lowered_funcs.empty()) {
+      tuned_task_ids.emplace(tasks_[i].serialized_key, i);
+    }
+  }
+  for (auto i = 0; i < tasks_.size(); ++i) {
+    auto it = tuned_task_ids.find(tasks_[i].serialized_key);
+    if (result.optimized_exprs[i].lowered_funcs.empty() && it != tuned_task_ids.end()) {
+      result.optimized_exprs[i] = result.optimized_exprs[it->second];
+    }
+  }
+
+  if (cost_model_ && cost_model_->num_trees() > 0 && !cost_model_path_.empty()) {
+    cost_model_->Save(cost_model_path_);
+    VLOG(3) << "Save the cost model to file: " << cost_model_path_;
+  }
+
   PrintResult(result);
   return result;
 }
 
+TuningArtifact AutoTuner::ExportArtifact() {
+  const auto& dtype_dict = graph_->GetAttrs<absl::flat_hash_map<std::string, common::Type>>("inferdtype");
+  const auto& shape_dict = graph_->GetAttrs<absl::flat_hash_map<std::string, hlir::framework::shape_t>>("infershape");
+  InitialTaskRegistry* task_registry = InitialTaskRegistry::Global();
+  TuningArtifact artifact;
+  for (const TuneTask& task : tasks_) {
+    std::vector<TuningRecord> records = database_->GetTopK(task.serialized_key, 1);
+    if (records.empty()) {
+      continue;
+    }
+    const TuningRecord& best = records.front();
+    std::vector<ir::Expr> initial_exprs =
+        optim::IRCopy(task_registry->Get(task.serialized_key)->module_expr.GetExprs());
+    ir::IRSchedule ir_sch(ir::ModuleExpr(optim::IRCopy(initial_exprs)));
+    ir::ScheduleDesc::ReplayWithProto(best.trace, &ir_sch);
+    // skip the record whose trace doesn't reproduce its IR, such as the candidates generated by crossover
+    if (best.canonical_hash != 0 && SearchStateCanonicalHash(SearchState(ir_sch)) != best.canonical_hash) {
+      LOG(WARNING) << "The trace of the best record can't reproduce its IR, skip the task:\n" << task.serialized_key;
+      continue;
+    }
+    auto fingerprint = hlir::framework::GroupFingerprint::Compute(task.task_graph[0], dtype_dict, shape_dict, target_);
+    artifact.Add(fingerprint, initial_exprs, best.trace, ir_sch.GetModule().GetExprs(), best.execution_cost);
+  }
+  VLOG(3) << "Export " << artifact.Size() << " tuned schedules of " << tasks_.size() << " tasks";
+  return artifact;
+}
+
 }  // namespace auto_schedule
 }  // namespace cinn
@@ -18,11 +18,13 @@
 #include <string>
 #include <vector>
 
+#include "cinn/auto_schedule/cost_model/expr_cost_model.h"
 #include "cinn/auto_schedule/measure/schedule_measurer.h"
 #include "cinn/auto_schedule/task/task_optimizer.h"
 #include "cinn/auto_schedule/task/tune_task.h"
 #include "cinn/auto_schedule/task_scheduler/task_scheduler.h"
 #include "cinn/auto_schedule/tuning.h"
+#include "cinn/auto_schedule/tuning_artifact.h"
 #include "cinn/common/target.h"
 #include "cinn/hlir/framework/graph.h"
 #include "cinn/hlir/framework/graph_compiler.h"
@@ -43,7 +45,24 @@ class AutoTuner {
     std::string task_schedule_strategy = "round_robin";
     TaskScheduler::Config task_schedule_config;
     int runner_repeat_times = 1;
+    // the number of threads building the candidates concurrently while the previous ones are running,
+    // each of them builds with its own GraphCompiler, 0 means building and running the candidates in turn
+    int num_build_threads = 0;
+    // the core which the first thread running the candidates is pinned to, -1 means not pinned
+    int runner_core = -1;
+    // whether to run every candidate in a forked worker process, so the crashed or hanging
+    // candidates fail alone, and the time limit of running a candidate in milliseconds
+    bool use_sandbox_runner = false;
+    int sandbox_timeout_ms  = 10000;
+    // the cores to pin the worker processes to, the candidates measured concurrently use different cores
+    std::vector<int> sandbox_cores;
     DatabaseConfig database_config;
+    // whether all the tasks share one cost model pretrained on the tuning records of them in the database,
+    // so the history of tuning and the measurements of every task help the search of the others
+    bool cost_model_warm_start = false;
+    // the file the shared cost model is saved to after tuning, it's loaded to warm start the
+    // cost model when the database has no record of the tasks, and empty means not saved
+    std::string cost_model_path;
   };
 
   AutoTuner(const common::Target& target, hlir::framework::Graph* graph);
@@ -54,7 +73,15 @@ class AutoTuner {
   // Perform the tuning process and return the final result
   TuningResult Tune(const TuningOptions& options);
 
+  // Export the best schedules of the tasks recorded in the database, the compilation in other processes
+  // applies them to the same groups without tuning when the artifact is set by FLAGS_cinn_tuning_artifact
+  TuningArtifact ExportArtifact();
+
  private:
+  // train the shared cost model with the records of the tasks in the database,
+  // or load it from cost_model_path_ if there is no record
+  void WarmStartCostModel();
+
   const common::Target& target_;
   hlir::framework::Graph* graph_;
   std::unique_ptr<hlir::framework::OpLowerer> op_lowerer_;
@@ -70,9 +97,16 @@ class AutoTuner {
   std::unique_ptr<ScheduleBuilder> builder_;
   std::unique_ptr<ScheduleRunner> runner_;
   std::unique_ptr<ScheduleMeasurer> schedule_measurer_;
+  // The compilers and builders of the build threads other than builder_ when the measurement is pipelined
+  std::vector<std::unique_ptr<hlir::framework::GraphCompiler>> worker_graph_compilers_;
+  std::vector<std::unique_ptr<ScheduleBuilder>> worker_builders_;
 
   // The database to store tuning record
   std::unique_ptr<Database> database_;
+
+  // The cost model shared by all tasks, only created for warm start
+  std::unique_ptr<ExprCostModel> cost_model_;
+  std::string cost_model_path_;
 };
 
 }  // namespace auto_schedule
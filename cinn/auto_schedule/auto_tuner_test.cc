@@ -17,7 +17,10 @@
 #include <glog/logging.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cstdio>
 #include <cstdlib>
+#include <fstream>
 #include <iostream>
 
 #include "cinn/common/target.h"
@@ -28,11 +31,15 @@
 #include "cinn/hlir/framework/graph_compiler.h"
 #include "cinn/hlir/framework/node.h"
 #include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/framework/op_lowering.h"
 #include "cinn/ir/ir_base.h"
+#include "cinn/ir/ir_compare.h"
 #include "cinn/runtime/flags.h"
+#include "cinn/utils/data_util.h"
 
 DECLARE_bool(auto_schedule_use_cost_model);
 DECLARE_bool(cinn_ir_schedule);
+DECLARE_string(cinn_tuning_artifact);
 
 namespace cinn {
 namespace auto_schedule {
@@ -74,7 +81,7 @@ class TestAutoTunerWithoutFusion : public ::testing::Test {
     FLAGS_cinn_ir_schedule = true;
     std::unordered_set<std::string> fetch_ids;
     auto program   = CreateAddReluProgram();
-    auto graph     = cinn::frontend::Optimize(&program, fetch_ids, target);
+    graph          = cinn::frontend::Optimize(&program, fetch_ids, target);
     compiled_scope = BuildScope(target, graph);
     graph_compiler = std::make_unique<GraphCompiler>(target, compiled_scope, graph);
     tuner          = std::make_unique<AutoTuner>(target, graph.get());
@@ -161,6 +168,105 @@ TEST_F(TestAutoTunerWithoutFusion, NonZeroMeasure_EnableCostModel) {
   NonZeroMeasure();
 }
 
+TEST_F(TestAutoTunerWithoutFusion, WarmStartCostModel) {
+  FLAGS_auto_schedule_use_cost_model = true;
+  std::string record_file_path       = "/tmp/test_warm_start_record.json";
+  std::string cost_model_path        = "/tmp/test_warm_start.cost_model";
+  std::remove(record_file_path.c_str());
+  std::remove(cost_model_path.c_str());
+
+  AutoTuner::Config tuning_config;
+  tuning_config.database_config.type             = DatabaseType::kJSONFile;
+  tuning_config.database_config.record_file_path = record_file_path;
+  tuning_config.cost_model_warm_start            = true;
+  tuning_config.cost_model_path                  = cost_model_path;
+  TuningOptions tuning_options;
+  tuning_options.num_measure_trials        = 4;
+  tuning_options.num_samples_per_iteration = 2;
+  auto result = InitializeAndTune(tuning_config, tuning_options);
+  BasicCheckResult(result);
+  // the shared cost model is saved after tuning
+  ASSERT_TRUE(std::ifstream(cost_model_path).good());
+
+  // a new tuner pretrains the cost model with the records of the previous one, so the model
+  // is saved again even though nothing is measured to update it
+  std::remove(cost_model_path.c_str());
+  TuningOptions zero_measure_options;
+  zero_measure_options.num_measure_trials = 0;
+
+  tuner  = std::make_unique<AutoTuner>(target, graph.get());
+  result = InitializeAndTune(tuning_config, zero_measure_options);
+  BasicCheckResult(result);
+  ApplyTunedAndRun(result);
+  GbdtCostModel pretrained_cost_model;
+  pretrained_cost_model.Load(cost_model_path);
+  ASSERT_GT(pretrained_cost_model.num_trees(), 0);
+
+  // without records, a new tuner loads the saved cost model and the measurements boost it further,
+  // a model refitted on the new measurements only would have no more trees than the loaded one
+  std::remove(record_file_path.c_str());
+  tuner  = std::make_unique<AutoTuner>(target, graph.get());
+  result = InitializeAndTune(tuning_config, tuning_options);
+  BasicCheckResult(result);
+  GbdtCostModel boosted_cost_model;
+  boosted_cost_model.Load(cost_model_path);
+  ASSERT_GT(boosted_cost_model.num_trees(), pretrained_cost_model.num_trees());
+
+  std::remove(record_file_path.c_str());
+  std::remove(cost_model_path.c_str());
+}
+
+TEST_F(TestAutoTunerWithoutFusion, ExportArtifact) {
+  FLAGS_auto_schedule_use_cost_model = false;
+  std::string artifact_path          = "/tmp/test_tuning_artifact.pb";
+  std::remove(artifact_path.c_str());
+
+  AutoTuner::Config tuning_config;
+  TuningOptions tuning_options;
+  tuning_options.num_measure_trials        = 4;
+  tuning_options.num_samples_per_iteration = 2;
+  auto result = InitializeAndTune(tuning_config, tuning_options);
+  BasicCheckResult(result);
+  TuningArtifact artifact = tuner->ExportArtifact();
+  ASSERT_EQ(artifact.Size(), 1UL);
+  artifact.Save(artifact_path);
+
+  // the default compilation replays the tuned schedule from the artifact
+  FLAGS_cinn_tuning_artifact = artifact_path;
+  ASSERT_NE(TuningArtifact::Global(), nullptr);
+  ASSERT_EQ(TuningArtifact::Global()->Size(), 1UL);
+  const auto& dtype_dict = graph->GetAttrs<absl::flat_hash_map<std::string, common::Type>>("inferdtype");
+  const auto& shape_dict = graph->GetAttrs<absl::flat_hash_map<std::string, hlir::framework::shape_t>>("infershape");
+  hlir::framework::OpLowerer op_lowerer(dtype_dict, shape_dict, target);
+  auto tuned_group                     = result.tuned_graph[0].groups[0];
+  std::vector<ir::LoweredFunc> lowered = op_lowerer.Lower(tuned_group);
+  const ir::LoweredFunc& tuned_func    = result.optimized_exprs[0].lowered_funcs[0][0];
+  ASSERT_EQ(lowered.size(), 1UL);
+  ASSERT_EQ(ir::IrCanonicalHash(lowered[0]->body, true), ir::IrCanonicalHash(tuned_func->body, true));
+
+  GraphCompiler::CompileOptions compile_options;
+  compile_options.with_instantiate_variables = true;
+  auto runtime_program                       = graph_compiler->Build(compile_options).runtime_program;
+  ASSERT_EQ(1, runtime_program->size());
+  SetRandData<float>(compiled_scope->GetTensor("A"), target);
+  SetRandData<float>(compiled_scope->GetTensor("B"), target);
+  runtime_program->Execute();
+
+  // the tuned kernel still computes relu(A + broadcast(B))
+  const std::string& out_name = runtime_program->GetRunInstructions()[0]->GetOutArgs()[0][0];
+  std::vector<float> a        = GetTensorData<float>(compiled_scope->GetTensor("A"), target);
+  std::vector<float> b        = GetTensorData<float>(compiled_scope->GetTensor("B"), target);
+  std::vector<float> out      = GetTensorData<float>(compiled_scope->GetTensor(out_name), target);
+  ASSERT_EQ(out.size(), a.size());
+  for (size_t i = 0; i < out.size(); ++i) {
+    ASSERT_FLOAT_EQ(out[i], std::max(a[i] + b[(i / (112 * 112)) % 64], 0.f)) << "index " << i;
+  }
+
+  FLAGS_cinn_tuning_artifact = "";
+  ASSERT_EQ(TuningArtifact::Global(), nullptr);
+  std::remove(artifact_path.c_str());
+}
+
 class TestAutoTunerWithFusion : public TestAutoTunerWithoutFusion {
  public:
   void SetUp() override {
@@ -16,7 +16,9 @@
 
 #include <glog/logging.h>
 
+#include <algorithm>
 #include <atomic>
+#include <string>
 #include <vector>
 
 #include "cinn/auto_schedule/cost_model/feature.h"
@@ -24,6 +26,7 @@
 #include "cinn/auto_schedule/search_space/search_state.h"
 #include "cinn/common/target.h"
 #include "cinn/ir/ir_schedule.h"
+#include "cinn/utils/multi_threading.h"
 
 namespace cinn {
 namespace auto_schedule {
@@ -35,10 +38,35 @@ float ExprCostModel::Predict(const ir::ModuleExpr& sample, const common::Target&
   FeatureExtractor extractor;
   Feature feature                    = extractor.Extract(sample, target);
   std::vector<float> feature_numbers = feature.ToFixedSizeVector();
-  std::vector<float> pred            = XgbCostModel::Predict({feature_numbers});
+  std::vector<float> pred            = GbdtCostModel::Predict({feature_numbers});
   return pred[0];
 }
 
+std::vector<float> ExprCostModel::Predict(const std::vector<const ir::ModuleExpr*>& samples,
+                                          const common::Target& target,
+                                          int num_threads) const {
+  if (trained_times_.load() == 0) {
+    return std::vector<float>(samples.size(), SearchState::NOT_INIT_COST);
+  }
+  std::vector<float> preds(samples.size());
+  if (samples.empty()) {
+    return preds;
+  }
+  // extract the features of every sample into its row of the matrix
+  const int feature_size = num_features();
+  std::vector<float> feature_numbers(samples.size() * feature_size);
+  auto extract_fn = [&samples, &target, &feature_numbers, feature_size](int index) {
+    CHECK(samples[index] != nullptr) << "Predict samples cannot be nullptr";
+    FeatureExtractor extractor;
+    std::vector<float> sample_numbers = extractor.Extract(*samples[index], target).ToFixedSizeVector();
+    CHECK_EQ(sample_numbers.size(), feature_size) << "The size of features is different from the trained samples";
+    std::copy(sample_numbers.begin(), sample_numbers.end(), feature_numbers.begin() + index * feature_size);
+  };
+  utils::parallel_run(extract_fn, utils::SequenceDispatcher(0, samples.size()), num_threads);
+  GbdtCostModel::PredictBatch(feature_numbers.data(), samples.size(), preds.data());
+  return preds;
+}
+
 void ExprCostModel::Train(const std::vector<const ir::ModuleExpr*>& samples,
                           const std::vector<float>& labels,
                           const common::Target& target) {
@@ -53,7 +81,7 @@ void ExprCostModel::Train(const std::vector<const ir::ModuleExpr*>& samples,
     train_feature_numbers[i] = feature.ToFixedSizeVector();
   }
 
-  XgbCostModel::Train(train_feature_numbers, labels);
+  GbdtCostModel::Train(train_feature_numbers, labels);
 }
 
 void ExprCostModel::Update(const std::vector<const ir::ModuleExpr*>& samples,
@@ -70,7 +98,20 @@ void ExprCostModel::Update(const std::vector<const ir::ModuleExpr*>& samples,
     train_feature_numbers[i] = feature.ToFixedSizeVector();
   }
 
-  XgbCostModel::Update(train_feature_numbers, labels);
+  GbdtCostModel::Update(train_feature_numbers, labels);
+}
+
+void ExprCostModel::Load(const std::string& path) {
+  GbdtCostModel::Load(path);
+  // a model saved before the features changed can't predict the current features
+  if (num_features() != Feature::kFixedSize) {
+    LOG(WARNING) << "Ignore the cost model in " << path << " which is trained on " << num_features()
+                 << " features, but the current feature size is " << Feature::kFixedSize;
+    Reset();
+    trained_times_.store(0);
+    return;
+  }
+  trained_times_.store(1);
 }
 
 }  // namespace auto_schedule
@@ -15,9 +15,10 @@
 #pragma once
 
 #include <atomic>
+#include <string>
 #include <vector>
 
-#include "cinn/auto_schedule/cost_model/xgb_cost_model.h"
+#include "cinn/auto_schedule/cost_model/gbdt_cost_model.h"
 #include "cinn/ir/ir_schedule.h"
 
 namespace cinn {
@@ -27,15 +28,23 @@ namespace auto_schedule {
  * A C++ cost model which trains and predicts on ir::Expr
  *
  */
-class ExprCostModel : public XgbCostModel {
+class ExprCostModel : public GbdtCostModel {
  public:
   float Predict(const ir::ModuleExpr& sample, const common::Target& target) const;
+  // predict a batch of samples at once, which is much faster than predicting them one by one,
+  // the features are extracted with num_threads threads, and -1 means the number of hardware threads
+  std::vector<float> Predict(const std::vector<const ir::ModuleExpr*>& samples,
+                             const common::Target& target,
+                             int num_threads = 1) const;
   void Train(const std::vector<const ir::ModuleExpr*>& samples,
              const std::vector<float>& labels,
              const common::Target& target);
   void Update(const std::vector<const ir::ModuleExpr*>& samples,
               const std::vector<float>& labels,
               const common::Target& target);
+  // load a model saved by Save, which can predict before any training, the model is ignored
+  // if its feature size is different from the current Feature
+  void Load(const std::string& path) override;
 
  private:
   std::atomic<int> trained_times_{0};
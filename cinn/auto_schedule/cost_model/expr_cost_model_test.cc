@@ -0,0 +1,96 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/cost_model/expr_cost_model.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "cinn/auto_schedule/cost_model/feature.h"
+#include "cinn/auto_schedule/search_space/search_state.h"
+#include "cinn/common/context.h"
+#include "cinn/ir/ir_schedule.h"
+#include "cinn/lang/compute.h"
+#include "cinn/lang/lower.h"
+#include "cinn/lang/placeholder.h"
+#include "cinn/poly/stage.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+ir::ModuleExpr CreateAssignModule(const common::Target& target) {
+  Context::Global().ResetNameId();
+  ir::Expr M(32);
+  ir::Expr N(32);
+  lang::Placeholder<float> A("A", {M, N});
+  ir::Tensor B = lang::Compute(
+      {M, N}, [&](Var i, Var j) { return A(i, j); }, "B");
+
+  poly::StageMap stages              = poly::CreateStages({A, B});
+  std::vector<ir::LoweredFunc> funcs = lang::LowerVec("Assign", stages, {A, B}, {}, {}, nullptr, target, true);
+  return ir::ModuleExpr({funcs[0]->body});
+}
+
+// save a model trained on samples of the given feature size
+void SaveModelWithFeatureSize(int feature_size, const std::string& path) {
+  std::vector<std::vector<float>> samples;
+  std::vector<float> labels;
+  for (int i = 0; i < 16; ++i) {
+    std::vector<float> sample(feature_size, 0.0f);
+    sample[i % feature_size] = i;
+    samples.push_back(sample);
+    labels.push_back(i % 4);
+  }
+  GbdtCostModel model;
+  model.Train(samples, labels);
+  model.Save(path);
+}
+
+TEST(ExprCostModel, LoadWithFeatureSize) {
+  common::Target target = common::DefaultHostTarget();
+  ir::ModuleExpr module = CreateAssignModule(target);
+  std::string path      = "/tmp/test_expr_cost_model.cost_model";
+  // copy the static members, which aren't defined out of the classes to be bound to references
+  const int feature_size    = Feature::kFixedSize;
+  const float not_init_cost = SearchState::NOT_INIT_COST;
+
+  SaveModelWithFeatureSize(feature_size, path);
+  ExprCostModel model;
+  model.Load(path);
+  ASSERT_GT(model.num_trees(), 0);
+  ASSERT_EQ(model.num_features(), feature_size);
+  ASSERT_NE(model.Predict(module, target), not_init_cost);
+
+  // the model saved before the features changed is ignored instead of failing to predict
+  SaveModelWithFeatureSize(feature_size - LoopBlockFeature::kMemoryAccessSize, path);
+  model.Load(path);
+  ASSERT_EQ(model.num_trees(), 0);
+  ASSERT_EQ(model.Predict(module, target), not_init_cost);
+  std::vector<float> preds = model.Predict({&module}, target);
+  ASSERT_EQ(preds.size(), 1UL);
+  ASSERT_EQ(preds[0], not_init_cost);
+
+  // and it can be trained again from scratch
+  model.Train({&module, &module}, {1.0f, 2.0f}, target);
+  ASSERT_GT(model.num_trees(), 0);
+  ASSERT_NE(model.Predict(module, target), not_init_cost);
+
+  std::remove(path.c_str());
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
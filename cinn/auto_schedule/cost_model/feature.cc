@@ -29,6 +29,7 @@
 
 #include <glog/logging.h>
 
+#include <algorithm>
 #include <vector>
 
 #include "cinn/common/target.h"
@@ -49,7 +50,7 @@ Feature::Feature(const common::Target& target)
       parent_indices_(1, -1) {}
 
 std::vector<float> Feature::ToFixedSizeVector() {
-  std::vector<float> ret(LoopBlockFeature::kTotalSize + 1, 0);  // LoopBlockFeature::kTotalSize plus 1 for target
+  std::vector<float> ret(kFixedSize, 0);
 
   if (target_ == common::DefaultNVGPUTarget()) {
     ret[0] = 1;
@@ -149,6 +150,19 @@ std::vector<float> Feature::ToFixedSizeVector() {
     ++j;
     ret[j] += (loop_feature.vectorize_factor * parent_prod);
     ++j;
+
+    // the data is moved every time the loop is entered
+    ret[j] += (loop_feature.bytes_footprint * parent_prod);
+    ++j;
+    ret[j] += (loop_feature.cache_lines * parent_prod);
+    ++j;
+    ret[j] = std::max(ret[j], loop_feature.innermost_stride);
+    ++j;
+    // the shortest reuse distance, which is the most likely to hit the cache
+    if (loop_feature.reuse_distance > 0 && (ret[j] == 0 || loop_feature.reuse_distance < ret[j])) {
+      ret[j] = loop_feature.reuse_distance;
+    }
+    ++j;
   }
 
   for (size_t i = 0; i < ret.size(); ++i) {
@@ -106,7 +106,24 @@ class LoopBlockFeature {
 
   static constexpr int kThreadFeatureSize = 8;
 
-  static constexpr int kTotalSize = kArithSize + kMemSize + kReduceBroadcastSize + kOptApplySize + kThreadFeatureSize;
+  /**
+   * Memory access features of one execution of the loop, which are estimated
+   * from the indices of Load and Store inside the loop.
+   */
+  // the bytes of the distinct data touched, which is the working set of the loop
+  float bytes_footprint = 0;
+  // the number of the distinct cache lines touched
+  float cache_lines = 0;
+  // the max stride in bytes of the accesses whose innermost loop is this one
+  float innermost_stride = 0;
+  // the bytes touched by an iteration of the loop if it accesses the same data
+  // in different iterations, which is the distance of the reuse, 0 if no reuse
+  float reuse_distance = 0;
+
+  static constexpr int kMemoryAccessSize = 4;
+
+  static constexpr int kTotalSize =
+      kArithSize + kMemSize + kReduceBroadcastSize + kOptApplySize + kThreadFeatureSize + kMemoryAccessSize;
 
   /* Non-feature attributes, used to maintain during feature_extractor */
 
@@ -126,6 +143,9 @@ class Feature {
 
   Feature(const common::Target& target);
 
+  // The size of the vector converted by ToFixedSizeVector, the features of LoopBlockFeature plus 1 for target
+  static constexpr int kFixedSize = LoopBlockFeature::kTotalSize + 1;
+
   // Convert the various-length loop block features to fixed-size vector
   std::vector<float> ToFixedSizeVector();
 
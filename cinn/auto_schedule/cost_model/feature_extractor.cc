@@ -27,6 +27,12 @@
 
 #include "cinn/auto_schedule/cost_model/feature_extractor.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "cinn/common/target.h"
@@ -49,6 +55,11 @@ void FeatureExtractor::Visit(const Expr *x) { IRVisitor::Visit(x); }
 
 Feature FeatureExtractor::Extract(const ir::ModuleExpr &mod_expr, const common::Target &target) {
   feature_ = Feature(target);
+  // the size of the L1 cache line, which is the unit of the memory transactions
+  cache_line_bytes_ = target == common::DefaultNVGPUTarget() ? 128 : 64;
+  loops_.clear();
+  accesses_.clear();
+  iter_var_bindings_.clear();
   for (const ir::Expr &e : mod_expr.GetExprs()) {
     Visit(&e);
   }
@@ -73,7 +84,6 @@ VisitDoNothing(_Module_);
 VisitDoNothing(_Var_);
 VisitDoNothing(_LoweredFunc_);
 VisitDoNothing(ScheduleBlock);
-VisitDoNothing(ScheduleBlockRealize);
 VisitDoNothing(Ramp);
 VisitDoNothing(_Buffer_);
 VisitDoNothing(_BufferRange_);
@@ -148,8 +158,221 @@ VisitCountMemberPattern(IfThenElse, select_op);
 VisitCountMemberPattern(Select, select_op);
 VisitCountMemberPattern(Alloc, mem_alloc);
 VisitCountMemberPattern(Free, mem_free);
-VisitCountMemberPattern(Load, mem_read);
-VisitCountMemberPattern(Store, mem_write);
+
+void FeatureExtractor::Visit(const Load *x) {
+  feature_.CurrentLoopBlock().mem_read += 1;
+  if (x->is_addr_tensor()) {
+    RecordMemoryAccess(x->tensor, x->indices);
+  }
+  std::vector<const Expr *> sub_exprs = x->expr_fields();
+  for (const Expr *e : sub_exprs) {
+    Visit(e);
+  }
+}
+
+void FeatureExtractor::Visit(const Store *x) {
+  feature_.CurrentLoopBlock().mem_write += 1;
+  RecordMemoryAccess(x->tensor, x->indices);
+  std::vector<const Expr *> sub_exprs = x->expr_fields();
+  for (const Expr *e : sub_exprs) {
+    Visit(e);
+  }
+}
+
+void FeatureExtractor::Visit(const ScheduleBlockRealize *x) {
+  // bind the iter_vars to their values, so the indices in the block can be evaluated with the loop vars
+  const ScheduleBlock *block = x->schedule_block.As<ScheduleBlock>();
+  std::unordered_map<std::string, Expr> shadowed;
+  if (block && block->iter_vars.size() == x->iter_values.size()) {
+    for (size_t i = 0; i < block->iter_vars.size(); ++i) {
+      const std::string &name = block->iter_vars[i]->name;
+      auto it                 = iter_var_bindings_.find(name);
+      if (it != iter_var_bindings_.end()) {
+        shadowed.emplace(name, it->second);
+      }
+      iter_var_bindings_[name] = x->iter_values[i];
+    }
+  }
+
+  std::vector<const Expr *> sub_exprs = x->expr_fields();
+  for (const Expr *e : sub_exprs) {
+    Visit(e);
+  }
+
+  if (block && block->iter_vars.size() == x->iter_values.size()) {
+    for (const Var &iter_var : block->iter_vars) {
+      iter_var_bindings_.erase(iter_var->name);
+    }
+    for (auto &kv : shadowed) {
+      iter_var_bindings_[kv.first] = kv.second;
+    }
+  }
+}
+
+/* Memory access features */
+
+void FeatureExtractor::RecordMemoryAccess(const Expr &tensor, const std::vector<Expr> &indices) {
+  const _Tensor_ *tensor_n = tensor.As<_Tensor_>();
+  if (loops_.empty() || tensor_n == nullptr || indices.empty()) {
+    return;
+  }
+  MemoryAccess access;
+  access.buffer      = tensor_n->name;
+  access.elem_bytes  = std::max(tensor_n->type().bytes(), 1);
+  access.buffer_size = 1;
+  std::vector<int64_t> shape;
+  for (const Expr &dim : tensor_n->shape) {
+    if (!dim.is_constant()) {
+      return;
+    }
+    shape.push_back(static_cast<int64_t>(dim.get_constant()));
+    access.buffer_size *= shape.back();
+  }
+  // the indices of a flattened buffer is the offset
+  if (indices.size() != shape.size() && indices.size() != 1) {
+    return;
+  }
+
+  auto offset_fn = [&](const std::unordered_map<std::string, int64_t> &loop_values, int64_t *offset) {
+    *offset = 0;
+    for (size_t i = 0; i < indices.size(); ++i) {
+      int64_t index = 0;
+      if (!EvaluateIndex(indices[i], loop_values, &index)) {
+        return false;
+      }
+      *offset = indices.size() == 1 ? index : *offset * shape[i] + index;
+    }
+    return true;
+  };
+
+  // the stride along a loop is the difference of the offsets between its first two iterations
+  std::unordered_map<std::string, int64_t> loop_values;
+  for (const LoopInfo &loop : loops_) {
+    loop_values[loop.var] = loop.min;
+  }
+  int64_t base_offset = 0;
+  if (!offset_fn(loop_values, &base_offset)) {
+    return;
+  }
+  for (const LoopInfo &loop : loops_) {
+    int64_t offset       = 0;
+    loop_values[loop.var] = loop.min + 1;
+    if (!offset_fn(loop_values, &offset)) {
+      return;
+    }
+    loop_values[loop.var] = loop.min;
+    access.loop_extents.push_back(loop.extent);
+    access.strides.push_back(offset - base_offset);
+  }
+  accesses_.emplace_back(std::move(access));
+}
+
+bool FeatureExtractor::EvaluateIndex(const Expr &expr,
+                                     const std::unordered_map<std::string, int64_t> &loop_values,
+                                     int64_t *value) {
+  if (!expr.defined()) {
+    return false;
+  }
+  if (expr.is_constant()) {
+    *value = static_cast<int64_t>(expr.get_constant());
+    return true;
+  }
+  if (const _Var_ *var = expr.As<_Var_>()) {
+    auto bit = iter_var_bindings_.find(var->name);
+    if (bit != iter_var_bindings_.end() && !evaluating_vars_.count(var->name)) {
+      evaluating_vars_.insert(var->name);
+      bool success = EvaluateIndex(bit->second, loop_values, value);
+      evaluating_vars_.erase(var->name);
+      return success;
+    }
+    auto lit = loop_values.find(var->name);
+    if (lit != loop_values.end()) {
+      *value = lit->second;
+      return true;
+    }
+    return false;
+  }
+  if (const Cast *cast = expr.As<Cast>()) {
+    return EvaluateIndex(cast->v(), loop_values, value);
+  }
+  if (const Ramp *ramp = expr.As<Ramp>()) {
+    return EvaluateIndex(ramp->base, loop_values, value);
+  }
+  if (const Broadcast *broadcast = expr.As<Broadcast>()) {
+    return EvaluateIndex(broadcast->value, loop_values, value);
+  }
+
+  int64_t a = 0, b = 0;
+#define EVALUATE_BINARY(NodeType, result)                                                               \
+  if (const NodeType *op = expr.As<NodeType>()) {                                                       \
+    if (!EvaluateIndex(op->a(), loop_values, &a) || !EvaluateIndex(op->b(), loop_values, &b)) {         \
+      return false;                                                                                      \
+    }                                                                                                    \
+    *value = (result);                                                                                   \
+    return true;                                                                                         \
+  }
+  EVALUATE_BINARY(Add, a + b)
+  EVALUATE_BINARY(Sub, a - b)
+  EVALUATE_BINARY(Mul, a * b)
+  EVALUATE_BINARY(Div, b == 0 ? 0 : a / b)
+  EVALUATE_BINARY(Mod, b == 0 ? 0 : a % b)
+  EVALUATE_BINARY(Min, std::min(a, b))
+  EVALUATE_BINARY(Max, std::max(a, b))
+#undef EVALUATE_BINARY
+  return false;
+}
+
+void FeatureExtractor::MeasureFootprint(int depth, size_t first_access, float *bytes, float *cache_lines) {
+  // the accesses to the same buffer overlap mostly, so take the largest one of every buffer
+  std::unordered_map<std::string, std::pair<double, double>> buffer_footprints;
+  for (size_t i = first_access; i < accesses_.size(); ++i) {
+    const MemoryAccess &access = accesses_[i];
+    double elements            = 1;
+    int64_t inner_stride       = 0;
+    for (size_t k = depth; k < access.strides.size(); ++k) {
+      if (access.strides[k] != 0) {
+        elements *= access.loop_extents[k];
+        inner_stride = std::abs(access.strides[k]);
+      }
+    }
+    elements            = std::min<double>(elements, access.buffer_size);
+    double stride_bytes = static_cast<double>(inner_stride) * access.elem_bytes;
+    // the adjacent elements share a cache line if the innermost stride is less than the cache line
+    double lines = stride_bytes == 0 || stride_bytes >= cache_line_bytes_
+                       ? elements
+                       : std::ceil(elements * stride_bytes / cache_line_bytes_);
+
+    auto &footprint  = buffer_footprints[access.buffer];
+    footprint.first  = std::max(footprint.first, elements * access.elem_bytes);
+    footprint.second = std::max(footprint.second, lines);
+  }
+  *bytes       = 0;
+  *cache_lines = 0;
+  for (const auto &kv : buffer_footprints) {
+    *bytes += kv.second.first;
+    *cache_lines += kv.second.second;
+  }
+}
+
+void FeatureExtractor::ComputeMemoryFeature(int depth, size_t first_access, LoopBlockFeature *loop_feature) {
+  MeasureFootprint(depth, first_access, &loop_feature->bytes_footprint, &loop_feature->cache_lines);
+
+  bool carries_reuse = false;
+  for (size_t i = first_access; i < accesses_.size(); ++i) {
+    const MemoryAccess &access = accesses_[i];
+    if (access.strides[depth] == 0 && access.loop_extents[depth] > 1) {
+      carries_reuse = true;
+    }
+    if (access.strides.size() == static_cast<size_t>(depth) + 1) {
+      loop_feature->innermost_stride =
+          std::max<float>(loop_feature->innermost_stride, std::abs(access.strides[depth]) * access.elem_bytes);
+    }
+  }
+  if (carries_reuse) {
+    float cache_lines = 0;
+    MeasureFootprint(depth + 1, first_access, &loop_feature->reuse_distance, &cache_lines);
+  }
+}
 
 /* Visit for loops */
 
@@ -194,11 +417,17 @@ void FeatureExtractor::Visit(const For *x) {
     }
   }
 
+  int64_t loop_min = x->min.is_constant() ? static_cast<int64_t>(x->min.get_constant()) : 0;
+  loops_.push_back(LoopInfo{x->loop_var->name, loop_min, std::max(loop_feature.loop_length, 1)});
+  size_t first_access = accesses_.size();
+
   std::vector<const Expr *> sub_exprs = x->expr_fields();
   for (const Expr *e : sub_exprs) {
     Visit(e);
   }
 
+  ComputeMemoryFeature(loops_.size() - 1, first_access, &feature_.CurrentLoopBlock());
+  loops_.pop_back();
   feature_.ExitLoopBlock();
 }
 
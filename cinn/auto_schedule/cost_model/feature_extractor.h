@@ -27,6 +27,12 @@
 
 #pragma once
 
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
 #include "cinn/auto_schedule/cost_model/feature.h"
 #include "cinn/common/target.h"
 #include "cinn/ir/ir.h"
@@ -53,7 +59,47 @@ class FeatureExtractor : public ir::IRVisitor {
 #undef __
 
  private:
+  // a Load or Store inside loops
+  struct MemoryAccess {
+    std::string buffer;
+    int elem_bytes;
+    // the number of elements of the buffer, -1 if unknown
+    int64_t buffer_size;
+    // the extents of the enclosing loops and the strides in elements of the accessed offset along them,
+    // from the outermost to the innermost
+    std::vector<int64_t> loop_extents;
+    std::vector<int64_t> strides;
+  };
+
+  struct LoopInfo {
+    std::string var;
+    int64_t min;
+    int64_t extent;
+  };
+
+  // record the access of the tensor at indices in the current loops
+  void RecordMemoryAccess(const Expr& tensor, const std::vector<Expr>& indices);
+
+  // evaluate an integer expression with the values of the loop vars, return false if it can't be evaluated
+  bool EvaluateIndex(const Expr& expr, const std::unordered_map<std::string, int64_t>& loop_values, int64_t* value);
+
+  // compute the memory access features of the loop at depth from the accesses inside it
+  void ComputeMemoryFeature(int depth, size_t first_access, LoopBlockFeature* loop_feature);
+
+  // sum the bytes and the cache lines of the distinct data touched by the accesses from first_access,
+  // when running the loops from the depth to the innermost
+  void MeasureFootprint(int depth, size_t first_access, float* bytes, float* cache_lines);
+
   Feature feature_;
+
+  int cache_line_bytes_ = 64;
+  // the loops enclosing the node being visited, from the outermost to the innermost
+  std::vector<LoopInfo> loops_;
+  std::vector<MemoryAccess> accesses_;
+  // the values bound to the iter_vars of the ScheduleBlocks being visited
+  std::unordered_map<std::string, Expr> iter_var_bindings_;
+  // the iter_vars whose bound values are being evaluated, to stop at the self-references
+  std::unordered_set<std::string> evaluating_vars_;
 };
 
 }  // namespace auto_schedule
@@ -66,7 +66,7 @@ TEST(FeatureExtractor, SimpleAssign) {
   VLOG(6) << "Feature data before slog:";
   for (size_t i = 0; i < to_check.size(); ++i) {
     VLOG(6) << i << " " << (std::pow(2, to_check[i]) - 1);
-    if (i != 0 && i != 17 && i != 18 && i != 29) {
+    if (i != 0 && i != 17 && i != 18 && i != 29 && i != 42 && i != 43 && i != 44) {
       ASSERT_EQ(to_check[i], 0);
     }
   }
@@ -82,6 +82,17 @@ TEST(FeatureExtractor, SimpleAssign) {
   ASSERT_EQ(to_check[18], slog(M.get_constant() * N.get_constant()));  // mem_write
   // non-opt loops, including root block
   ASSERT_EQ(to_check[29], slog(3));
+  // bytes_footprint, the outer loop touches A and B once, the inner one touches a row of them M times
+  ASSERT_EQ(to_check[42], slog(2 * 4 * M.get_constant() * N.get_constant() * 2));
+  // cache_lines, 4 bytes per element
+#ifdef CINN_WITH_CUDA
+  float cache_line_elements = 128 / 4;
+#else
+  float cache_line_elements = 64 / 4;
+#endif
+  ASSERT_EQ(to_check[43], slog(2 * M.get_constant() * N.get_constant() / cache_line_elements * 2));
+  // innermost_stride
+  ASSERT_EQ(to_check[44], slog(4));
 }
 
 TEST(FeatureExtractor, MatrixMultiply) {
@@ -122,7 +133,7 @@ TEST(FeatureExtractor, MatrixMultiply) {
   std::vector<float> to_check = feature.ToFixedSizeVector();
 
   ASSERT_EQ(to_check.size(), static_cast<size_t>(LoopBlockFeature::kTotalSize + 1));
-  std::unordered_set<size_t> non_zero_indice = {0, 1, 2, 17, 18, 29, 30, 37};
+  std::unordered_set<size_t> non_zero_indice = {0, 1, 2, 17, 18, 29, 30, 37, 42, 43, 44, 45};
   for (size_t i = 0; i < to_check.size(); ++i) {
     VLOG(6) << i << " " << (std::pow(2, to_check[i]) - 1);
     if (!non_zero_indice.count(i)) {
@@ -152,6 +163,8 @@ TEST(FeatureExtractor, MatrixMultiply) {
   ASSERT_EQ(to_check[30], slog(1));
   // GpuBind loop
   ASSERT_EQ(to_check[37], slog(out_loop));
+  // C is reused by the iterations of the reduce loop
+  ASSERT_GT(to_check[45], 0);
 }
 
 }  // namespace auto_schedule
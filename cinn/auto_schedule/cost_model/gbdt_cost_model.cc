@@ -0,0 +1,341 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/cost_model/gbdt_cost_model.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace cinn {
+namespace auto_schedule {
+
+namespace {
+
+// the number of samples walking through a tree together in PredictBatch
+constexpr int kPredictBlockSize = 64;
+
+// the quantile cut points of every feature, x <= cuts[b] and x > cuts[b - 1] means x falls in the bin b
+std::vector<std::vector<float>> ComputeCuts(const std::vector<float>& samples,
+                                            int num_samples,
+                                            int num_features,
+                                            int max_bins) {
+  std::vector<std::vector<float>> cuts(num_features);
+  std::vector<float> values(num_samples);
+  for (int f = 0; f < num_features; ++f) {
+    for (int i = 0; i < num_samples; ++i) {
+      values[i] = samples[i * num_features + f];
+    }
+    std::sort(values.begin(), values.end());
+    std::vector<float> unique_values(values.begin(), std::unique(values.begin(), values.end()));
+    // the largest value needs no cut
+    if (unique_values.size() <= static_cast<size_t>(max_bins)) {
+      cuts[f].assign(unique_values.begin(), unique_values.end() - 1);
+      continue;
+    }
+    for (int b = 1; b < max_bins; ++b) {
+      float cut = values[static_cast<int64_t>(b) * num_samples / max_bins];
+      if (cut < unique_values.back() && (cuts[f].empty() || cut > cuts[f].back())) {
+        cuts[f].push_back(cut);
+      }
+    }
+  }
+  return cuts;
+}
+
+float LeafValue(double sum_grad, double sum_hess, float lambda) {
+  return static_cast<float>(-sum_grad / (sum_hess + lambda));
+}
+
+}  // namespace
+
+GbdtCostModel::GbdtCostModel() : GbdtCostModel(Config()) {}
+
+GbdtCostModel::GbdtCostModel(const Config& config) : config_(config) {
+  CHECK_GT(config_.num_rounds, 0) << "The number of rounds should be greater than 0";
+  CHECK(config_.max_depth > 0 && config_.max_depth <= 16) << "The max depth should be in [1, 16]";
+  CHECK(config_.max_bins > 1 && config_.max_bins <= 256) << "The max number of bins should be in [2, 256]";
+}
+
+void GbdtCostModel::Train(const std::vector<std::vector<float>>& samples, const std::vector<float>& labels) {
+  update_samples_ = samples;
+  update_labels_  = labels;
+  num_base_trees_ = 0;
+  Update({}, {});
+}
+
+void GbdtCostModel::Update(const std::vector<std::vector<float>>& samples, const std::vector<float>& labels) {
+  update_samples_.insert(update_samples_.end(), samples.begin(), samples.end());
+  update_labels_.insert(update_labels_.end(), labels.begin(), labels.end());
+  CHECK_EQ(update_samples_.size(), update_labels_.size()) << "Samples must have same size as labels";
+  if (update_samples_.empty()) {
+    return;
+  }
+
+  if (num_base_trees_ > 0) {
+    CHECK_EQ(update_samples_[0].size(), num_features_) << "The size of features is different from the loaded model";
+  }
+  num_features_ = update_samples_[0].size();
+  std::vector<float> flat_samples;
+  flat_samples.reserve(update_samples_.size() * num_features_);
+  for (auto& sample : update_samples_) {
+    CHECK_EQ(sample.size(), num_features_) << "Samples must have same size of features";
+    flat_samples.insert(flat_samples.end(), sample.begin(), sample.end());
+  }
+  Fit(flat_samples, update_labels_);
+}
+
+void GbdtCostModel::Reset() {
+  num_features_   = 0;
+  base_score_     = 0.0f;
+  num_base_trees_ = 0;
+  trees_.clear();
+  update_samples_.clear();
+  update_labels_.clear();
+}
+
+void GbdtCostModel::Fit(const std::vector<float>& samples, const std::vector<float>& labels) {
+  const int num_samples  = labels.size();
+  const int num_features = num_features_;
+  const int depth        = config_.max_depth;
+  const int num_internal = (1 << depth) - 1;
+  const float lambda     = config_.lambda;
+  const float min_hess   = config_.min_child_weight;
+  std::vector<std::vector<float>> cuts = ComputeCuts(samples, num_samples, num_features, config_.max_bins);
+
+  // bin the samples in advance, the histograms are built on the bins
+  std::vector<uint8_t> bins(samples.size());
+  for (int i = 0; i < num_samples; ++i) {
+    for (int f = 0; f < num_features; ++f) {
+      float x                    = samples[i * num_features + f];
+      bins[i * num_features + f] = std::lower_bound(cuts[f].begin(), cuts[f].end(), x) - cuts[f].begin();
+    }
+  }
+
+  std::vector<float> preds(num_samples);
+  if (num_base_trees_ > 0) {
+    // boost on top of the loaded trees, which start from their own base score
+    trees_.resize(num_base_trees_);
+    PredictBatch(samples.data(), num_samples, preds.data());
+  } else {
+    base_score_ = std::accumulate(labels.begin(), labels.end(), 0.0) / num_samples;
+    trees_.clear();
+    std::fill(preds.begin(), preds.end(), base_score_);
+  }
+  std::vector<float> grads(num_samples);
+  // the histograms of gradients and hessians, indexed by feature * max_bins + bin
+  std::vector<double> hist_grad(num_features * config_.max_bins);
+  std::vector<double> hist_hess(num_features * config_.max_bins);
+
+  for (int round = 0; round < config_.num_rounds; ++round) {
+    // the gradients of the squared error, the hessians are all 1
+    for (int i = 0; i < num_samples; ++i) {
+      grads[i] = preds[i] - labels[i];
+    }
+
+    Tree tree;
+    tree.split_feature.assign(num_internal, 0);
+    tree.split_threshold.assign(num_internal, std::numeric_limits<float>::infinity());
+    tree.leaf_value.assign(num_internal + 1, 0.0f);
+
+    // the samples of the nodes in the current level
+    std::vector<std::vector<int>> level_samples(1);
+    level_samples[0].resize(num_samples);
+    std::iota(level_samples[0].begin(), level_samples[0].end(), 0);
+    for (int level = 0; level < depth; ++level) {
+      std::vector<std::vector<int>> next_level_samples(level_samples.size() * 2);
+      for (int k = 0; k < level_samples.size(); ++k) {
+        int node        = (1 << level) - 1 + k;
+        auto& node_data = level_samples[k];
+        if (node_data.size() < 2 * min_hess) {
+          next_level_samples[2 * k] = std::move(node_data);
+          continue;
+        }
+
+        std::fill(hist_grad.begin(), hist_grad.end(), 0.0);
+        std::fill(hist_hess.begin(), hist_hess.end(), 0.0);
+        double sum_grad = 0.0;
+        for (int i : node_data) {
+          sum_grad += grads[i];
+          const uint8_t* sample_bins = &bins[i * num_features];
+          for (int f = 0; f < num_features; ++f) {
+            hist_grad[f * config_.max_bins + sample_bins[f]] += grads[i];
+            hist_hess[f * config_.max_bins + sample_bins[f]] += 1.0;
+          }
+        }
+        double sum_hess  = node_data.size();
+        double base_gain = sum_grad * sum_grad / (sum_hess + lambda);
+
+        // find the split with the largest gain
+        double best_gain = 0.0;
+        int best_feature = -1, best_bin = -1;
+        for (int f = 0; f < num_features; ++f) {
+          double left_grad = 0.0, left_hess = 0.0;
+          for (int b = 0; b < cuts[f].size(); ++b) {
+            left_grad += hist_grad[f * config_.max_bins + b];
+            left_hess += hist_hess[f * config_.max_bins + b];
+            double right_grad = sum_grad - left_grad, right_hess = sum_hess - left_hess;
+            if (left_hess < min_hess || right_hess < min_hess) {
+              continue;
+            }
+            double gain = left_grad * left_grad / (left_hess + lambda) +
+                          right_grad * right_grad / (right_hess + lambda) - base_gain;
+            if (gain > best_gain) {
+              best_gain    = gain;
+              best_feature = f;
+              best_bin     = b;
+            }
+          }
+        }
+
+        if (best_feature < 0) {
+          next_level_samples[2 * k] = std::move(node_data);
+          continue;
+        }
+        tree.split_feature[node]   = best_feature;
+        tree.split_threshold[node] = cuts[best_feature][best_bin];
+        for (int i : node_data) {
+          bool right = bins[i * num_features + best_feature] > best_bin;
+          next_level_samples[2 * k + right].push_back(i);
+        }
+      }
+      level_samples = std::move(next_level_samples);
+    }
+
+    // the leaf values minimizing the regularized squared error
+    for (int k = 0; k < level_samples.size(); ++k) {
+      if (level_samples[k].empty()) {
+        continue;
+      }
+      double sum_grad = 0.0;
+      for (int i : level_samples[k]) {
+        sum_grad += grads[i];
+      }
+      float value = config_.learning_rate * LeafValue(sum_grad, level_samples[k].size(), lambda);
+      tree.leaf_value[k] = value;
+      for (int i : level_samples[k]) {
+        preds[i] += value;
+      }
+    }
+    trees_.emplace_back(std::move(tree));
+  }
+  VLOG(4) << "GbdtCostModel trained " << trees_.size() << " trees on " << num_samples << " samples";
+}
+
+void GbdtCostModel::PredictBatch(const float* samples, int num_samples, float* preds) const {
+  const int depth        = config_.max_depth;
+  const int num_internal = (1 << depth) - 1;
+  int nodes[kPredictBlockSize];
+  for (int begin = 0; begin < num_samples; begin += kPredictBlockSize) {
+    const int block_size = std::min(kPredictBlockSize, num_samples - begin);
+    const float* block   = samples + static_cast<int64_t>(begin) * num_features_;
+    float* block_preds   = preds + begin;
+    std::fill(block_preds, block_preds + block_size, base_score_);
+
+    for (const auto& tree : trees_) {
+      const int* split_feature     = tree.split_feature.data();
+      const float* split_threshold = tree.split_threshold.data();
+      std::fill(nodes, nodes + block_size, 0);
+      // every sample walks exactly depth steps, the loops over samples have no branches
+      for (int level = 0; level < depth; ++level) {
+        for (int s = 0; s < block_size; ++s) {
+          int node = nodes[s];
+          float x  = block[s * num_features_ + split_feature[node]];
+          nodes[s] = 2 * node + 1 + (x > split_threshold[node]);
+        }
+      }
+      const float* leaf_value = tree.leaf_value.data() - num_internal;
+      for (int s = 0; s < block_size; ++s) {
+        block_preds[s] += leaf_value[nodes[s]];
+      }
+    }
+  }
+}
+
+std::vector<float> GbdtCostModel::Predict(const std::vector<std::vector<float>>& samples) const {
+  std::vector<float> flat_samples;
+  flat_samples.reserve(samples.size() * num_features_);
+  for (auto& sample : samples) {
+    CHECK_EQ(sample.size(), num_features_) << "The size of features is different from the trained samples";
+    flat_samples.insert(flat_samples.end(), sample.begin(), sample.end());
+  }
+  std::vector<float> preds(samples.size());
+  PredictBatch(flat_samples.data(), samples.size(), preds.data());
+  return preds;
+}
+
+void GbdtCostModel::Save(const std::string& path) {
+  std::ofstream ofs(path);
+  CHECK(ofs.is_open()) << "Failed to open file to save the cost model: " << path;
+  // float values are written with max_digits10 digits, so they are read back exactly
+  ofs << std::setprecision(std::numeric_limits<float>::max_digits10);
+  ofs << "gbdt_cost_model " << config_.max_depth << " " << num_features_ << " " << base_score_ << " " << trees_.size()
+      << "\n";
+  for (const auto& tree : trees_) {
+    for (int feature : tree.split_feature) ofs << feature << " ";
+    ofs << "\n";
+    for (float threshold : tree.split_threshold) ofs << threshold << " ";
+    ofs << "\n";
+    for (float value : tree.leaf_value) ofs << value << " ";
+    ofs << "\n";
+  }
+  CHECK(ofs.good()) << "Failed to save the cost model to " << path;
+}
+
+void GbdtCostModel::Load(const std::string& path) {
+  std::ifstream ifs(path);
+  CHECK(ifs.is_open()) << "Failed to open file to load the cost model: " << path;
+  // read the floats as strings, since operator>> can't parse infinity
+  std::string token;
+  auto next_float = [&ifs, &token]() -> float {
+    CHECK(ifs >> token) << "The file of cost model is truncated";
+    return std::stof(token);
+  };
+  auto next_int = [&ifs, &token]() -> int {
+    CHECK(ifs >> token) << "The file of cost model is truncated";
+    return std::stoi(token);
+  };
+
+  CHECK(ifs >> token && token == "gbdt_cost_model") << "Not a file of GbdtCostModel: " << path;
+  config_.max_depth      = next_int();
+  num_features_          = next_int();
+  base_score_            = next_float();
+  int num_trees          = next_int();
+  const int num_internal = (1 << config_.max_depth) - 1;
+  trees_.assign(num_trees, Tree());
+  num_base_trees_ = num_trees;
+  update_samples_.clear();
+  update_labels_.clear();
+  for (auto& tree : trees_) {
+    tree.split_feature.resize(num_internal);
+    tree.split_threshold.resize(num_internal);
+    tree.leaf_value.resize(num_internal + 1);
+    for (auto& feature : tree.split_feature) {
+      feature = next_int();
+      CHECK(feature >= 0 && feature < num_features_) << "Invalid split feature in the cost model: " << feature;
+    }
+    for (auto& threshold : tree.split_threshold) threshold = next_float();
+    for (auto& value : tree.leaf_value) value = next_float();
+  }
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -0,0 +1,98 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "cinn/common/cost_model.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+/**
+ * A native C++ cost model of gradient boosted regression trees.
+ *
+ * The trees are trained on the squared error with histograms of quantile bins like xgboost's "hist" method.
+ * Every tree is stored as a complete binary tree of max_depth levels in heap layout, a node which is not split
+ * sends all the samples to its left child, so a sample always walks max_depth steps without branches, and the
+ * predictions of a batch of samples are computed tree by tree in loops the compiler can vectorize.
+ * Predict is thread-safe and doesn't need a Python interpreter.
+ */
+class GbdtCostModel : public CostModel {
+ public:
+  struct Config {
+    // the number of trees
+    int num_rounds = 50;
+    int max_depth = 6;
+    // the shrinkage of the leaf values of every tree
+    float learning_rate = 0.3f;
+    // the L2 regularization on the leaf values
+    float lambda = 1.0f;
+    // the minimum number of samples in a child after splitting
+    float min_child_weight = 1.0f;
+    // the maximum number of bins a feature is divided into, at most 256
+    int max_bins = 64;
+  };
+
+  GbdtCostModel();
+
+  explicit GbdtCostModel(const Config& config);
+
+  void Train(const std::vector<std::vector<float>>& samples, const std::vector<float>& labels) override;
+
+  std::vector<float> Predict(const std::vector<std::vector<float>>& samples) const override;
+
+  void Update(const std::vector<std::vector<float>>& samples, const std::vector<float>& labels) override;
+
+  void Save(const std::string& path) override;
+
+  void Load(const std::string& path) override;
+
+  // predict the row-major matrix of \p num_samples samples into \p preds
+  void PredictBatch(const float* samples, int num_samples, float* preds) const;
+
+  int num_trees() const { return trees_.size(); }
+
+  int num_features() const { return num_features_; }
+
+  // drop the trees and the accumulated samples, the model needs to be trained or loaded again
+  void Reset();
+
+ private:
+  struct Tree {
+    // the split of the internal node i, samples with x[split_feature[i]] > split_threshold[i] go to the right
+    std::vector<int> split_feature;
+    std::vector<float> split_threshold;
+    // the values of the leaves, the leaf i is the node i + (2^max_depth - 1)
+    std::vector<float> leaf_value;
+  };
+
+  // fit the trees to the samples in row-major order
+  void Fit(const std::vector<float>& samples, const std::vector<float>& labels);
+
+  Config config_;
+  int num_features_ = 0;
+  float base_score_ = 0.0f;
+  std::vector<Tree> trees_;
+  // the number of trees read by Load, they are kept and the updates boost more trees on top of them
+  int num_base_trees_ = 0;
+
+  std::vector<std::vector<float>> update_samples_;
+  std::vector<float> update_labels_;
+};
+
+}  // namespace auto_schedule
+}  // namespace cinn
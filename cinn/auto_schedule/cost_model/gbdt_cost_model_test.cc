@@ -0,0 +1,156 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/cost_model/gbdt_cost_model.h"
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace cinn {
+namespace auto_schedule {
+
+namespace {
+
+float TargetFunction(const std::vector<float>& sample) { return 3 * sample[0] + (sample[1] > 5 ? 10 : 0); }
+
+}  // namespace
+
+TEST(GbdtCostModel, TrainAndPredict) {
+  GbdtCostModel::Config config;
+  config.num_rounds = 100;
+  GbdtCostModel cost_model(config);
+
+  srand(0);
+  int batch_size   = 256;
+  int feature_size = 8;
+  std::vector<std::vector<float>> samples(batch_size, std::vector<float>(feature_size));
+  std::vector<float> labels(batch_size);
+  for (int i = 0; i < batch_size; ++i) {
+    for (int j = 0; j < feature_size; ++j) {
+      samples[i][j] = rand() % 10;
+    }
+    labels[i] = TargetFunction(samples[i]);
+  }
+
+  cost_model.Train(samples, labels);
+  ASSERT_EQ(cost_model.num_trees(), 100);
+  std::vector<float> pred = cost_model.Predict(samples);
+  ASSERT_EQ(pred.size(), batch_size);
+  for (int i = 0; i < batch_size; ++i) {
+    EXPECT_NEAR(pred[i], labels[i], 0.5f);
+  }
+
+  std::string path = "./test_gbdt_cost_model.cpp_save_model";
+  cost_model.Save(path);
+  GbdtCostModel load_cost_model;
+  load_cost_model.Load(path);
+  std::vector<float> load_pred = load_cost_model.Predict(samples);
+  ASSERT_EQ(pred.size(), load_pred.size());
+  for (size_t i = 0; i < pred.size(); ++i) {
+    ASSERT_FLOAT_EQ(pred[i], load_pred[i]);
+  }
+  std::remove(path.c_str());
+
+  // the batched prediction on a row-major matrix is the same as Predict
+  std::vector<float> flat_samples;
+  for (auto& sample : samples) {
+    flat_samples.insert(flat_samples.end(), sample.begin(), sample.end());
+  }
+  std::vector<float> batch_pred(batch_size);
+  cost_model.PredictBatch(flat_samples.data(), batch_size, batch_pred.data());
+  for (int i = 0; i < batch_size; ++i) {
+    ASSERT_FLOAT_EQ(pred[i], batch_pred[i]);
+  }
+}
+
+TEST(GbdtCostModel, Update) {
+  GbdtCostModel cost_model;
+  std::vector<std::vector<float>> samples = {{1, 1}, {2, 8}, {3, 2}, {4, 9}};
+  std::vector<float> labels(samples.size());
+  for (size_t i = 0; i < samples.size(); ++i) {
+    labels[i] = TargetFunction(samples[i]);
+  }
+  cost_model.Train(samples, labels);
+
+  std::vector<std::vector<float>> new_samples = {{5, 7}, {6, 0}, {7, 6}, {8, 3}};
+  std::vector<float> new_labels(new_samples.size());
+  for (size_t i = 0; i < new_samples.size(); ++i) {
+    new_labels[i] = TargetFunction(new_samples[i]);
+  }
+  cost_model.Update(new_samples, new_labels);
+
+  // the model is trained on both the old and the new samples
+  std::vector<float> pred = cost_model.Predict(samples);
+  for (size_t i = 0; i < samples.size(); ++i) {
+    EXPECT_NEAR(pred[i], labels[i], 2.0f);
+    VLOG(6) << "pred[" << i << "] = " << pred[i];
+  }
+  pred = cost_model.Predict(new_samples);
+  for (size_t i = 0; i < new_samples.size(); ++i) {
+    EXPECT_NEAR(pred[i], new_labels[i], 2.0f);
+  }
+}
+
+TEST(GbdtCostModel, UpdateLoadedModel) {
+  GbdtCostModel::Config config;
+  config.num_rounds = 100;
+  GbdtCostModel cost_model(config);
+
+  srand(0);
+  int batch_size   = 256;
+  int feature_size = 8;
+  std::vector<std::vector<float>> samples(batch_size, std::vector<float>(feature_size));
+  std::vector<float> labels(batch_size);
+  for (int i = 0; i < batch_size; ++i) {
+    for (int j = 0; j < feature_size; ++j) {
+      samples[i][j] = rand() % 10;
+    }
+    labels[i] = TargetFunction(samples[i]);
+  }
+  cost_model.Train(samples, labels);
+  std::string path = "./test_gbdt_cost_model_update.cpp_save_model";
+  cost_model.Save(path);
+
+  std::vector<std::vector<float>> new_samples(samples.begin(), samples.begin() + 2);
+  std::vector<float> new_labels(labels.begin(), labels.begin() + 2);
+  GbdtCostModel load_cost_model(config);
+  load_cost_model.Load(path);
+  load_cost_model.Update(new_samples, new_labels);
+  std::remove(path.c_str());
+  // the updates boost more trees on top of the loaded ones
+  ASSERT_EQ(load_cost_model.num_trees(), 200);
+
+  // a model trained only on the new samples can't fit the others
+  GbdtCostModel new_cost_model(config);
+  new_cost_model.Train(new_samples, new_labels);
+
+  std::vector<float> pred      = cost_model.Predict(samples);
+  std::vector<float> load_pred = load_cost_model.Predict(samples);
+  std::vector<float> new_pred  = new_cost_model.Predict(samples);
+  float load_error = 0.0f, new_error = 0.0f;
+  for (int i = 0; i < batch_size; ++i) {
+    EXPECT_NEAR(load_pred[i], pred[i], 1.0f);
+    load_error += std::abs(load_pred[i] - labels[i]);
+    new_error += std::abs(new_pred[i] - labels[i]);
+  }
+  ASSERT_LT(load_error * 10, new_error);
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
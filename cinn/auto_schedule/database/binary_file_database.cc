@@ -0,0 +1,360 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/database/binary_file_database.h"
+
+#include <fcntl.h>
+#include <glog/logging.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include "cinn/auto_schedule/auto_schedule.pb.h"
+#include "cinn/auto_schedule/task/task_registry.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+namespace {
+
+// the file begins with the magic string, which also marks the version of the format
+constexpr char kMagic[]               = "CINNTRD1";
+constexpr size_t kMagicSize           = sizeof(kMagic) - 1;
+constexpr size_t kMinRecordsToCompact = 1024;
+
+// the header of a record, followed by the task_key and the serialized proto::TuningRecord
+struct RecordHeader {
+  uint32_t key_size;
+  uint32_t payload_size;
+  double execution_cost;
+  // the FNV-1a hash of the task_key and the payload
+  uint32_t checksum;
+};
+constexpr size_t kHeaderSize = sizeof(uint32_t) * 3 + sizeof(double);
+
+// a record located in the file
+struct RecordEntry {
+  size_t offset;
+  size_t size;
+  double execution_cost;
+};
+
+uint32_t Checksum(const char* data, size_t size, uint32_t hash = 2166136261u) {
+  for (size_t i = 0; i < size; ++i) {
+    hash = (hash ^ static_cast<uint8_t>(data[i])) * 16777619u;
+  }
+  return hash;
+}
+
+std::string EncodeRecord(const std::string& task_key, double execution_cost, const std::string& payload) {
+  RecordHeader header{static_cast<uint32_t>(task_key.size()), static_cast<uint32_t>(payload.size()), execution_cost, 0};
+  header.checksum = Checksum(payload.data(), payload.size(), Checksum(task_key.data(), task_key.size()));
+  std::string buffer(kHeaderSize, '\0');
+  std::memcpy(&buffer[0], &header.key_size, sizeof(uint32_t));
+  std::memcpy(&buffer[4], &header.payload_size, sizeof(uint32_t));
+  std::memcpy(&buffer[8], &header.execution_cost, sizeof(double));
+  std::memcpy(&buffer[16], &header.checksum, sizeof(uint32_t));
+  buffer += task_key;
+  buffer += payload;
+  return buffer;
+}
+
+// a read-only mapping of the whole file, which is empty if the file doesn't exist
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      return;
+    }
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+      void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      CHECK(addr != MAP_FAILED) << "Failed to mmap file: " << path << ", " << std::strerror(errno);
+      data_ = static_cast<const char*>(addr);
+      size_ = st.st_size;
+    }
+    close(fd);
+  }
+  ~MappedFile() {
+    if (data_) {
+      munmap(const_cast<char*>(data_), size_);
+    }
+  }
+
+  const char* data() const { return data_; }
+  size_t size() const { return size_; }
+
+ private:
+  const char* data_ = nullptr;
+  size_t size_      = 0;
+};
+
+// an exclusive lock on "<path>.lock" shared by all the processes using the database file,
+// the lock file is never replaced, so it stays valid while the database file is compacted
+class FileLock {
+ public:
+  explicit FileLock(const std::string& path) {
+    std::string lock_path = path + ".lock";
+    fd_                   = open(lock_path.c_str(), O_RDWR | O_CREAT, 0644);
+    CHECK_GE(fd_, 0) << "Cannot open the lock file: " << lock_path << ", " << std::strerror(errno);
+    while (flock(fd_, LOCK_EX) != 0) {
+      CHECK_EQ(errno, EINTR) << "Failed to lock file: " << lock_path << ", " << std::strerror(errno);
+    }
+  }
+  ~FileLock() {
+    flock(fd_, LOCK_UN);
+    close(fd_);
+  }
+
+ private:
+  int fd_;
+};
+
+// walk the records of the file and call visit_fn on every valid one, return the number of records
+// and set valid_size to the size of the leading part of the file holding the valid records
+size_t ScanRecords(const MappedFile& file,
+                   const std::string& path,
+                   const std::function<void(const std::string&, const RecordEntry&)>& visit_fn,
+                   size_t* valid_size) {
+  *valid_size = file.size();
+  if (file.size() == 0) {
+    return 0;
+  }
+  CHECK(file.size() >= kMagicSize && std::memcmp(file.data(), kMagic, kMagicSize) == 0)
+      << "Not a tuning record file of BinaryFileDatabase: " << path;
+  size_t num_records = 0;
+  size_t offset      = kMagicSize;
+  while (offset + kHeaderSize <= file.size()) {
+    const char* data = file.data() + offset;
+    RecordHeader header;
+    std::memcpy(&header.key_size, data, sizeof(uint32_t));
+    std::memcpy(&header.payload_size, data + 4, sizeof(uint32_t));
+    std::memcpy(&header.execution_cost, data + 8, sizeof(double));
+    std::memcpy(&header.checksum, data + 16, sizeof(uint32_t));
+    size_t record_size = kHeaderSize + header.key_size + header.payload_size;
+    if (offset + record_size > file.size()) {
+      break;
+    }
+    const char* key     = data + kHeaderSize;
+    const char* payload = key + header.key_size;
+    if (Checksum(payload, header.payload_size, Checksum(key, header.key_size)) != header.checksum) {
+      // the sizes in a corrupted header are not reliable, so the rest of file is dropped
+      LOG(WARNING) << "Corrupted tuning record at offset " << offset << " of " << path << ", the rest is ignored";
+      break;
+    }
+    visit_fn(std::string(key, header.key_size), RecordEntry{offset, record_size, header.execution_cost});
+    offset += record_size;
+    ++num_records;
+  }
+  if (offset != file.size()) {
+    LOG(WARNING) << "Ignored " << file.size() - offset << " incomplete bytes at the end of " << path;
+  }
+  *valid_size = offset;
+  return num_records;
+}
+
+// index the best capacity records of every task, sorted by execution_cost,
+// and the records with the same cost are kept in the order they were added
+std::unordered_map<std::string, std::vector<RecordEntry>> IndexBestRecords(const MappedFile& file,
+                                                                           const std::string& path,
+                                                                           int capacity,
+                                                                           size_t* num_records,
+                                                                           size_t* valid_size) {
+  std::unordered_map<std::string, std::vector<RecordEntry>> key2entries;
+  auto visit_fn = [&key2entries, capacity](const std::string& key, const RecordEntry& entry) {
+    auto& entries = key2entries[key];
+    auto pos      = std::upper_bound(
+        entries.begin(), entries.end(), entry, [](const RecordEntry& lhs, const RecordEntry& rhs) {
+          return lhs.execution_cost < rhs.execution_cost;
+        });
+    if (pos - entries.begin() < capacity) {
+      entries.insert(pos, entry);
+      if (entries.size() > static_cast<size_t>(capacity)) {
+        entries.pop_back();
+      }
+    }
+  };
+  *num_records = ScanRecords(file, path, visit_fn, valid_size);
+  return key2entries;
+}
+
+// cut off the incomplete or corrupted bytes at the end of the file left by a crashed writer,
+// otherwise the records appended after them could never be read
+void TruncateInvalidTail(const std::string& path) {
+  FileLock lock(path);
+  MappedFile file(path);
+  size_t valid_size = 0;
+  ScanRecords(file, path, [](const std::string&, const RecordEntry&) {}, &valid_size);
+  if (valid_size < file.size() && truncate(path.c_str(), valid_size) != 0) {
+    LOG(WARNING) << "Failed to truncate the invalid tail of " << path << ", " << std::strerror(errno);
+  }
+}
+
+}  // namespace
+
+BinaryFileDatabase::BinaryFileDatabase(int capacity_per_task,
+                                       const std::string& record_file_path,
+                                       bool allow_new_file,
+                                       int compaction_ratio)
+    : Database(capacity_per_task), record_file_path_(record_file_path), compaction_ratio_(compaction_ratio) {
+  VLOG(3) << "Auto schdule will save/load tuning records on binary file:" << record_file_path;
+  struct stat st;
+  if (stat(record_file_path_.c_str(), &st) != 0 || st.st_size == 0) {
+    CHECK(allow_new_file || stat(record_file_path_.c_str(), &st) == 0) << "File doesn't exist: " << record_file_path_;
+    FileLock lock(record_file_path_);
+    // check again under the lock, another process may have created it
+    if (stat(record_file_path_.c_str(), &st) != 0 || st.st_size == 0) {
+      FILE* fp = std::fopen(record_file_path_.c_str(), "wb");
+      CHECK(fp != nullptr) << "Cannot create new file: " << record_file_path_;
+      bool success = std::fwrite(kMagic, 1, kMagicSize, fp) == kMagicSize;
+      CHECK(std::fclose(fp) == 0 && success) << "Cannot create new file: " << record_file_path_;
+    }
+  }
+
+  MappedFile file(record_file_path_);
+  size_t valid_size = 0;
+  auto key2entries  = IndexBestRecords(file, record_file_path_, capacity_per_task_, &num_file_records_, &valid_size);
+  if (valid_size < file.size()) {
+    TruncateInvalidTail(record_file_path_);
+  }
+  InitialTaskRegistry* task_registry = InitialTaskRegistry::Global();
+  for (const auto& kv : key2entries) {
+    num_kept_records_ += kv.second.size();
+    if (!task_registry->Has(kv.first)) {
+      continue;
+    }
+    // only the records kept in memory are parsed
+    for (const RecordEntry& entry : kv.second) {
+      const char* data = file.data() + entry.offset + kHeaderSize + kv.first.size();
+      proto::TuningRecord record_proto;
+      CHECK(record_proto.ParseFromArray(data, entry.size - kHeaderSize - kv.first.size()))
+          << "Failed to parse the tuning record at offset " << entry.offset << " of " << record_file_path_;
+      VLOG(4) << "Add a measured TuningRecord with task_key=" << kv.first;
+      Insert(TuningRecord(record_proto));
+    }
+  }
+  VLOG(3) << "Loaded " << Size() << " of " << num_file_records_ << " tuning records from " << record_file_path_;
+  MaybeCompactInBackground();
+}
+
+BinaryFileDatabase::~BinaryFileDatabase() {
+  if (compaction_thread_.joinable()) {
+    compaction_thread_.join();
+  }
+}
+
+bool BinaryFileDatabase::Commit(const TuningRecord& record) {
+  std::string payload;
+  CHECK(record.ToProto().SerializeToString(&payload)) << "Failed to serialize record, task key = " << record.task_key;
+  std::string buffer = EncodeRecord(record.task_key, record.execution_cost, payload);
+  {
+    // open the file under the lock every time, since a compaction may have replaced it
+    FileLock lock(record_file_path_);
+    FILE* fp = std::fopen(record_file_path_.c_str(), "ab");
+    CHECK(fp != nullptr) << "Cannot open the file to write: " << record_file_path_;
+    bool success = std::fwrite(buffer.data(), 1, buffer.size(), fp) == buffer.size();
+    success      = std::fclose(fp) == 0 && success;
+    if (!success) {
+      LOG(WARNING) << "Failed to append the tuning record to " << record_file_path_;
+      return false;
+    }
+  }
+  {
+    std::lock_guard<std::mutex> guard(mtx_);
+    ++num_file_records_;
+  }
+  MaybeCompactInBackground();
+  return true;
+}
+
+size_t BinaryFileDatabase::Compact() {
+  FileLock lock(record_file_path_);
+  MappedFile file(record_file_path_);
+  size_t num_records = 0, valid_size = 0;
+  auto key2entries   = IndexBestRecords(file, record_file_path_, capacity_per_task_, &num_records, &valid_size);
+
+  // copy the kept records in the order of the old file
+  std::vector<RecordEntry> kept_entries;
+  for (const auto& kv : key2entries) {
+    kept_entries.insert(kept_entries.end(), kv.second.begin(), kv.second.end());
+  }
+  std::sort(kept_entries.begin(), kept_entries.end(), [](const RecordEntry& lhs, const RecordEntry& rhs) {
+    return lhs.offset < rhs.offset;
+  });
+
+  std::string tmp_path = record_file_path_ + ".compact";
+  FILE* fp             = std::fopen(tmp_path.c_str(), "wb");
+  CHECK(fp != nullptr) << "Cannot create the file to compact: " << tmp_path;
+  bool success = std::fwrite(kMagic, 1, kMagicSize, fp) == kMagicSize;
+  for (const RecordEntry& entry : kept_entries) {
+    success = success && std::fwrite(file.data() + entry.offset, 1, entry.size, fp) == entry.size;
+  }
+  success = std::fflush(fp) == 0 && success;
+  success = fsync(fileno(fp)) == 0 && success;
+  success = std::fclose(fp) == 0 && success;
+  if (!success || std::rename(tmp_path.c_str(), record_file_path_.c_str()) != 0) {
+    LOG(WARNING) << "Failed to compact " << record_file_path_ << ", the file is left unchanged";
+    std::remove(tmp_path.c_str());
+    // don't retry until the file grows again
+    std::lock_guard<std::mutex> guard(mtx_);
+    num_file_records_ = num_records;
+    num_kept_records_ = num_records;
+    return num_records;
+  }
+  VLOG(3) << "Compacted " << record_file_path_ << " from " << num_records << " to " << kept_entries.size()
+          << " tuning records";
+
+  std::lock_guard<std::mutex> guard(mtx_);
+  num_file_records_ = kept_entries.size();
+  num_kept_records_ = kept_entries.size();
+  return kept_entries.size();
+}
+
+void BinaryFileDatabase::MaybeCompactInBackground() {
+  if (compaction_ratio_ <= 0) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> guard(mtx_);
+    if (num_file_records_ < kMinRecordsToCompact || num_file_records_ <= compaction_ratio_ * num_kept_records_) {
+      return;
+    }
+  }
+  bool expected = false;
+  if (!compacting_.compare_exchange_strong(expected, true)) {
+    return;
+  }
+  // the previous compaction has finished, since compacting_ was false
+  if (compaction_thread_.joinable()) {
+    compaction_thread_.join();
+  }
+  compaction_thread_ = std::thread([this]() {
+    Compact();
+    compacting_.store(false);
+  });
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -0,0 +1,83 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "cinn/auto_schedule/database/database.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+/**
+ * BinaryFileDatabase is a database saving the tuning records in a binary file.
+ *
+ * Every record is stored as a header followed by the task_key and the serialized proto::TuningRecord.
+ * The header holds the sizes, the execution_cost and a checksum, so loading only walks the headers
+ * of the mmap'd file to index the best records of every task_key, and parses no more than
+ * capacity_per_task records for each task. Hence only the canonical hashes of the records parsed are
+ * restored, and Contains doesn't know the other candidates measured by earlier processes.
+ *
+ * The records are appended under an exclusive lock of the file "<record_file_path>.lock", so
+ * several processes can share the same file. When the file holds much more records than the
+ * capacity allows, it is compacted in the background: the best records of every task are copied
+ * to a new file which then replaces the old one atomically.
+ */
+class BinaryFileDatabase : public Database {
+ public:
+  /*!
+   * \brief Build a BinaryFileDatabase object from a binary file.
+   * \param capacity_per_task The max number of candidates stored.
+   * \param record_file_path The path of the binary file.
+   * \param allow_new_file Whether to create new file when the given path is not found.
+   * \param compaction_ratio Compact the file in the background when the number of records in it exceeds
+   * compaction_ratio times the number of records kept, and 0 disables the background compaction.
+   */
+  BinaryFileDatabase(int capacity_per_task,
+                     const std::string& record_file_path,
+                     bool allow_new_file,
+                     int compaction_ratio = 4);
+  ~BinaryFileDatabase();
+
+  // rewrite the file with only the best capacity_per_task records of every task,
+  // return the number of records in the new file
+  size_t Compact();
+
+ protected:
+  // append the newly added record to the binary file
+  bool Commit(const TuningRecord& record) override;
+
+ private:
+  // start a background compaction if the file has too many records and no compaction is running
+  void MaybeCompactInBackground();
+
+  // the name of the binary file to save tuning records.
+  std::string record_file_path_;
+  const int compaction_ratio_;
+
+  std::mutex mtx_;
+  // the number of records in the file and the number of the ones worth keeping,
+  // both are estimated in this process and corrected by every compaction
+  size_t num_file_records_ = 0;
+  size_t num_kept_records_ = 0;
+  std::atomic<bool> compacting_{false};
+  std::thread compaction_thread_;
+};
+
+}  // namespace auto_schedule
+}  // namespace cinn
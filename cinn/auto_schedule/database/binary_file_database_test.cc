@@ -0,0 +1,136 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/database/binary_file_database.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "cinn/auto_schedule/task/task_registry.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+namespace {
+
+TuningRecord MakeRecord(const std::string& task_key, double execution_cost, float predicted_cost = 1.0f) {
+  InitialTaskRegistry::Global()->Regist(task_key, ir::ModuleExpr(std::vector<Expr>()));
+  proto::TuningRecord record_proto;
+  record_proto.set_task_key(task_key);
+  record_proto.set_execution_cost(execution_cost);
+  record_proto.set_predicted_cost(predicted_cost);
+  return TuningRecord(record_proto);
+}
+
+}  // namespace
+
+class TestBinaryFileDatabase : public ::testing::Test {
+ public:
+  void SetUp() override { RemoveFiles(); }
+  void TearDown() override { RemoveFiles(); }
+
+  void RemoveFiles() {
+    std::remove(record_file_path.c_str());
+    std::remove((record_file_path + ".lock").c_str());
+  }
+
+  std::string record_file_path = "/tmp/test_record.bin";
+};
+
+TEST_F(TestBinaryFileDatabase, SaveLoad) {
+  {
+    BinaryFileDatabase test_db(2, record_file_path, true);
+    test_db.AddRecord(MakeRecord("k1", 1.0, 1.5));
+    test_db.AddRecord(MakeRecord("k2", 2.0));
+    test_db.AddRecord(MakeRecord("k2", 3.0));
+    test_db.AddRecord(MakeRecord("k3", 5.0));
+    test_db.AddRecord(MakeRecord("k3", 4.0));
+    test_db.AddRecord(MakeRecord("k3", 3.0));
+    ASSERT_EQ(test_db.Size(), 5);
+  }
+
+  BinaryFileDatabase new_db(2, record_file_path, false);
+  ASSERT_EQ(new_db.Size(), 5);
+  auto records = new_db.LookUp("k1");
+  ASSERT_EQ(records.size(), 1);
+  EXPECT_EQ(records[0].task_key, "k1");
+  EXPECT_EQ(records[0].execution_cost, 1.0);
+  EXPECT_FLOAT_EQ(records[0].predicted_cost, 1.5);
+  // only the best capacity_per_task records are loaded
+  records = new_db.LookUp("k3");
+  ASSERT_EQ(records.size(), 2);
+  EXPECT_EQ(records[0].execution_cost, 3.0);
+  EXPECT_EQ(records[1].execution_cost, 4.0);
+}
+
+TEST_F(TestBinaryFileDatabase, Compact) {
+  {
+    BinaryFileDatabase test_db(3, record_file_path, true, 0);
+    for (int i = 0; i < 20; ++i) {
+      test_db.AddRecord(MakeRecord("k1", 20 - i));
+      test_db.AddRecord(MakeRecord("k2", i));
+    }
+    EXPECT_EQ(test_db.Compact(), 6);
+  }
+
+  // the records of other tasks are kept in the file, though they are not loaded
+  BinaryFileDatabase small_db(1, record_file_path, false, 0);
+  EXPECT_EQ(small_db.Compact(), 2);
+  BinaryFileDatabase new_db(2, record_file_path, false, 0);
+  auto records = new_db.LookUp("k1");
+  ASSERT_EQ(records.size(), 1);
+  EXPECT_EQ(records[0].execution_cost, 1.0);
+  records = new_db.LookUp("k2");
+  ASSERT_EQ(records.size(), 1);
+  EXPECT_EQ(records[0].execution_cost, 0.0);
+}
+
+TEST_F(TestBinaryFileDatabase, BackgroundCompaction) {
+  {
+    BinaryFileDatabase test_db(2, record_file_path, true, 2);
+    for (int i = 0; i < 2048; ++i) {
+      test_db.AddRecord(MakeRecord("k" + std::to_string(i % 4), i));
+    }
+  }
+  // the destructor waits for the running compaction
+  BinaryFileDatabase new_db(2, record_file_path, false, 0);
+  EXPECT_EQ(new_db.Size(), 8);
+  EXPECT_LT(new_db.Compact(), 2048);
+}
+
+TEST_F(TestBinaryFileDatabase, IncompleteRecord) {
+  {
+    BinaryFileDatabase test_db(2, record_file_path, true);
+    test_db.AddRecord(MakeRecord("k1", 1.0));
+  }
+  // a record interrupted in the middle of writing is ignored
+  {
+    std::ofstream os(record_file_path, std::ofstream::app | std::ofstream::binary);
+    os << "broken";
+  }
+  BinaryFileDatabase new_db(2, record_file_path, false);
+  EXPECT_EQ(new_db.Size(), 1);
+  new_db.AddRecord(MakeRecord("k1", 0.5));
+
+  // the broken bytes are cut off, so the records appended later can be loaded
+  BinaryFileDatabase reloaded_db(2, record_file_path, false);
+  EXPECT_EQ(reloaded_db.Count("k1"), 2);
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -18,6 +18,7 @@
 #include <google/protobuf/text_format.h>
 #include <google/protobuf/util/json_util.h>
 
+#include "cinn/auto_schedule/database/binary_file_database.h"
 #include "cinn/auto_schedule/database/jsonfile_database.h"
 #include "cinn/auto_schedule/task/task_registry.h"
 #include "cinn/ir/ir_schedule.h"
@@ -36,6 +37,7 @@ proto::TuningRecord TuningRecord::ToProto() const {
   record_proto.set_execution_cost(execution_cost);
   record_proto.set_predicted_cost(predicted_cost);
   record_proto.mutable_trace()->CopyFrom(trace);
+  record_proto.set_canonical_hash(canonical_hash);
   return record_proto;
 }
 
@@ -48,6 +50,8 @@ std::unique_ptr<Database> Database::Make(const DatabaseConfig& config) {
     return std::make_unique<Database>(config.capacity_per_task);
   } else if (config.type == DatabaseType::kJSONFile) {
     return std::make_unique<JSONFileDatabase>(config.capacity_per_task, config.record_file_path, true);
+  } else if (config.type == DatabaseType::kBinaryFile) {
+    return std::make_unique<BinaryFileDatabase>(config.capacity_per_task, config.record_file_path, true);
   }
 
   LOG(FATAL) << "Unimplementd database type.";
@@ -55,6 +59,9 @@ std::unique_ptr<Database> Database::Make(const DatabaseConfig& config) {
 }
 
 void Database::Insert(const TuningRecord& record) {
+  if (record.canonical_hash != 0) {
+    key2hashes_[record.task_key].insert(record.canonical_hash);
+  }
   auto& records = key2record_[record.task_key];
   records.emplace(record);
   if (records.size() > capacity_per_task_) {
@@ -118,5 +125,13 @@ size_t Database::Count(const std::string& task_key) {
   return fit->second.size();
 }
 
+bool Database::Contains(const std::string& task_key, uint64_t canonical_hash) {
+  auto fit = key2hashes_.find(task_key);
+  if (fit == key2hashes_.end()) {
+    return false;
+  }
+  return fit->second.count(canonical_hash) > 0;
+}
+
 }  // namespace auto_schedule
 }  // namespace cinn
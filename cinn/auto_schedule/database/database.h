@@ -13,7 +13,9 @@
 // limitations under the License.
 
 #pragma once
+#include <cstdint>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "cinn/auto_schedule/auto_schedule.pb.h"
 #include "cinn/auto_schedule/search_space/search_state.h"
@@ -32,18 +34,25 @@ struct TuningRecord {
   ir::proto::ScheduleDesc trace;
   // the cost time of the candidate executed during measure
   double execution_cost;  // unit: us
+  // the canonical hash of the IR of the candidate, 0 means unknown
+  uint64_t canonical_hash = 0;
 
   TuningRecord() = default;
   TuningRecord(const proto::TuningRecord& record)
       : task_key(record.task_key()),
         predicted_cost(record.predicted_cost()),
         trace(record.trace()),
-        execution_cost(record.execution_cost()) {}
-  TuningRecord(const std::string& task_key, const SearchState& state, double execution_cost)
+        execution_cost(record.execution_cost()),
+        canonical_hash(record.canonical_hash()) {}
+  TuningRecord(const std::string& task_key,
+               const SearchState& state,
+               double execution_cost,
+               uint64_t canonical_hash = 0)
       : task_key(task_key),
         predicted_cost(state->predicted_cost),
         trace(state->ir_schedule.GetTraceDesc().ToProto()),
-        execution_cost(execution_cost) {}
+        execution_cost(execution_cost),
+        canonical_hash(canonical_hash) {}
 
   // convert to proto object
   proto::TuningRecord ToProto() const;
@@ -55,7 +64,7 @@ struct TuningRecord {
   };
 };
 
-enum class DatabaseType : int { kMemory, kJSONFile };
+enum class DatabaseType : int { kMemory, kJSONFile, kBinaryFile };
 
 struct DatabaseConfig {
   DatabaseType type            = DatabaseType::kMemory;
@@ -70,7 +79,7 @@ struct DatabaseConfig {
 class Database {
  public:
   explicit Database(int capacity_per_task);
-  ~Database() = default;
+  virtual ~Database() = default;
 
   // Create a Database with the specific config
   static std::unique_ptr<Database> Make(const DatabaseConfig& config);
@@ -85,6 +94,9 @@ class Database {
   size_t Size();
   // return the number of stored candidates with specified key
   size_t Count(const std::string& task_key);
+  // return whether a candidate with the canonical hash has been recorded for the task,
+  // including the ones added but not stored because of the capacity
+  bool Contains(const std::string& task_key, uint64_t canonical_hash);
 
  protected:
   // commit the newly added record into underlying storage
@@ -94,6 +106,8 @@ class Database {
 
   // map task_key to its records
   std::unordered_map<std::string, std::multiset<TuningRecord, TuningRecord::Compare>> key2record_;
+  // map task_key to the canonical hashes of all its records
+  std::unordered_map<std::string, std::unordered_set<uint64_t>> key2hashes_;
   // the max number of candidates stored
   const int capacity_per_task_;
 };
@@ -66,5 +66,19 @@ TEST_F(TestDatabase, GetTopK) {
   EXPECT_FLOAT_EQ(records[1].predicted_cost, 1.0);
 }
 
+TEST_F(TestDatabase, Contains) {
+  auto state = SearchState(ir::IRSchedule());
+  test_db.AddRecord(TuningRecord("k5", state, 1.0, 11));
+  test_db.AddRecord(TuningRecord("k5", state, 2.0, 12));
+  // the hash of the record dropped because of the capacity is kept
+  test_db.AddRecord(TuningRecord("k5", state, 3.0, 13));
+  ASSERT_EQ(test_db.Count("k5"), 2);
+  EXPECT_TRUE(test_db.Contains("k5", 11));
+  EXPECT_TRUE(test_db.Contains("k5", 13));
+  EXPECT_FALSE(test_db.Contains("k5", 14));
+  EXPECT_FALSE(test_db.Contains("k1", 11));
+  EXPECT_EQ(test_db.GetTopK("k5", 1)[0].ToProto().canonical_hash(), 11);
+}
+
 }  // namespace auto_schedule
 }  // namespace cinn
@@ -53,10 +53,14 @@ struct MeasureResult {
 
 // The result of building with input schedule
 struct BuildResult {
-  // The scope that owns detail compilation infos of parameters in the runtime program
+  // The scope that owns detail compilation infos of parameters in the runtime program,
+  // it should not be modified while the program is running
   const hlir::framework::Scope* compiled_scope;
   // The executable program
   std::unique_ptr<hlir::framework::Program> runtime_program;
+  // The object code of the functions in the runtime program, used to load them into another process,
+  // empty if not exported
+  std::string object;
 };
 
 // This interface defines how to generate executable objects
@@ -50,6 +50,7 @@ frontend::Program CreateAddReluProgram() {
 
 class TestMeasurer : public ::testing::Test {
  public:
+  Target target;
   std::unique_ptr<GraphCompiler> graph_compiler;
   std::vector<TuneTask> tasks;
   std::vector<MeasureInput> inputs;
@@ -57,9 +58,9 @@ class TestMeasurer : public ::testing::Test {
   void SetUp() override {
     FLAGS_cinn_ir_schedule = true;
 #ifdef CINN_WITH_CUDA
-    Target target = common::DefaultNVGPUTarget();
+    target = common::DefaultNVGPUTarget();
 #else
-    Target target = common::DefaultHostTarget();
+    target = common::DefaultHostTarget();
 #endif
     std::unordered_set<std::string> fetch_ids;
     auto program   = CreateAddReluProgram();
@@ -110,6 +111,42 @@ TEST_F(TestMeasurer, Basic) {
   ASSERT_EQ(inputs.size(), results.size());
 }
 
+TEST_F(TestMeasurer, Pipeline) {
+  // the build threads build with their own GraphCompilers and scopes concurrently
+  const auto& graph    = graph_compiler->GetGraph();
+  auto graph_compiler2 = std::make_unique<GraphCompiler>(target, BuildScope(target, graph), graph);
+  auto builder1        = std::make_unique<SimpleBuilder>(graph_compiler.get());
+  auto builder2        = std::make_unique<SimpleBuilder>(graph_compiler2.get());
+  auto runner          = std::make_unique<SimpleRunner>(1);
+  // two runner threads
+  auto measurer = std::make_unique<ScheduleMeasurer>(builder1.get(), runner.get(), 2);
+  measurer->EnablePipeline({builder1.get(), builder2.get()}, 1);
+  // measure the inputs several times to fill the pending queue
+  std::vector<MeasureInput> repeated_inputs;
+  for (int i = 0; i < 4; ++i) {
+    repeated_inputs.insert(repeated_inputs.end(), inputs.begin(), inputs.end());
+  }
+  std::vector<MeasureResult> results = measurer->Measure(repeated_inputs);
+  ASSERT_EQ(repeated_inputs.size(), results.size());
+  for (auto& result : results) {
+    EXPECT_TRUE(result.error_msg.empty()) << result.error_msg;
+  }
+}
+
+TEST_F(TestMeasurer, BuildOwnsScope) {
+  auto builder = std::make_unique<SimpleBuilder>(graph_compiler.get());
+  auto result  = builder->Build(inputs.front());
+  // the runner reads the scope of the build while the next build modifies the scope of graph_compiler
+  ASSERT_NE(result.compiled_scope, graph_compiler->GetScope().get());
+  for (auto&& instr : result.runtime_program->GetRunInstructions()) {
+    for (auto&& args : instr->GetInArgs()) {
+      for (auto&& arg : args) {
+        EXPECT_NE(result.compiled_scope->FindVar(arg), nullptr) << arg;
+      }
+    }
+  }
+}
+
 TEST_F(TestMeasurer, CatchException) {
   auto builder                       = std::make_unique<SimpleBuilder>(graph_compiler.get());
   auto runner                        = std::make_unique<SimpleRunner>(1);
@@ -0,0 +1,573 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/measure/sandbox_runner.h"
+
+#include <dirent.h>
+#include <glog/logging.h>
+#include <poll.h>
+#include <sched.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "cinn/auto_schedule/measure/simple_runner.h"
+#include "cinn/backends/llvm/execution_engine.h"
+#include "cinn/common/target.h"
+#include "cinn/common/type.h"
+#include "cinn/hlir/framework/scope.h"
+#include "cinn/hlir/framework/tensor.h"
+#include "cinn/utils/string.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+using hlir::framework::Instruction;
+using hlir::framework::Program;
+using hlir::framework::Scope;
+using hlir::framework::Shape;
+using hlir::framework::Tensor;
+
+namespace {
+
+// the message sent from a worker: execution_cost, elapsed_time, the length of error_msg and error_msg
+constexpr size_t kHeaderSize = 2 * sizeof(double) + sizeof(uint32_t);
+
+// all the connections are sockets, so a peer exiting early fails the writes instead of raising SIGPIPE
+bool WriteAll(int fd, const char* data, size_t size) {
+  while (size > 0) {
+    ssize_t n = send(fd, data, size, MSG_NOSIGNAL);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      return false;
+    }
+    data += n;
+    size -= n;
+  }
+  return true;
+}
+
+// return false if the peer is closed before receiving all the data
+bool ReadAll(int fd, char* data, size_t size) {
+  while (size > 0) {
+    ssize_t n = read(fd, data, size);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) return false;
+    data += n;
+    size -= n;
+  }
+  return true;
+}
+
+bool WriteResult(int fd, const MeasureResult& result) {
+  std::string message(kHeaderSize, '\0');
+  uint32_t msg_size = result.error_msg.size();
+  std::memcpy(&message[0], &result.execution_cost, sizeof(double));
+  std::memcpy(&message[sizeof(double)], &result.elapsed_time, sizeof(double));
+  std::memcpy(&message[2 * sizeof(double)], &msg_size, sizeof(uint32_t));
+  message += result.error_msg;
+  return WriteAll(fd, message.data(), message.size());
+}
+
+// return the total size of the message if the header has been received, otherwise 0
+size_t MessageSize(const std::string& buffer) {
+  if (buffer.size() < kHeaderSize) {
+    return 0;
+  }
+  uint32_t msg_size;
+  std::memcpy(&msg_size, &buffer[2 * sizeof(double)], sizeof(uint32_t));
+  return kHeaderSize + msg_size;
+}
+
+void ParseResult(const std::string& buffer, MeasureResult* result) {
+  std::memcpy(&result->execution_cost, &buffer[0], sizeof(double));
+  std::memcpy(&result->elapsed_time, &buffer[sizeof(double)], sizeof(double));
+  result->error_msg = buffer.substr(kHeaderSize, MessageSize(buffer) - kHeaderSize);
+}
+
+bool ReadResult(int fd, MeasureResult* result) {
+  std::string buffer(kHeaderSize, '\0');
+  if (!ReadAll(fd, &buffer[0], kHeaderSize)) {
+    return false;
+  }
+  buffer.resize(MessageSize(buffer));
+  if (!ReadAll(fd, &buffer[kHeaderSize], buffer.size() - kHeaderSize)) {
+    return false;
+  }
+  ParseResult(buffer, result);
+  return true;
+}
+
+// a request is sent with its size ahead
+bool WriteRequest(int fd, const std::string& request) {
+  uint64_t size = request.size();
+  return WriteAll(fd, reinterpret_cast<const char*>(&size), sizeof(size)) && WriteAll(fd, request.data(), size);
+}
+
+bool ReadRequest(int fd, std::string* request) {
+  uint64_t size;
+  if (!ReadAll(fd, reinterpret_cast<char*>(&size), sizeof(size))) {
+    return false;
+  }
+  request->resize(size);
+  return ReadAll(fd, &(*request)[0], size);
+}
+
+class RequestEncoder {
+ public:
+  void Write(uint64_t value) { data_.append(reinterpret_cast<const char*>(&value), sizeof(value)); }
+
+  void Write(const std::string& value) {
+    Write(static_cast<uint64_t>(value.size()));
+    data_ += value;
+  }
+
+  template <typename T>
+  void Write(const std::vector<T>& values) {
+    Write(static_cast<uint64_t>(values.size()));
+    for (const auto& value : values) {
+      Write(value);
+    }
+  }
+
+  std::string& data() { return data_; }
+
+ private:
+  std::string data_;
+};
+
+class RequestDecoder {
+ public:
+  explicit RequestDecoder(const std::string& data) : data_(data) {}
+
+  void Read(uint64_t* value) {
+    CHECK_LE(pos_ + sizeof(uint64_t), data_.size()) << "The request is truncated";
+    std::memcpy(value, &data_[pos_], sizeof(uint64_t));
+    pos_ += sizeof(uint64_t);
+  }
+
+  void Read(int* value) {
+    uint64_t raw;
+    Read(&raw);
+    *value = static_cast<int>(raw);
+  }
+
+  void Read(std::string* value) {
+    uint64_t size;
+    Read(&size);
+    CHECK_LE(pos_ + size, data_.size()) << "The request is truncated";
+    value->assign(data_, pos_, size);
+    pos_ += size;
+  }
+
+  template <typename T>
+  void Read(std::vector<T>* values) {
+    uint64_t size;
+    Read(&size);
+    values->resize(size);
+    for (auto& value : *values) {
+      Read(&value);
+    }
+  }
+
+ private:
+  const std::string& data_;
+  size_t pos_ = 0;
+};
+
+// Serialize a candidate to be loaded by a worker, which consists of
+//   the object code of the functions,
+//   the function name, functions, inputs and outputs of every instruction,
+//   the name, type and shape of every argument,
+//   the name and content of every argument given in advance, where an empty content means zeros.
+std::string EncodeRequest(const MeasureInput& input, const BuildResult& build_result) {
+  RequestEncoder encoder;
+  encoder.Write(build_result.object);
+
+  std::set<std::string> arg_names;
+  if (build_result.runtime_program) {
+    const auto& instructions = build_result.runtime_program->GetRunInstructions();
+    encoder.Write(static_cast<uint64_t>(instructions.size()));
+    for (auto&& instr : instructions) {
+      auto in_args  = instr->GetInArgs();
+      auto out_args = instr->GetOutArgs();
+      encoder.Write(instr->GetFunctionName());
+      encoder.Write(instr->GetFnNames());
+      encoder.Write(in_args);
+      encoder.Write(out_args);
+      for (auto&& args : in_args) {
+        arg_names.insert(args.begin(), args.end());
+      }
+      for (auto&& args : out_args) {
+        arg_names.insert(args.begin(), args.end());
+      }
+    }
+  } else {
+    encoder.Write(static_cast<uint64_t>(0));
+  }
+
+  encoder.Write(static_cast<uint64_t>(arg_names.size()));
+  for (const auto& name : arg_names) {
+    auto tensor = build_result.compiled_scope->GetTensor(name);
+    encoder.Write(name);
+    encoder.Write(common::Type2Str(tensor->type()));
+    std::vector<uint64_t> dims(tensor->shape().data().begin(), tensor->shape().data().end());
+    encoder.Write(dims);
+  }
+
+  // the task is only available in the tuning process, so the parameters to be initialized with zero are decided here
+  std::map<std::string, std::string> given_args;
+  if (input.task) {
+    for (const auto& name : SimpleRunner::ParamsNeedInitWithZero(*input.task)) {
+      given_args[name] = "";
+    }
+  }
+  if (input.execution_args) {
+    for (const auto& name_and_arg : *input.execution_args) {
+      cinn_buffer_t* buffer          = name_and_arg.second;
+      given_args[name_and_arg.first] = std::string(reinterpret_cast<const char*>(buffer->memory), buffer->memory_size);
+    }
+  }
+  encoder.Write(static_cast<uint64_t>(given_args.size()));
+  for (const auto& name_and_content : given_args) {
+    encoder.Write(name_and_content.first);
+    encoder.Write(name_and_content.second);
+  }
+  return std::move(encoder.data());
+}
+
+// Load the candidate serialized by EncodeRequest and run it with the runner, only called in a worker
+MeasureResult RunRequest(ScheduleRunner* runner, const std::string& request) {
+  RequestDecoder decoder(request);
+  std::string object;
+  decoder.Read(&object);
+  std::shared_ptr<backends::ExecutionEngine> engine;
+  if (!object.empty()) {
+    engine = backends::ExecutionEngine::Create(backends::ExecutionOptions());
+    engine->AddObject(object);
+  }
+
+  auto scope = std::make_shared<Scope>();
+  uint64_t num_instrs;
+  decoder.Read(&num_instrs);
+  std::vector<std::unique_ptr<Instruction>> instructions;
+  for (uint64_t i = 0; i < num_instrs; ++i) {
+    std::string function_name;
+    std::vector<std::string> fn_names;
+    std::vector<std::vector<std::string>> in_args, out_args;
+    decoder.Read(&function_name);
+    decoder.Read(&fn_names);
+    decoder.Read(&in_args);
+    decoder.Read(&out_args);
+    CHECK(!in_args.empty() && in_args.size() == out_args.size()) << "Invalid arguments of " << function_name;
+    if (!fn_names.empty() && !engine) {
+      throw std::runtime_error("the object of the candidate is not exported");
+    }
+
+    instructions.emplace_back(
+        new Instruction(common::DefaultHostTarget(), scope.get(), in_args[0], out_args[0], function_name));
+    auto& instr = instructions.back();
+    for (int j = 1; j < in_args.size(); ++j) {
+      instr->AddInArgs(in_args[j]);
+      instr->AddOutArgs(out_args[j]);
+    }
+    for (const auto& fn_name : fn_names) {
+      void* fn_ptr = engine->Lookup(fn_name);
+      if (!fn_ptr) {
+        throw std::runtime_error("can't find the function " + fn_name + " in the object");
+      }
+      instr->SetLoweredFunc(fn_ptr, fn_name);
+    }
+    instr->Finalize();
+  }
+
+  uint64_t num_args;
+  decoder.Read(&num_args);
+  for (uint64_t i = 0; i < num_args; ++i) {
+    std::string name, type;
+    std::vector<int> dims;
+    decoder.Read(&name);
+    decoder.Read(&type);
+    decoder.Read(&dims);
+    scope->Var<Tensor>(name);
+    auto tensor = scope->GetTensor(name);
+    tensor->Resize(Shape(dims));
+    tensor->set_type(common::Str2Type(type));
+  }
+
+  Scope args_scope;
+  std::map<std::string, cinn_pod_value_t> execution_args;
+  uint64_t num_given_args;
+  decoder.Read(&num_given_args);
+  for (uint64_t i = 0; i < num_given_args; ++i) {
+    std::string name, content;
+    decoder.Read(&name);
+    decoder.Read(&content);
+    if (!scope->FindVar(name)) {
+      continue;
+    }
+    auto compiled_tensor = scope->GetTensor(name);
+    args_scope.Var<Tensor>(name);
+    auto tensor = args_scope.GetTensor(name);
+    tensor->Resize(compiled_tensor->shape());
+    tensor->set_type(compiled_tensor->type());
+    auto* data  = tensor->mutable_data(common::DefaultHostTarget(), compiled_tensor->type());
+    size_t size = tensor->shape().numel() * tensor->type().bytes();
+    if (content.empty()) {
+      std::memset(data, 0, size);
+    } else {
+      std::memcpy(data, content.data(), std::min(size, content.size()));
+    }
+    execution_args.emplace(name, tensor->buffer());
+  }
+
+  BuildResult build_result;
+  build_result.compiled_scope = scope.get();
+  if (!instructions.empty()) {
+    build_result.runtime_program.reset(new Program(scope, std::move(instructions)));
+    build_result.runtime_program->KeepAlive(engine);
+  }
+  MeasureInput input;
+  input.task           = nullptr;
+  input.execution_args = execution_args.empty() ? nullptr : &execution_args;
+  return runner->Run(input, build_result);
+}
+
+// fork a fresh worker to run a candidate, it is only called in the single-threaded server, so the worker
+// can load and run the candidate freely
+MeasureResult RunInWorker(ScheduleRunner* runner, const std::string& request, int server_fd, int timeout_ms) {
+  MeasureResult result;
+  int fds[2];
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+    result.error_msg = utils::StringFormat("Run failed, error: can't create socket, %s\n", std::strerror(errno));
+    return result;
+  }
+  pid_t pid = fork();
+  if (pid == 0) {
+    // the worker process, only runs the candidate and reports the result
+    close(fds[0]);
+    close(server_fd);
+    MeasureResult worker_result;
+    try {
+      worker_result = RunRequest(runner, request);
+    } catch (std::exception& e) {
+      worker_result.error_msg = utils::StringFormat("Run failed, error: %s\n", e.what());
+    }
+    WriteResult(fds[1], worker_result);
+    _exit(0);
+  }
+  close(fds[1]);
+  if (pid < 0) {
+    close(fds[0]);
+    result.error_msg = utils::StringFormat("Run failed, error: can't fork worker, %s\n", std::strerror(errno));
+    return result;
+  }
+
+  // receive the result until the worker exits or the time is out
+  std::string buffer;
+  bool timeout  = false;
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+  while (MessageSize(buffer) == 0 || buffer.size() < MessageSize(buffer)) {
+    auto remaining =
+        std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+    if (remaining <= 0) {
+      timeout = true;
+      break;
+    }
+    pollfd pfd{fds[0], POLLIN, 0};
+    int ret = poll(&pfd, 1, static_cast<int>(remaining));
+    if (ret < 0 && errno == EINTR) continue;
+    if (ret <= 0) {
+      timeout = ret == 0;
+      break;
+    }
+    char chunk[4096];
+    ssize_t n = read(fds[0], chunk, sizeof(chunk));
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) break;
+    buffer.append(chunk, n);
+  }
+  close(fds[0]);
+
+  if (timeout) {
+    kill(pid, SIGKILL);
+  }
+  int status = 0;
+  while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+  }
+
+  if (timeout) {
+    result.error_msg = utils::StringFormat("Run failed, error: timeout after %d ms\n", timeout_ms);
+  } else if (MessageSize(buffer) > 0 && buffer.size() >= MessageSize(buffer)) {
+    ParseResult(buffer, &result);
+  } else if (WIFSIGNALED(status)) {
+    result.error_msg = utils::StringFormat("Run failed, error: worker killed by signal %d\n", WTERMSIG(status));
+  } else {
+    result.error_msg = utils::StringFormat("Run failed, error: worker exited with status %d without result\n",
+                                           WIFEXITED(status) ? WEXITSTATUS(status) : -1);
+  }
+  return result;
+}
+
+// the loop of a server, which runs the received candidates one by one until the tuning process closes the socket
+void ServeRequests(ScheduleRunner* runner, int fd, int timeout_ms) {
+  std::string request;
+  while (ReadRequest(fd, &request)) {
+    if (!WriteResult(fd, RunInWorker(runner, request, fd, timeout_ms))) {
+      break;
+    }
+  }
+}
+
+void BindCore(int core) {
+#if defined(__linux__)
+  cpu_set_t cpuset;
+  CPU_ZERO(&cpuset);
+  CPU_SET(core, &cpuset);
+  sched_setaffinity(0, sizeof(cpuset), &cpuset);
+#endif
+}
+
+// the number of threads of this process, -1 if unknown
+int CountThreads() {
+#if defined(__linux__)
+  DIR* dir = opendir("/proc/self/task");
+  if (!dir) {
+    return -1;
+  }
+  int num_threads = 0;
+  while (auto* entry = readdir(dir)) {
+    if (entry->d_name[0] != '.') {
+      ++num_threads;
+    }
+  }
+  closedir(dir);
+  return num_threads;
+#else
+  return -1;
+#endif
+}
+
+}  // namespace
+
+SandboxRunner::SandboxRunner(std::unique_ptr<ScheduleRunner> runner, const Config& config)
+    : runner_(std::move(runner)), config_(config) {
+  CHECK(runner_) << "The runner used in workers should not be null";
+  CHECK_GT(config_.timeout_ms, 0) << "The timeout should be greater than 0";
+  int num_slots = config_.cores.empty() ? config_.num_workers : config_.cores.size();
+  CHECK_GT(num_slots, 0) << "The number of workers should be greater than 0";
+  int num_threads = CountThreads();
+  LOG_IF(WARNING, num_threads > 1) << "SandboxRunner is created with " << num_threads
+                                   << " threads running, whose locks may be held forever in the forked servers, "
+                                      "it should be created before any thread starts";
+  for (int i = 0; i < num_slots; ++i) {
+    StartServer(config_.cores.empty() ? -1 : config_.cores[i]);
+  }
+  busy_slots_.resize(num_slots, false);
+}
+
+SandboxRunner::~SandboxRunner() {
+  // a server exits once its socket is closed
+  for (auto& server : servers_) {
+    close(server.fd);
+  }
+  for (auto& server : servers_) {
+    int status = 0;
+    while (waitpid(server.pid, &status, 0) < 0 && errno == EINTR) {
+    }
+  }
+}
+
+void SandboxRunner::StartServer(int core) {
+  int fds[2];
+  CHECK_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0)
+      << "Can't create the socket of the sandbox server, " << std::strerror(errno);
+  pid_t pid = fork();
+  CHECK_GE(pid, 0) << "Can't fork the sandbox server, " << std::strerror(errno);
+  if (pid == 0) {
+    close(fds[0]);
+    // the sockets of the servers forked before are closed, otherwise they never see the end-of-file
+    for (auto& server : servers_) {
+      close(server.fd);
+    }
+    if (core >= 0) {
+      BindCore(core);
+    }
+    ServeRequests(runner_.get(), fds[1], config_.timeout_ms);
+    _exit(0);
+  }
+  close(fds[1]);
+  servers_.push_back({pid, fds[0]});
+}
+
+MeasureResult SandboxRunner::Run(const MeasureInput& input, const BuildResult& build_result) {
+  if (input.task && input.task->target.arch == common::Target::Arch::NVGPU) {
+    // a forked process can't use the CUDA context of its parent
+    VLOG(4) << "SandboxRunner runs the candidate of NVGPU in the tuning process";
+    return runner_->Run(input, build_result);
+  }
+  if (build_result.runtime_program && build_result.object.empty()) {
+    LOG_FIRST_N(WARNING, 1) << "The object of the candidate is not exported, SandboxRunner runs it in the tuning "
+                               "process";
+    return runner_->Run(input, build_result);
+  }
+  std::string request = EncodeRequest(input, build_result);
+
+  int slot = -1;
+  {
+    std::unique_lock<std::mutex> lock(mtx_);
+    slot_cv_.wait(lock, [this, &slot]() {
+      for (int i = 0; i < busy_slots_.size(); ++i) {
+        if (!busy_slots_[i]) {
+          slot = i;
+          return true;
+        }
+      }
+      return false;
+    });
+    busy_slots_[slot] = true;
+  }
+  auto result = RunInSlot(request, slot);
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    busy_slots_[slot] = false;
+  }
+  slot_cv_.notify_one();
+  return result;
+}
+
+MeasureResult SandboxRunner::RunInSlot(const std::string& request, int slot) {
+  MeasureResult result;
+  // the server can't be restarted, since forking from the tuning process is unsafe after the threads start
+  if (!WriteRequest(servers_[slot].fd, request) || !ReadResult(servers_[slot].fd, &result)) {
+    result.error_msg = utils::StringFormat("Run failed, error: the sandbox server of slot %d exited\n", slot);
+  }
+  return result;
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -0,0 +1,83 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <sys/types.h>
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "cinn/auto_schedule/measure/measure.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+// This class runs every candidate in a worker process with another runner,
+// so a candidate that crashes or hangs only fails its own measurement instead of
+// killing or stalling the tuning process.
+// A process forked from the multithreaded tuning process may deadlock on the locks
+// held by the other threads, so a single-threaded server is forked for every slot on
+// construction, which should happen before any thread starts. The server receives the
+// object code and the description of the built program, and forks a fresh worker to
+// load and run it with the runner inherited on construction.
+// Run is thread-safe, the candidates measured concurrently run in different slots,
+// each pinned to its own core if cores are specified.
+class SandboxRunner : public ScheduleRunner {
+ public:
+  struct Config {
+    // the cores to pin the workers to, a core is used by one worker at a time,
+    // and empty means the workers are not pinned
+    std::vector<int> cores;
+    // the maximum number of workers running at the same time, only used when cores is empty
+    int num_workers = 1;
+    // the time limit of running a candidate in a worker, the worker is killed when exceeding it
+    int timeout_ms = 10000;
+  };
+
+  SandboxRunner(std::unique_ptr<ScheduleRunner> runner, const Config& config);
+
+  ~SandboxRunner();
+
+  MeasureResult Run(const MeasureInput& input, const BuildResult& build_result) override;
+
+ private:
+  // the process forking the workers of a slot, connected with the tuning process by a socket
+  struct Server {
+    pid_t pid;
+    int fd;
+  };
+
+  // fork the server of a slot, and pin it with its workers to the core if not -1
+  void StartServer(int core);
+
+  // send the serialized candidate to the server of the slot and wait for the result
+  MeasureResult RunInSlot(const std::string& request, int slot);
+
+  // The runner measuring the candidates inside the workers
+  std::unique_ptr<ScheduleRunner> runner_;
+  Config config_;
+
+  std::vector<Server> servers_;
+  // whether the slots of workers are occupied, a slot is bound to a core if cores are specified
+  std::vector<bool> busy_slots_;
+  std::mutex mtx_;
+  std::condition_variable slot_cv_;
+};
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -0,0 +1,225 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/measure/sandbox_runner.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <csignal>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "cinn/auto_schedule/measure/simple_runner.h"
+#include "cinn/backends/llvm/codegen_x86.h"
+#include "cinn/backends/llvm/execution_engine.h"
+#include "cinn/cinn.h"
+#include "cinn/common/test_helper.h"
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/optimize.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/runtime/cpu/host_intrinsics.h"
+#include "cinn/runtime/cpu/use_extern_funcs.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+// a runner behaving as the specified way in the worker
+class FakeRunner : public ScheduleRunner {
+ public:
+  enum class Behavior { kNormal, kCrash, kHang, kThrow };
+
+  explicit FakeRunner(Behavior behavior) : behavior_(behavior) {}
+
+  MeasureResult Run(const MeasureInput& input, const BuildResult& build_result) override {
+    MeasureResult result;
+    switch (behavior_) {
+      case Behavior::kNormal:
+        result.execution_cost = 42.0;
+        break;
+      case Behavior::kCrash:
+        std::raise(SIGSEGV);
+        break;
+      case Behavior::kHang:
+        std::this_thread::sleep_for(std::chrono::seconds(60));
+        break;
+      case Behavior::kThrow:
+        throw std::runtime_error("RunError");
+    }
+    return result;
+  }
+
+ private:
+  Behavior behavior_;
+};
+
+MeasureResult RunInSandbox(FakeRunner::Behavior behavior) {
+  SandboxRunner::Config config;
+  config.timeout_ms = 500;
+  SandboxRunner runner(std::make_unique<FakeRunner>(behavior), config);
+  MeasureInput input;
+  input.task = nullptr;
+  BuildResult build_result;
+  return runner.Run(input, build_result);
+}
+
+TEST(SandboxRunner, Basic) {
+  auto result = RunInSandbox(FakeRunner::Behavior::kNormal);
+  EXPECT_TRUE(result.error_msg.empty()) << result.error_msg;
+  EXPECT_EQ(result.execution_cost, 42.0);
+
+  result = RunInSandbox(FakeRunner::Behavior::kThrow);
+  EXPECT_EQ(result.error_msg, "Run failed, error: RunError\n");
+}
+
+TEST(SandboxRunner, CrashAndTimeout) {
+  // the failures of the candidates don't affect the tuning process
+  auto result = RunInSandbox(FakeRunner::Behavior::kCrash);
+  EXPECT_EQ(result.error_msg, "Run failed, error: worker killed by signal 11\n");
+
+  auto start = std::chrono::steady_clock::now();
+  result     = RunInSandbox(FakeRunner::Behavior::kHang);
+  EXPECT_EQ(result.error_msg, "Run failed, error: timeout after 500 ms\n");
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(10));
+}
+
+TEST(SandboxRunner, ConcurrentRuns) {
+  SandboxRunner::Config config;
+  config.num_workers = 2;
+  SandboxRunner runner(std::make_unique<FakeRunner>(FakeRunner::Behavior::kNormal), config);
+  std::vector<MeasureResult> results(8);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < results.size(); ++i) {
+    threads.emplace_back([&runner, &results, i]() {
+      MeasureInput input;
+      input.task = nullptr;
+      BuildResult build_result;
+      results[i] = runner.Run(input, build_result);
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (auto& result : results) {
+    EXPECT_TRUE(result.error_msg.empty()) << result.error_msg;
+    EXPECT_EQ(result.execution_cost, 42.0);
+  }
+}
+
+// a runner calling a JIT-compiled kernel whose parallel loop is launched by the ParallelLauncher
+class ParallelLoopRunner : public ScheduleRunner {
+ public:
+  ParallelLoopRunner() {
+    Expr M(kM), N(kN);
+    Placeholder<float> A("A", {M, N});
+    auto B = Compute(
+        {M, N}, [&](Var i, Var j) { return A(i, j) + 1.f; }, "B");
+    auto stages = CreateStages({A, B});
+    stages[B]->Parallel(0);
+
+    Module::Builder builder("parallel_loop", common::DefaultHostTarget());
+    builder.AddFunction(Lower("fn_parallel_loop", stages, {A, B}));
+    engine_ = backends::ExecutionEngine::Create({});
+    engine_->Link<backends::CodeGenX86>(builder.Build());
+    fn_ = reinterpret_cast<void (*)(void*, int32_t)>(engine_->Lookup("fn_parallel_loop"));
+    CHECK(fn_);
+  }
+
+  MeasureResult Run(const MeasureInput& input, const BuildResult& build_result) override {
+    auto* A_buf = common::BufferBuilder(Float(32), {kM, kN}).set_random().Build();
+    auto* B_buf = common::BufferBuilder(Float(32), {kM, kN}).set_zero().Build();
+    cinn_pod_value_t args[] = {cinn_pod_value_t(A_buf), cinn_pod_value_t(B_buf)};
+    fn_(args, 2);
+
+    MeasureResult result;
+    auto* A_data = reinterpret_cast<float*>(A_buf->memory);
+    auto* B_data = reinterpret_cast<float*>(B_buf->memory);
+    for (int i = 0; i < kM * kN; ++i) {
+      if (B_data[i] != A_data[i] + 1.f) {
+        result.error_msg = "wrong result";
+        break;
+      }
+    }
+    cinn_buffer_free(nullptr, A_buf);
+    cinn_buffer_free(nullptr, B_buf);
+    return result;
+  }
+
+ private:
+  static constexpr int kM = 64;
+  static constexpr int kN = 128;
+
+  std::unique_ptr<backends::ExecutionEngine> engine_;
+  void (*fn_)(void*, int32_t) = nullptr;
+};
+
+TEST(SandboxRunner, ParallelLoop) {
+  auto runner = std::make_unique<ParallelLoopRunner>();
+  MeasureInput input;
+  input.task = nullptr;
+  BuildResult build_result;
+  // the parallel launcher starts its workers in this process, which are not inherited by the forked servers
+  auto result = runner->Run(input, build_result);
+  ASSERT_TRUE(result.error_msg.empty()) << result.error_msg;
+
+  SandboxRunner::Config config;
+  config.timeout_ms = 10000;
+  SandboxRunner sandbox_runner(std::move(runner), config);
+  for (int i = 0; i < 3; ++i) {
+    result = sandbox_runner.Run(input, build_result);
+    EXPECT_TRUE(result.error_msg.empty()) << result.error_msg;
+  }
+}
+
+TEST(SandboxRunner, CandidateBuiltAfterConstruction) {
+  // the servers are forked before the candidate is built, so the worker loads it from the exported object
+  SandboxRunner::Config config;
+  config.timeout_ms = 10000;
+  SandboxRunner sandbox_runner(std::make_unique<SimpleRunner>(2), config);
+
+  Target target = common::DefaultHostTarget();
+  frontend::NetBuilder net_builder("sandbox");
+  auto a       = net_builder.CreateInput(Float(32), {32, 24}, "A");
+  auto b       = net_builder.CreateInput(Float(32), {32, 24}, "B");
+  auto c       = net_builder.Relu(net_builder.Add(a, b));
+  auto program = net_builder.Build();
+  auto graph   = frontend::Optimize(&program, {}, target);
+  auto scope   = hlir::framework::BuildScope(target, graph);
+  hlir::framework::GraphCompiler graph_compiler(target, scope, graph);
+  hlir::framework::GraphCompiler::CompileOptions options;
+  options.export_object = true;
+  auto compiled_result  = graph_compiler.Build(options);
+  ASSERT_FALSE(compiled_result.object.empty());
+
+  TuneTask task;
+  task.target = target;
+  MeasureInput input;
+  input.task = &task;
+  BuildResult build_result;
+  build_result.compiled_scope  = scope.get();
+  build_result.runtime_program = std::move(compiled_result.runtime_program);
+  build_result.object          = std::move(compiled_result.object);
+  auto result                  = sandbox_runner.Run(input, build_result);
+  EXPECT_TRUE(result.error_msg.empty()) << result.error_msg;
+
+  // the candidate without the object runs in the tuning process
+  build_result.object.clear();
+  result = sandbox_runner.Run(input, build_result);
+  EXPECT_TRUE(result.error_msg.empty()) << result.error_msg;
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -14,16 +14,57 @@
 
 #include "cinn/auto_schedule/measure/schedule_measurer.h"
 
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <exception>
+#include <mutex>
+#include <thread>
 
 #include "cinn/utils/multi_threading.h"
 
 namespace cinn {
 namespace auto_schedule {
 
+namespace {
+
+// pin the calling thread to the core so the timing is not affected by migrations
+void BindCurrentThread(int core) {
+#if defined(__linux__)
+  cpu_set_t cpuset;
+  CPU_ZERO(&cpuset);
+  CPU_SET(core, &cpuset);
+  if (pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset) != 0) {
+    LOG(WARNING) << "Failed to pin the runner thread to core " << core;
+  }
+#else
+  LOG(WARNING) << "Pinning the runner thread is only supported on Linux";
+#endif
+}
+
+}  // namespace
+
 ScheduleMeasurer::ScheduleMeasurer(ScheduleBuilder* builder, ScheduleRunner* runner, int num_threads)
     : builder_(builder), runner_(runner), num_threads_(num_threads) {}
 
+void ScheduleMeasurer::EnablePipeline(const std::vector<ScheduleBuilder*>& build_workers,
+                                      int max_pending_builds,
+                                      int runner_core) {
+  CHECK_GE(max_pending_builds, 0) << "The capacity of pending builds should be non-negative";
+  enable_pipeline_ = true;
+  build_workers_   = build_workers.empty() ? std::vector<ScheduleBuilder*>{builder_} : build_workers;
+  for (auto* worker : build_workers_) {
+    CHECK(worker) << "The build worker should not be null";
+  }
+  max_pending_builds_ = max_pending_builds > 0 ? max_pending_builds : 2 * build_workers_.size();
+  runner_core_        = runner_core;
+}
+
 std::vector<MeasureResult> ScheduleMeasurer::Measure(const std::vector<MeasureInput>& inputs) {
   if (inputs.empty()) {
     LOG(WARNING) << "inputs is empty";
@@ -33,7 +74,7 @@ std::vector<MeasureResult> ScheduleMeasurer::Measure(const std::vector<MeasureIn
   std::vector<MeasureResult> results(inputs.size());
 
   // define how to build a candidate with the specified index
-  auto build_fn = [builder = builder_, &inputs, &build_results, &results](int index) {
+  auto build_fn = [&inputs, &build_results, &results](ScheduleBuilder* builder, int index) {
     VLOG(6) << "Build candidate index: " << index;
     auto m_start = std::chrono::steady_clock::now();
     try {
@@ -61,13 +102,75 @@ std::vector<MeasureResult> ScheduleMeasurer::Measure(const std::vector<MeasureIn
     results[index].elapsed_time += static_cast<double>(time_span.count());
   };
 
-  // measure a candidate by calling build and run successively
-  auto measure_fn = [&build_fn, &run_fn](int index) {
-    build_fn(index);
-    run_fn(index);
-  };
-  // default num_threads_ is 1 and in that case it will perform all measurements sequentially inplace.
-  utils::parallel_run(measure_fn, utils::SequenceDispatcher(0, inputs.size()), num_threads_);
+  if (enable_pipeline_) {
+    // the indices of the built candidates waiting to run
+    std::deque<int> built_queue;
+    // the number of candidates taken by the runner threads
+    size_t num_taken = 0;
+    std::mutex queue_mtx;
+    std::condition_variable not_empty_cv;
+    std::condition_variable not_full_cv;
+
+    // every runner thread takes the built candidates from the queue until all of them are taken
+    auto runner_worker_fn = [&](int worker_id) {
+      if (runner_core_ >= 0) {
+        BindCurrentThread(runner_core_ + worker_id);
+      }
+      while (true) {
+        int index;
+        {
+          std::unique_lock<std::mutex> lock(queue_mtx);
+          not_empty_cv.wait(lock, [&]() { return !built_queue.empty() || num_taken == inputs.size(); });
+          if (built_queue.empty()) {
+            break;
+          }
+          index = built_queue.front();
+          built_queue.pop_front();
+          ++num_taken;
+        }
+        not_full_cv.notify_one();
+        run_fn(index);
+        // release the built program as soon as it is measured
+        build_results[index] = BuildResult();
+      }
+      // wake up the other runners to exit once all candidates are taken
+      not_empty_cv.notify_all();
+    };
+
+    // every build thread builds the next candidate with its own builder and passes it to the runners,
+    // it waits if too many candidates are pending
+    std::atomic<int> next_index(0);
+    auto build_worker_fn = [&](ScheduleBuilder* builder) {
+      for (int index = next_index++; index < inputs.size(); index = next_index++) {
+        build_fn(builder, index);
+        {
+          std::unique_lock<std::mutex> lock(queue_mtx);
+          not_full_cv.wait(lock, [&]() { return built_queue.size() < max_pending_builds_; });
+          built_queue.push_back(index);
+        }
+        not_empty_cv.notify_one();
+      }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_threads_; ++i) {
+      threads.emplace_back(runner_worker_fn, i);
+    }
+    for (auto* builder : build_workers_) {
+      threads.emplace_back(build_worker_fn, builder);
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  } else {
+    // measure a candidate by calling build and run successively
+    auto measure_fn = [this, &build_fn, &run_fn](int index) {
+      build_fn(builder_, index);
+      run_fn(index);
+    };
+    // default num_threads_ is 1 and in that case it will perform all measurements sequentially inplace.
+    utils::parallel_run(measure_fn, utils::SequenceDispatcher(0, inputs.size()), num_threads_);
+  }
 
   VLOG(4) << "Measure " << inputs.size() << " candidates";
   return results;
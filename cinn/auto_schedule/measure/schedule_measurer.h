@@ -30,6 +30,17 @@ class ScheduleMeasurer {
   // Measure a batch of inputs and return all results once.
   std::vector<MeasureResult> Measure(const std::vector<MeasureInput>& inputs);
 
+  // Measure in a pipeline, where every builder in \p build_workers builds the candidates on its own thread
+  // and num_threads runner threads run the finished ones, so the building is hidden by the running.
+  // Each builder is only used by its own thread, but the builders shouldn't share a GraphCompiler, and the
+  // runner should be thread-safe when num_threads > 1. Empty \p build_workers means building with the builder
+  // passed to the constructor on a single thread. The finished builds wait in a queue of at most
+  // \p max_pending_builds candidates, 0 means twice the number of build workers. The runner threads
+  // are pinned to the consecutive cores from \p runner_core if it is not -1.
+  void EnablePipeline(const std::vector<ScheduleBuilder*>& build_workers = {},
+                      int max_pending_builds                             = 0,
+                      int runner_core                                    = -1);
+
  private:
   // The handle to implemented ScheduleBuilder
   ScheduleBuilder* builder_;
@@ -38,6 +49,15 @@ class ScheduleMeasurer {
   // The number of threads used to perform measurement,
   // if it is greater than 1 that means parallel measurement.
   const int num_threads_;
+
+  // Whether to build and run the candidates in a pipeline
+  bool enable_pipeline_ = false;
+  // The builders of the build threads in the pipeline
+  std::vector<ScheduleBuilder*> build_workers_;
+  // The capacity of the queue holding the built candidates to run
+  int max_pending_builds_ = 0;
+  // The core the first runner thread is pinned to, -1 means not pinned
+  int runner_core_ = -1;
 };
 
 }  // namespace auto_schedule
@@ -14,6 +14,8 @@
 
 #include "cinn/auto_schedule/measure/simple_builder.h"
 
+#include <algorithm>
+
 namespace cinn {
 namespace auto_schedule {
 
@@ -27,13 +29,40 @@ BuildResult SimpleBuilder::Build(const MeasureInput& input) {
   compile_options.groups                  = input.task->task_graph;
   compile_options.lowered_funcs           = input.lowered_funcs;
   compile_options.remove_unused_variables = false;
+  // the object is exported for the runners measuring the candidates in other processes
+  compile_options.export_object = input.task->target.arch == common::Target::Arch::X86;
   VLOG(5) << "call GraphCompiler to Build with Graph::Group size=" << compile_options.groups.size()
           << ", lowered_funcs group size=" << compile_options.lowered_funcs.size();
+  std::lock_guard<std::mutex> lock(mtx_);
   GraphCompiler::CompilationResult compiled_result = graph_compiler_->Build(compile_options);
 
+  // the next build inserts variables into the scope of graph_compiler_ while this program is running,
+  // so the shapes and types of the arguments are copied into a scope owned by this build
+  auto compiled_scope = std::make_shared<hlir::framework::Scope>();
+  auto copy_var_fn    = [&](const std::string& name) {
+    if (compiled_scope->FindVar(name)) {
+      return;
+    }
+    auto src_tensor = graph_compiler_->GetScope()->GetTensor(name);
+    compiled_scope->Var<hlir::framework::Tensor>(name);
+    auto dst_tensor = compiled_scope->GetTensor(name);
+    dst_tensor->Resize(src_tensor->shape());
+    dst_tensor->set_type(src_tensor->type());
+  };
+  for (auto&& instr : compiled_result.runtime_program->GetRunInstructions()) {
+    for (auto&& args : instr->GetInArgs()) {
+      std::for_each(args.begin(), args.end(), copy_var_fn);
+    }
+    for (auto&& args : instr->GetOutArgs()) {
+      std::for_each(args.begin(), args.end(), copy_var_fn);
+    }
+  }
+
   BuildResult build_result;
-  build_result.compiled_scope  = graph_compiler_->GetScope().get();
+  build_result.compiled_scope  = compiled_scope.get();
   build_result.runtime_program = std::move(compiled_result.runtime_program);
+  build_result.object          = std::move(compiled_result.object);
+  build_result.runtime_program->KeepAlive(std::move(compiled_scope));
   return build_result;
 }
 
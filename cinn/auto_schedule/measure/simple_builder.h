@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <mutex>
+
 #include "cinn/auto_schedule/measure/measure.h"
 #include "cinn/hlir/framework/graph_compiler.h"
 
@@ -31,6 +33,8 @@ class SimpleBuilder : public ScheduleBuilder {
 
  private:
   hlir::framework::GraphCompiler* graph_compiler_;
+  // GraphCompiler is not thread-safe, so the builds are serialized
+  std::mutex mtx_;
 };
 
 }  // namespace auto_schedule
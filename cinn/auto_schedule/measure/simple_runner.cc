@@ -101,11 +101,13 @@ static void InitTensorData(Tensor tensor, const common::Target& target, bool ini
   }
 }
 
-// Find all parameter names in the task corresponding to the MeasureInput
-// that need to be initialized to 0 when measuring.
-static std::unordered_set<std::string> ParamsNeedInitWithZero(const MeasureInput& input) {
+SimpleRunner::SimpleRunner(int repeat_times) : repeat_times_(repeat_times) {
+  CHECK_GT(repeat_times_, 0) << "repeat_times can't less than 0";
+}
+
+std::unordered_set<std::string> SimpleRunner::ParamsNeedInitWithZero(const TuneTask& task) {
   std::unordered_set<std::string> res;
-  for (const auto& task_graph : input.task->task_graph) {
+  for (const auto& task_graph : task.task_graph) {
     std::vector<hlir::framework::Node*> nodes = task_graph->CollectNodes();
     for (auto* node : nodes) {
       if (kInitWithZeroParams.count(node->op()->name) != 0) {
@@ -123,10 +125,6 @@ static std::unordered_set<std::string> ParamsNeedInitWithZero(const MeasureInput
   return res;
 }
 
-SimpleRunner::SimpleRunner(int repeat_times) : repeat_times_(repeat_times) {
-  CHECK_GT(repeat_times_, 0) << "repeat_times can't less than 0";
-}
-
 // Prepare execution arguments of all instructions to run, a argument
 // may be obtained from the input of measurement or allocating new buffer
 // with random value.
@@ -135,12 +133,17 @@ std::map<std::string, cinn_pod_value_t> SimpleRunner::PrepareArgs(const MeasureI
                                                                   hlir::framework::Scope* temp_scope) {
   std::map<std::string, cinn_pod_value_t> result;
 
-  const auto& target         = input.task->target;
+  // the task is absent in a sandbox worker, which runs the candidate on the host and passes the
+  // parameters to be initialized with zero by the execution arguments
+  const auto& target         = input.task ? input.task->target : common::DefaultHostTarget();
   const auto* input_args     = input.execution_args;
   const auto* compiled_scope = build_result.compiled_scope;
   const auto& instructions   = build_result.runtime_program->GetRunInstructions();
 
-  std::unordered_set<std::string> params_need_init_with_zero = ParamsNeedInitWithZero(input);
+  std::unordered_set<std::string> params_need_init_with_zero;
+  if (input.task) {
+    params_need_init_with_zero = ParamsNeedInitWithZero(*input.task);
+  }
 
   auto fill_arg_fn = [&](const std::string& param) {
     VLOG(6) << "Filling argument:" << param;
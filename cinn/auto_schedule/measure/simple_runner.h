@@ -14,6 +14,10 @@
 
 #pragma once
 
+#include <map>
+#include <string>
+#include <unordered_set>
+
 #include "cinn/auto_schedule/measure/measure.h"
 #include "cinn/hlir/framework/instruction.h"
 
@@ -28,6 +32,9 @@ class SimpleRunner : public ScheduleRunner {
 
   MeasureResult Run(const MeasureInput& input, const BuildResult& build_result) override;
 
+  // Find all parameter names in the task that need to be initialized to 0 when measuring.
+  static std::unordered_set<std::string> ParamsNeedInitWithZero(const TuneTask& task);
+
  private:
   std::map<std::string, cinn_pod_value_t> PrepareArgs(const MeasureInput& input,
                                                       const BuildResult& build_result,
@@ -17,6 +17,7 @@
 #include <glog/logging.h>
 
 #include <cstdlib>
+#include <random>
 
 #include "cinn/common/target.h"
 #include "cinn/ir/ir_schedule.h"
@@ -33,9 +34,17 @@ int AutoGenRule::NumberApplicable() const {
 
 void AutoGenRule::ApplyRandomly() {
   CHECK_GT(num_applicable_, 0) << "Call " << GetRuleName() << "::ApplyRandomly() with NumberApplicable() == 0";
-  int index = rand() % num_applicable_;
+  int index = SampleInt(num_applicable_);
   return Apply(index);
 }
 
+int AutoGenRule::SampleInt(int bound) const {
+  CHECK_GT(bound, 0) << "The bound of SampleInt should be greater than 0";
+  if (rand_engine_ == nullptr) {
+    return std::rand() % bound;
+  }
+  return std::uniform_int_distribution<int>(0, bound - 1)(*rand_engine_);
+}
+
 }  // namespace auto_schedule
 }  // namespace cinn
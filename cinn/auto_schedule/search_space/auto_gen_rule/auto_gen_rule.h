@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <random>
 #include <string>
 
 #include "cinn/auto_schedule/search_space/search_state.h"
@@ -71,13 +72,22 @@ class AutoGenRule {
   // Apply the rule to a block determined by a specific SearchState and block name
   virtual std::vector<SearchState> ApplyOnBlock(SearchState state, const std::string& block_name) = 0;
 
+  // Draw the random choices of the rule from rand_engine instead of std::rand(), so the rules
+  // applied by different threads can be reproduced, nullptr means using std::rand() again
+  void SetRandEngine(std::mt19937* rand_engine) { rand_engine_ = rand_engine; }
+
  protected:
+  // Sample an integer in [0, bound) from rand_engine_ if set, otherwise from std::rand()
+  int SampleInt(int bound) const;
+
   // number of ScheduleBlock that can apply this auto gen rule
   int num_applicable_ = -1;
   // Target, not owned.
   const common::Target* target_;
   // IRSchedule, not owned;
   ir::IRSchedule* ir_schedule_;
+  // The random engine, not owned
+  std::mt19937* rand_engine_ = nullptr;
 };
 
 }  // namespace auto_schedule
@@ -66,9 +66,9 @@ class MultiLevelTiling : public AutoGenRule {
     if (candidates.size() == 0) {
       return {1, T(extent)};
     }
-    int index           = rand() % candidates.size();
+    int index           = SampleInt(candidates.size());
     std::vector<T> pick = candidates[index];
-    if (rand() % 2 != 0) {
+    if (SampleInt(2) != 0) {
       T tmp   = pick[0];
       pick[0] = pick[1];
       pick[1] = tmp;
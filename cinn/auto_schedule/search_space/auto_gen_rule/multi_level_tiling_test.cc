@@ -19,6 +19,7 @@
 
 #include <cstdlib>
 #include <iostream>
+#include <random>
 #include <vector>
 
 #include "cinn/auto_schedule/search_space/auto_gen_rule/auto_gen_rule.h"
@@ -79,6 +80,31 @@ TEST(MultiLevelTile, SampleTileSplit) {
   }
 }
 
+TEST(MultiLevelTile, SampleWithRandEngine) {
+  Context::Global().ResetNameId();
+#ifdef CINN_WITH_CUDA
+  Target target = common::DefaultNVGPUTarget();
+#else
+  Target target = common::DefaultHostTarget();
+#endif
+
+  // the rules sampling from the engines with the same seed make the same choices whatever std::rand() returns
+  MultiLevelTiling multi_level_tiling_1(target);
+  MultiLevelTiling multi_level_tiling_2(target);
+  std::mt19937 rand_engine_1(1);
+  std::mt19937 rand_engine_2(1);
+  multi_level_tiling_1.SetRandEngine(&rand_engine_1);
+  multi_level_tiling_2.SetRandEngine(&rand_engine_2);
+  for (int i = 0; i < 100; ++i) {
+    int number_to_split = 1 << (i % 16 + 1);
+    srand(i);
+    std::vector<int> split_1 = multi_level_tiling_1.SampleTileSplit<int>(number_to_split, 4);
+    srand(i + 100);
+    std::vector<int> split_2 = multi_level_tiling_2.SampleTileSplit<int>(number_to_split, 4);
+    EXPECT_EQ(split_1, split_2);
+  }
+}
+
 TEST(MultiLevelTile, SimpleLoops) {
   srand(0);
   Context::Global().ResetNameId();
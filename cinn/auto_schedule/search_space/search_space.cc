@@ -16,7 +16,9 @@
 
 #include <glog/logging.h>
 
+#include <algorithm>
 #include <cstdlib>
+#include <random>
 #include <utility>
 #include <vector>
 
@@ -35,6 +37,7 @@
 #include "cinn/ir/ir_schedule.h"
 #include "cinn/optim/ir_copy.h"
 #include "cinn/runtime/flags.h"
+#include "cinn/utils/multi_threading.h"
 
 DECLARE_bool(auto_schedule_use_cost_model);
 
@@ -42,15 +45,21 @@ namespace cinn {
 namespace auto_schedule {
 
 SearchSpace::SearchSpace(const TuneTask& tune_task) : tune_task_(tune_task) {
-  const auto& target = tune_task_.target;
   // initialize a set of rules and they are commonly used by all states
+  sketch_rules_ = CreateSketchRules();
+}
+
+std::vector<std::unique_ptr<AutoGenRule>> SearchSpace::CreateSketchRules() const {
+  const auto& target = tune_task_.target;
+  std::vector<std::unique_ptr<AutoGenRule>> rules;
   // TODO(zhhsplendid): pass correct output names to AutoInline
-  sketch_rules_.emplace_back(new AutoInline(target, tune_task_.output_names));
-  sketch_rules_.emplace_back(new MultiLevelTiling(target));
-  sketch_rules_.emplace_back(new AddCacheRead(target));
-  sketch_rules_.emplace_back(new AddCacheWrite(target));
-  sketch_rules_.emplace_back(new AutoUnroll(target));
-  sketch_rules_.emplace_back(new SkipRule(target));
+  rules.emplace_back(new AutoInline(target, tune_task_.output_names));
+  rules.emplace_back(new MultiLevelTiling(target));
+  rules.emplace_back(new AddCacheRead(target));
+  rules.emplace_back(new AddCacheWrite(target));
+  rules.emplace_back(new AutoUnroll(target));
+  rules.emplace_back(new SkipRule(target));
+  return rules;
 }
 
 SearchState SearchSpace::GetScheduleMutate(const SearchState& state, const ExprCostModel& cost_model) {
@@ -67,12 +76,61 @@ SearchState SearchSpace::GetScheduleMutate(const SearchState& state, const ExprC
   return ret;
 }
 
+std::vector<SearchState> SearchSpace::GetScheduleMutates(const std::vector<SearchState>& states,
+                                                         const ExprCostModel& cost_model,
+                                                         int num_threads,
+                                                         uint32_t seed) {
+  std::vector<SearchState> results(states.size());
+  auto mutate_fn = [this, &states, &results, seed](int index) {
+    if (states[index]->applicable_rules.empty()) {
+      results[index] = states[index];
+      return;
+    }
+    std::mt19937 rng(seed + index);
+    auto local_rules = CreateSketchRules();
+    for (auto& rule : local_rules) {
+      rule->SetRandEngine(&rng);
+    }
+    results[index] = RandomScheduleMutate(states[index], &rng, &local_rules);
+  };
+  utils::parallel_run(mutate_fn, utils::SequenceDispatcher(0, states.size()), num_threads);
+
+  if (FLAGS_auto_schedule_use_cost_model) {
+    std::vector<const ir::ModuleExpr*> modules(results.size());
+    std::transform(results.begin(), results.end(), modules.begin(), [](const SearchState& state) {
+      return &state->ir_schedule.GetModule();
+    });
+    std::vector<float> costs = cost_model.Predict(modules, tune_task_.target, num_threads);
+    for (size_t i = 0; i < results.size(); ++i) {
+      results[i]->predicted_cost = costs[i];
+    }
+  }
+  VLOG(4) << JoinStatesDebugString("SearchSpace::GetScheduleMutates", results, /*verbose=*/VLOG_IS_ON(5));
+  return results;
+}
+
 SearchState SearchSpace::ManualScheduleMutate(const SearchState& state) {
   // TODO(zhhsplendid): Add manual schedule mutate
   return state;
 }
 
-SearchState SearchSpace::RandomScheduleMutate(const SearchState& state) {
+SearchState SearchSpace::RandomScheduleMutate(const SearchState& state,
+                                              std::mt19937* rng,
+                                              const std::vector<std::unique_ptr<AutoGenRule>>* local_rules) {
+  // find the copy of a rule in local_rules
+  auto get_rule = [this, local_rules](AutoGenRule* rule) -> AutoGenRule* {
+    if (local_rules == nullptr) {
+      return rule;
+    }
+    for (size_t i = 0; i < sketch_rules_.size(); ++i) {
+      if (sketch_rules_[i].get() == rule) {
+        return local_rules->at(i).get();
+      }
+    }
+    LOG(FATAL) << "The rule " << rule->GetRuleName() << " is not a sketch rule of this SearchSpace";
+    return nullptr;
+  };
+
   // 1. Found the schedules which can apply on this Expr
   // 2. Make a distribution on those schedules
   std::map<int, int> weight_to_rule_index;
@@ -80,7 +138,7 @@ SearchState SearchSpace::RandomScheduleMutate(const SearchState& state) {
   SearchState ret(state);
   std::vector<RuleApplyType> apply_types(ret->applicable_rules.size());
   for (int idx = 0; idx != ret->applicable_rules.size(); ++idx) {
-    AutoGenRule* rule        = ret->applicable_rules.at(idx);
+    AutoGenRule* rule        = get_rule(ret->applicable_rules.at(idx));
     RuleApplyType apply_type = rule->Init(&ret->ir_schedule);
     VLOG(6) << "Evaluate rule:" << rule->GetRuleName() << "=" << static_cast<int>(apply_type);
     apply_types[idx] = apply_type;
@@ -97,14 +155,14 @@ SearchState SearchSpace::RandomScheduleMutate(const SearchState& state) {
   }
 
   // 3. Sample a schedule on the distribution
-  int sample_weighted_index = rand() % cur_weight;
+  int sample_weighted_index = rng ? std::uniform_int_distribution<int>(0, cur_weight - 1)(*rng) : rand() % cur_weight;
 
   auto iter = weight_to_rule_index.upper_bound(sample_weighted_index);
   --iter;
 
   int sample_rule_index = iter->second;
   CHECK_LT(sample_rule_index, ret->applicable_rules.size());
-  AutoGenRule* sample_rule = ret->applicable_rules.at(sample_rule_index);
+  AutoGenRule* sample_rule = get_rule(ret->applicable_rules.at(sample_rule_index));
   VLOG(7) << "Apply rule: " << sample_rule->GetRuleName() << " with index=" << sample_weighted_index - iter->first;
   // 4. Apply the schedule change
   sample_rule->Apply(sample_weighted_index - iter->first);
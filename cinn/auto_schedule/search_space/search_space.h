@@ -14,7 +14,9 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
+#include <random>
 #include <utility>
 #include <vector>
 
@@ -45,6 +47,22 @@ class SearchSpace {
   // Sketch mutate, returns the mutated ModuleExpr and estimited cost
   virtual SearchState GetScheduleMutate(const SearchState& state, const ExprCostModel& cost_model);
 
+  /**
+   * \brief Mutate a batch of states with several threads and estimate their costs in one batch.
+   * @param states The states to mutate.
+   * @param cost_model The cost model to estimate the costs of the mutated states.
+   * @param num_threads The number of threads, -1 means the number of hardware threads.
+   * @param seed The random choices of mutating states[i], including the ones made inside the rules, are drawn
+   *        from the stream seeded with seed + i, so the results don't depend on the number of threads except for
+   *        the numeric suffixes of the names generated by UniqName.
+   * @return The mutated states with estimated costs, which are mutated in place like GetScheduleMutate,
+   *         so the states should be different objects.
+   */
+  virtual std::vector<SearchState> GetScheduleMutates(const std::vector<SearchState>& states,
+                                                      const ExprCostModel& cost_model,
+                                                      int num_threads,
+                                                      uint32_t seed);
+
   /**
    * \brief Generate sketch as initial population of evolutionary search.
    * @param num The number of sketches to generate.
@@ -63,8 +81,15 @@ class SearchSpace {
   // TODO(zhhsplendid): mutate by manual schedule.
   SearchState ManualScheduleMutate(const SearchState& state);
 
-  // mutate by sketch rules randomly
-  SearchState RandomScheduleMutate(const SearchState& state);
+  // mutate by sketch rules randomly, the choice of rule is drawn from rng if not nullptr, otherwise from rand().
+  // the rules keep the IRSchedule they are applied on, so the threads mutating states at the same time
+  // should apply their own copies of sketch_rules_ passed by local_rules
+  SearchState RandomScheduleMutate(const SearchState& state,
+                                   std::mt19937* rng = nullptr,
+                                   const std::vector<std::unique_ptr<AutoGenRule>>* local_rules = nullptr);
+
+  // create the set of AutoGenRules used by the states of this task
+  std::vector<std::unique_ptr<AutoGenRule>> CreateSketchRules() const;
 
   // Generate num sketchs, each with several rounds of SketchMutate
   std::vector<SearchState> InitSketchWithRandomStrategy(int num);
@@ -20,6 +20,7 @@
 #include <vector>
 
 #include "cinn/ir/ir_base.h"
+#include "cinn/ir/ir_compare.h"
 #include "cinn/ir/ir_printer.h"
 #include "cinn/ir/ir_schedule.h"
 #include "cinn/ir/ir_visitor.h"
@@ -133,6 +134,14 @@ bool SearchStateEqual::operator()(const SearchState& lhs, const SearchState& rhs
   return true;
 }
 
+uint64_t SearchStateCanonicalHash(const SearchState& state) {
+  uint64_t hash_key = 0;
+  for (auto&& expr : state->ir_schedule.GetModule().GetExprs()) {
+    hash_key = ir::IrCanonicalHash(expr, /*allow_name_suffix_diff=*/true, hash_key);
+  }
+  return hash_key;
+}
+
 std::string JoinStatesDebugString(const std::string& title, const std::vector<SearchState>& states, bool verbose) {
   std::stringstream ss;
   ss << title << " states size:" << states.size() << "\n";
@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <functional>
 #include <limits>
 #include <vector>
@@ -72,6 +73,11 @@ struct SearchStateEqual {
   bool operator()(const SearchState& lhs, const SearchState& rhs) const;
 };
 
+// Return the canonical hash of the scheduled ModuleExpr of a state, the states equal under SearchStateEqual
+// have the same one. Unlike SearchStateHash it is stable across processes, so it can be persisted to identify
+// the candidates lowered to the same IR by different schedules.
+uint64_t SearchStateCanonicalHash(const SearchState& state);
+
 /*!
  * \brief concatenate debug strings of all states with additional info
  * \param title head of the result string
@@ -124,6 +124,9 @@ TEST(TestSearchState, SearchStateHash_Equal) {
   ASSERT_TRUE(equal_functor(a_plus_const_state1, a_plus_const_state2));
   ASSERT_NE(hash_functor(a_plus_const_state1), hash_functor(a_plus_b_state));
   ASSERT_FALSE(equal_functor(a_plus_const_state1, a_plus_b_state));
+
+  EXPECT_EQ(SearchStateCanonicalHash(a_plus_const_state1), SearchStateCanonicalHash(a_plus_const_state2));
+  EXPECT_NE(SearchStateCanonicalHash(a_plus_const_state1), SearchStateCanonicalHash(a_plus_b_state));
 }
 
 }  // namespace auto_schedule
@@ -21,6 +21,7 @@
 #include <functional>
 #include <limits>
 #include <memory>
+#include <random>
 #include <utility>
 
 #include "cinn/auto_schedule/database/database.h"
@@ -30,14 +31,21 @@
 #include "cinn/auto_schedule/task/tune_task.h"
 #include "cinn/auto_schedule/tuning.h"
 #include "cinn/optim/ir_copy.h"
+#include "cinn/utils/multi_threading.h"
 #include "cinn/utils/sized_multi_set.h"
 #include "cinn/utils/string.h"
 
 namespace cinn {
 namespace auto_schedule {
 
-EvolutionarySearch::EvolutionarySearch(const TuneTask& tune_task, const ExprCostModel& cost_model, Database* database)
-    : tune_task_(tune_task), cost_model_(cost_model), database_(database) {
+EvolutionarySearch::EvolutionarySearch(const TuneTask& tune_task,
+                                       const ExprCostModel& cost_model,
+                                       Database* database,
+                                       int random_seed)
+    : tune_task_(tune_task),
+      cost_model_(cost_model),
+      database_(database),
+      rng_(random_seed >= 0 ? random_seed : std::random_device()()) {
   search_space_ = std::make_unique<SearchSpace>(tune_task);
 }
 
@@ -63,7 +71,10 @@ std::vector<SearchState> EvolutionarySearch::SearchModuleExprBests(const TuningO
   init_population.insert(init_population.end(), init_sketch.begin(), init_sketch.end());
 
   std::vector<SearchState> picked_bests =
-      Evolve(init_population, options.evolution_cross_over_num, options.num_samples_per_iteration);
+      Evolve(init_population,
+             options.evolution_cross_over_num,
+             options.num_samples_per_iteration,
+             options.evolution_num_threads);
   VLOG(4) << JoinStatesDebugString("EvolutionarySearch::Evolve", picked_bests, /*verbose=*/VLOG_IS_ON(5));
   return picked_bests;
 }
@@ -98,7 +109,7 @@ std::vector<SearchState> EvolutionarySearch::InitSketch(int num, const std::stri
   return search_space_->GenerateSketches(num, strategy);
 }
 
-SearchState EvolutionarySearch::CrossOver(const SearchState& state1, const SearchState& state2) {
+SearchState EvolutionarySearch::CrossOver(const SearchState& state1, const SearchState& state2, std::mt19937* rng) {
   // TODO(CtfGo): tracing CrossOver with IRSchedule
   std::vector<ir::Expr> cross_over_exprs;
   std::vector<ir::Expr> father_exprs = state1->ir_schedule.GetModule().GetExprs();
@@ -108,7 +119,7 @@ SearchState EvolutionarySearch::CrossOver(const SearchState& state1, const Searc
       << "CrossOver ModuleExpr in EvolutionarySearch must have same number of AST";
 
   for (size_t i = 0; i < father_exprs.size(); ++i) {
-    if (rand() % 2 == 0) {
+    if ((*rng)() % 2 == 0) {
       cross_over_exprs.push_back(optim::IRCopy(father_exprs[i]));
     } else {
       cross_over_exprs.push_back(optim::IRCopy(mother_exprs[i]));
@@ -121,27 +132,47 @@ SearchState EvolutionarySearch::CrossOver(const SearchState& state1, const Searc
 
 std::vector<SearchState> EvolutionarySearch::Evolve(const std::vector<SearchState>& population,
                                                     int cross_over_num,
-                                                    int ret_num) {
-  VLOG(4) << utils::StringFormat(
-      "Evolve with population size=%lu,cross_over_num:%lu,ret_num:%lu", population.size(), cross_over_num, ret_num);
+                                                    int ret_num,
+                                                    int num_threads) {
+  VLOG(4) << utils::StringFormat("Evolve with population size=%lu,cross_over_num:%lu,ret_num:%lu,num_threads:%d",
+                                 population.size(),
+                                 cross_over_num,
+                                 ret_num,
+                                 num_threads);
   int generation_num = population.size();
   if (generation_num == 0) {
     return std::vector<SearchState>();
   }
-  std::vector<SearchState> evolution(population);
+  // two different parents are needed to cross over
+  if (generation_num < 2) {
+    cross_over_num = 0;
+  }
 
-  for (int i = 0; i < cross_over_num; ++i) {
-    int first_rand_idx  = rand() % generation_num;
-    int second_rand_idx = rand() % generation_num;
-    while (first_rand_idx == second_rand_idx) {
-      second_rand_idx = rand() % generation_num;
+  // draw the parents in order, and every crossover uses its own random stream,
+  // so the results are the same with any number of threads
+  std::uniform_int_distribution<int> pick_parent(0, generation_num - 1);
+  std::vector<std::pair<int, int>> parents(cross_over_num);
+  for (auto& parent : parents) {
+    parent.first  = pick_parent(rng_);
+    parent.second = pick_parent(rng_);
+    while (parent.first == parent.second) {
+      parent.second = pick_parent(rng_);
     }
-    evolution.push_back(CrossOver(population[first_rand_idx], population[second_rand_idx]));
   }
-
+  std::vector<SearchState> evolution(population);
+  evolution.resize(generation_num + cross_over_num);
+  uint32_t cross_over_seed = rng_();
+  auto cross_over_fn       = [&](int index) {
+    std::mt19937 rng(cross_over_seed + index);
+    evolution[generation_num + index] =
+        CrossOver(population[parents[index].first], population[parents[index].second], &rng);
+  };
+  utils::parallel_run(cross_over_fn, utils::SequenceDispatcher(0, cross_over_num), num_threads);
+
+  std::vector<SearchState> mutated = search_space_->GetScheduleMutates(evolution, cost_model_, num_threads, rng_());
   utils::SizedMultiSet<SearchState> evolution_with_cost(ret_num);
-  for (size_t i = 0; i < evolution.size(); ++i) {
-    evolution_with_cost.Push(search_space_->GetScheduleMutate(evolution[i], cost_model_));
+  for (size_t i = 0; i < mutated.size(); ++i) {
+    evolution_with_cost.Push(mutated[i]);
   }
 
   return evolution_with_cost.ReturnAsContainer<std::vector<SearchState>>();
@@ -15,6 +15,7 @@
 #pragma once
 
 #include <memory>
+#include <random>
 #include <vector>
 
 #include "cinn/auto_schedule/cost_model/expr_cost_model.h"
@@ -38,8 +39,13 @@ class EvolutionarySearch {
    *
    * @param tune_task: the TuneTask this class works on. This class doesn't
    *     take ownership of the pointer.
+   * @param random_seed: the seed of the random choices made by the search,
+   *     -1 means a random seed.
    */
-  EvolutionarySearch(const TuneTask& tune_task, const ExprCostModel& cost_model, Database* database);
+  EvolutionarySearch(const TuneTask& tune_task,
+                     const ExprCostModel& cost_model,
+                     Database* database,
+                     int random_seed = -1);
 
   /**
    * Destructor
@@ -101,9 +107,13 @@ class EvolutionarySearch {
    */
   std::vector<SearchState> InitSketch(int num, const std::string& strategy);
 
-  SearchState CrossOver(const SearchState& state1, const SearchState& state2);
+  SearchState CrossOver(const SearchState& state1, const SearchState& state2, std::mt19937* rng);
 
-  std::vector<SearchState> Evolve(const std::vector<SearchState>& population, int cross_over_num, int ret_num);
+  // cross over and mutate the population with num_threads threads, and return the ret_num best ones
+  std::vector<SearchState> Evolve(const std::vector<SearchState>& population,
+                                  int cross_over_num,
+                                  int ret_num,
+                                  int num_threads);
 
   std::vector<SearchState> PickNextGenerationEpsGreedy(const std::vector<SearchState>& population,
                                                        const std::vector<SearchState>& random_init,
@@ -117,6 +127,9 @@ class EvolutionarySearch {
   Database* database_;               // not owned
   // used to depuplicate states with the same structural IR
   std::unordered_set<SearchState, SearchStateHash, SearchStateEqual> visited_candidates_;
+  // the random engine seeding the streams of the jobs run in parallel,
+  // so the choices don't depend on the number of threads
+  std::mt19937 rng_;
 };
 
 }  // namespace auto_schedule
@@ -14,10 +14,14 @@
 
 #include "cinn/auto_schedule/search_strategy/evolutionary_search.h"
 
+#include <gflags/gflags.h>
 #include <gtest/gtest.h>
 
+#include <cstdlib>
+#include <limits>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "cinn/auto_schedule/cost_model/expr_cost_model.h"
 #include "cinn/auto_schedule/database/database.h"
@@ -25,8 +29,12 @@
 #include "cinn/auto_schedule/search_space/search_state.h"
 #include "cinn/auto_schedule/task/tune_task.h"
 #include "cinn/auto_schedule/tuning.h"
+#include "cinn/cinn.h"
 #include "cinn/ir/ir_base.h"
 #include "cinn/ir/ir_schedule.h"
+#include "cinn/lang/lower.h"
+
+DECLARE_bool(auto_schedule_use_cost_model);
 
 namespace cinn {
 namespace auto_schedule {
@@ -70,6 +78,17 @@ class MockSearchSpace : public SearchSpace {
     return ret;
   }
 
+  std::vector<SearchState> GetScheduleMutates(const std::vector<SearchState>& states,
+                                              const ExprCostModel& cost_model,
+                                              int num_threads,
+                                              uint32_t seed) override {
+    std::vector<SearchState> ret;
+    for (const SearchState& state : states) {
+      ret.push_back(GetScheduleMutate(state, cost_model));
+    }
+    return ret;
+  }
+
  private:
   int module_expr_size_ = 10;
   int min_expr_value_   = 0;
@@ -114,5 +133,61 @@ TEST(EvolutionarySearch, GetEpsGreedy) {
   }
 }
 
+TEST(EvolutionarySearch, SameResultsWithDifferentThreads) {
+  FLAGS_auto_schedule_use_cost_model = true;
+  Context::Global().ResetNameId();
+#ifdef CINN_WITH_CUDA
+  Target target = common::DefaultNVGPUTarget();
+#else
+  Target target = common::DefaultHostTarget();
+#endif
+
+  Expr M(32), N(32), K(32);
+  Placeholder<float> A("A", {M, K});
+  Placeholder<float> B("B", {K, N});
+  Var k(K.as_int32(), "reduce_axis_k");
+  ir::Tensor C = Compute(
+      {M, N}, [&](Var i, Var j) { return ReduceSum(A(i, k) * B(k, j), {k}); }, "C");
+  poly::StageMap stages = CreateStages({C});
+
+  TuneTask task;
+  task.target        = target;
+  task.lowered_funcs = lang::LowerVec("test_evolutionary_search", stages, {A, B, C}, {}, {}, nullptr, target, true);
+
+  // train the cost model on some sketches, so the costs of the candidates are predicted
+  srand(0);
+  SearchSpace search_space(task);
+  std::vector<SearchState> sketches = search_space.GenerateSketches(8, "rule_prune");
+  std::vector<const ir::ModuleExpr*> samples;
+  std::vector<float> labels;
+  for (size_t i = 0; i < sketches.size(); ++i) {
+    samples.push_back(&sketches[i]->ir_schedule.GetModule());
+    labels.push_back(i);
+  }
+  ExprCostModel cost_model;
+  cost_model.Train(samples, labels, target);
+
+  auto search = [&](int num_threads) {
+    // the sketches are generated serially with std::rand()
+    srand(0);
+    Database db(2);
+    EvolutionarySearch evolutionary_search(task, cost_model, &db, /*random_seed=*/1);
+    TuningOptions options;
+    options.evolution_num_threads = num_threads;
+    return evolutionary_search.SearchModuleExprBests(options);
+  };
+  std::vector<SearchState> results_1 = search(1);
+  std::vector<SearchState> results_4 = search(4);
+
+  // the names generated by different threads differ only in the suffixes
+  ASSERT_FALSE(results_1.empty());
+  ASSERT_EQ(results_1.size(), results_4.size());
+  for (size_t i = 0; i < results_1.size(); ++i) {
+    EXPECT_LT(results_1[i]->predicted_cost, std::numeric_limits<float>::max());
+    EXPECT_FLOAT_EQ(results_1[i]->predicted_cost, results_4[i]->predicted_cost);
+    EXPECT_EQ(SearchStateCanonicalHash(results_1[i]), SearchStateCanonicalHash(results_4[i]));
+  }
+}
+
 }  // namespace auto_schedule
 }  // namespace cinn
@@ -16,8 +16,11 @@
 
 #include <glog/logging.h>
 
+#include <algorithm>
+#include <cstdint>
 #include <functional>
 #include <limits>
+#include <unordered_set>
 
 #include "cinn/auto_schedule/cost_model/expr_cost_model.h"
 #include "cinn/auto_schedule/measure/measure.h"
@@ -43,8 +46,14 @@ DECLARE_bool(auto_schedule_use_cost_model);
 namespace cinn {
 namespace auto_schedule {
 
-TaskOptimizer::TaskOptimizer(const TuneTask& task, ScheduleMeasurer* schedule_measurer, Database* database)
-    : task_(&task), schedule_measurer_(schedule_measurer), database_(database), cost_model_() {}
+TaskOptimizer::TaskOptimizer(const TuneTask& task,
+                             ScheduleMeasurer* schedule_measurer,
+                             Database* database,
+                             ExprCostModel* cost_model)
+    : task_(&task),
+      schedule_measurer_(schedule_measurer),
+      cost_model_(cost_model ? cost_model : &own_cost_model_),
+      database_(database) {}
 
 TuningResult::OptimizedComputeExpr TaskOptimizer::Optimize(const TuningOptions& options) {
   // TODO(zhhsplendid): develop other optimize methods and configure the method by options.
@@ -65,7 +74,8 @@ TuningResult::OptimizedComputeExpr TaskOptimizer::OptimizeByEvolution(const Tuni
   if (evolutionary_search_ == nullptr) {
     // TODO(zhhsplendid): check whether the options is same as previous,
     // if not, we should create new EvolutionarySearch
-    evolutionary_search_ = std::make_unique<EvolutionarySearch>(*task_, cost_model_, database_);
+    evolutionary_search_ =
+        std::make_unique<EvolutionarySearch>(*task_, *cost_model_, database_, options.evolution_random_seed);
   }
 
   // use initial lowered function as default result
@@ -73,7 +83,7 @@ TuningResult::OptimizedComputeExpr TaskOptimizer::OptimizeByEvolution(const Tuni
   result.lowered_funcs.push_back(optim::IRCopy(task_->lowered_funcs));
   if (options.num_measure_trials == 0) {  // no need to measure and simply return the best searched
     std::vector<MeasureInput> measure_candidates;
-    std::vector<SearchState> states = SearchOneRound(options, &measure_candidates);
+    std::vector<SearchState> states = SearchOneRound(options, &measure_candidates, /*canonical_hashes=*/nullptr);
     if (!states.empty()) {
       result.lowered_funcs = measure_candidates[0].lowered_funcs;
     } else {
@@ -88,7 +98,8 @@ TuningResult::OptimizedComputeExpr TaskOptimizer::OptimizeByEvolution(const Tuni
   while (measured_count < options.num_measure_trials) {
     VLOG(4) << "Launch a new search, current measured_count:" << measured_count;
     std::vector<MeasureInput> measure_inputs;
-    std::vector<SearchState> states = SearchOneRound(options, &measure_inputs);
+    std::vector<uint64_t> canonical_hashes;
+    std::vector<SearchState> states = SearchOneRound(options, &measure_inputs, &canonical_hashes);
     if (states.empty()) {  // no new valid candidate achieved
       ++continuous_empty_cnt;
       if (continuous_empty_cnt <= kMaxRetryContinuousEmpty_) {
@@ -109,8 +120,8 @@ TuningResult::OptimizedComputeExpr TaskOptimizer::OptimizeByEvolution(const Tuni
         << "ScheduleMeasurer didn't output same number of MeasureOutput of states in TaskOptimizer";
     // record to database
     for (size_t i = 0; i < states.size(); ++i) {
-      database_->AddRecord(
-          TuningRecord(measure_inputs[i].task->serialized_key, states[i], measure_outputs[i].execution_cost));
+      database_->AddRecord(TuningRecord(
+          measure_inputs[i].task->serialized_key, states[i], measure_outputs[i].execution_cost, canonical_hashes[i]));
     }
 
     // update cost model
@@ -124,11 +135,14 @@ TuningResult::OptimizedComputeExpr TaskOptimizer::OptimizeByEvolution(const Tuni
       VLOG(4) << utils::StringFormat("Update CostModel with samples size=%lu,labels size=%lu",
                                      cost_model_samples.size(),
                                      cost_model_labels.size());
-      cost_model_.Update(cost_model_samples, cost_model_labels, task_->target);
+      cost_model_->Update(cost_model_samples, cost_model_labels, task_->target);
     }
 
     // update the best
     for (size_t i = 0; i < measure_outputs.size(); ++i) {
+      if (measure_outputs[i].error_msg.empty()) {
+        best_cost_ = std::min(best_cost_, measure_outputs[i].execution_cost);
+      }
       if (measure_outputs[i].execution_cost < min_exec_time) {
         VLOG(4) << "Update best candidate with execution_cost:" << measure_outputs[i].execution_cost << "us";
         min_exec_time        = measure_outputs[i].execution_cost;
@@ -143,12 +157,24 @@ TuningResult::OptimizedComputeExpr TaskOptimizer::OptimizeByEvolution(const Tuni
 }
 
 std::vector<SearchState> TaskOptimizer::SearchOneRound(const TuningOptions& options,
-                                                       std::vector<MeasureInput>* measure_candidates) {
+                                                       std::vector<MeasureInput>* measure_candidates,
+                                                       std::vector<uint64_t>* canonical_hashes) {
   std::vector<SearchState> states = evolutionary_search_->SearchModuleExprEpsGreedy(options);
   VLOG(4) << JoinStatesDebugString("TaskOptimizer::EvolutionarySearch-Result", states, /*verbose=*/VLOG_IS_ON(5));
 
   size_t valid_cnt = 0;
+  std::unordered_set<uint64_t> round_hashes;
   for (size_t i = 0; i < states.size(); ++i) {
+    // different schedules may be lowered to the same IR, skip the ones measured before or in this round
+    uint64_t canonical_hash = 0;
+    if (canonical_hashes) {
+      canonical_hash = SearchStateCanonicalHash(states[i]);
+      if (database_->Contains(task_->serialized_key, canonical_hash) || !round_hashes.insert(canonical_hash).second) {
+        VLOG(4) << "Skip states-" << i << " lowered to the measured IR with canonical hash " << canonical_hash;
+        continue;
+      }
+    }
+
     std::vector<ir::Expr> best_exprs = states[i]->ir_schedule.GetModule().GetExprs();
     CHECK_EQ(best_exprs.size(), task_->lowered_funcs.size())
         << "RuntimeError: Expr size is not equal to LoweredFunc size in TaskOptimizer";
@@ -166,6 +192,9 @@ std::vector<SearchState> TaskOptimizer::SearchOneRound(const TuningOptions& opti
     // all functions are validated, collect this state to be measured
     if (valid_funcs.size() == init_funcs.size()) {
       states[valid_cnt++] = states[i];
+      if (canonical_hashes) {
+        canonical_hashes->push_back(canonical_hash);
+      }
       measure_candidates->emplace_back(MeasureInput());
       measure_candidates->back().task = task_;
       measure_candidates->back().lowered_funcs.emplace_back(std::move(valid_funcs));
@@ -174,48 +203,16 @@ std::vector<SearchState> TaskOptimizer::SearchOneRound(const TuningOptions& opti
 
   states.erase(states.begin() + valid_cnt, states.end());
   CHECK_EQ(states.size(), measure_candidates->size()) << "result size of states not equal to measure_candidates";
+  if (canonical_hashes) {
+    CHECK_EQ(states.size(), canonical_hashes->size()) << "result size of states not equal to canonical_hashes";
+  }
   VLOG(4) << "EvolutionarySearch return size=" << states.size() << ", valid count=" << valid_cnt;
   VLOG(4) << JoinStatesDebugString("TaskOptimizer::SearchOneRound-Result", states, /*verbose=*/VLOG_IS_ON(5));
   return states;
 }
 
 ir::LoweredFunc TaskOptimizer::FuncWithUpdatedBody(const ir::LoweredFunc& old_func, ir::Expr& body) {
-  ir::ModuleExpr mod_expr(std::vector<ir::Expr>({body}));
-  ir::IRSchedule ir_sch(mod_expr);
-
-  // temp_bufs may be deleted during auto tuning (such as auto inline),
-  // we have to check from old temp bufs and set them as local buffer.
-  for (const ir::Buffer& buf : old_func->temp_bufs) {
-    const std::string& buf_name              = buf->name;
-    std::vector<ir::Expr> all_block_realizes = ir_sch.GetAllBlocks();
-    for (ir::Expr& e : all_block_realizes) {
-      const ir::ScheduleBlockRealize* sche_block_realize = e.As<ir::ScheduleBlockRealize>();
-      const std::string& sche_name = sche_block_realize->schedule_block.As<ir::ScheduleBlock>()->name;
-      if (buf_name == "_" + sche_name) {
-        VLOG(6) << "Set local buffer for temp buffer " << buf_name;
-        ir_sch.SetBuffer(e, "local", true);
-        break;
-      }
-    }
-  }
-
-  ir::Expr updated_body = ir_sch.GetModule().GetExprs()[0];
-#ifdef CINN_WITH_CUDA
-  optim::OptimizeExprGPU(&updated_body);
-#endif
-
-  // Get new temp bufs by analyzing.
-  std::vector<ir::Buffer> new_temp_bufs = lang::GetTempBuffers(old_func->args, updated_body);
-  ir::LoweredFunc new_func = ir::_LoweredFunc_::Make(old_func->name, old_func->args, updated_body, new_temp_bufs);
-#ifdef CINN_WITH_CUDA
-  if (task_->target == common::DefaultNVGPUTarget()) {
-    new_func->PrepareCudaAxisInfoFromBody();
-  }
-#endif
-  new_func = optim::Optimize(Expr(new_func), task_->target, false).as_lowered_func_ref();
-  new_func->PrepareBufferCastExprs(/*with_expr_gen_tensor = */ false);
-
-  return new_func;
+  return hlir::framework::UpdateFuncWithNewBody(task_->target, old_func, body);
 }
 
 // detect the limit of avaliable shared memory on the currnet NVGPU with CUDA runtime
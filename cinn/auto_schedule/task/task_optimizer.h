@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <cstdint>
+#include <limits>
 #include <memory>
 
 #include "cinn/auto_schedule/cost_model/expr_cost_model.h"
@@ -32,15 +34,26 @@ namespace auto_schedule {
 // optimal schedule for the task.
 class TaskOptimizer {
  public:
-  TaskOptimizer(const TuneTask& task, ScheduleMeasurer* schedule_measurer, Database* database);
+  // the cost model can be shared by the optimizers of different tasks,
+  // and each optimizer trains its own one if it's nullptr
+  TaskOptimizer(const TuneTask& task,
+                ScheduleMeasurer* schedule_measurer,
+                Database* database,
+                ExprCostModel* cost_model = nullptr);
 
   TuningResult::OptimizedComputeExpr Optimize(const TuningOptions& options);
 
+  // the minimum execution cost of the candidates measured successfully so far, infinity if none
+  double best_cost() const { return best_cost_; }
+
  private:
   TuningResult::OptimizedComputeExpr OptimizeByEvolution(const TuningOptions& options);
 
-  // call search candidates once by EvolutionarySearch and prune invalid ones
-  std::vector<SearchState> SearchOneRound(const TuningOptions& options, std::vector<MeasureInput>* measure_candidates);
+  // call search candidates once by EvolutionarySearch and prune invalid ones, if canonical_hashes is not nullptr,
+  // the ones lowered to the IR measured before are pruned too and the hashes of the returned states are saved
+  std::vector<SearchState> SearchOneRound(const TuningOptions& options,
+                                          std::vector<MeasureInput>* measure_candidates,
+                                          std::vector<uint64_t>* canonical_hashes);
 
   ir::LoweredFunc FuncWithUpdatedBody(const ir::LoweredFunc& old_func, ir::Expr& body);
 
@@ -53,8 +66,11 @@ class TaskOptimizer {
   const TuneTask* task_;
   ScheduleMeasurer* schedule_measurer_;
   std::unique_ptr<EvolutionarySearch> evolutionary_search_ = nullptr;
-  ExprCostModel cost_model_;
+  ExprCostModel own_cost_model_;
+  // the cost model in use, either own_cost_model_ or a shared one
+  ExprCostModel* cost_model_;
   Database* database_;
+  double best_cost_ = std::numeric_limits<double>::infinity();
 };
 
 }  // namespace auto_schedule
@@ -0,0 +1,117 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/task_scheduler/gradient_allocation.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <unordered_map>
+
+namespace cinn {
+namespace auto_schedule {
+
+GradientAllocation::GradientAllocation(const std::vector<TuneTask>& tasks, const Config& config)
+    : TaskScheduler(tasks, config),
+      weights_(tasks.size(), 1),
+      cost_histories_(tasks.size()),
+      num_picked_(tasks.size(), 0) {
+  CHECK(config_.backward_weight >= 0.0 && config_.backward_weight <= 1.0) << "backward_weight should be in [0, 1]";
+  CHECK_GT(config_.backward_window, 0) << "backward_window should be greater than 0";
+  // a group appearing several times in the graph is created as several tasks with the same serialized_key
+  std::unordered_map<std::string, int> first_task_ids;
+  for (int i = 0; i < tasks.size(); ++i) {
+    const std::string& key = tasks[i].serialized_key;
+    if (key.empty()) {
+      tuned_task_ids_.push_back(i);
+      continue;
+    }
+    auto it = first_task_ids.find(key);
+    if (it == first_task_ids.end()) {
+      first_task_ids.emplace(key, i);
+      tuned_task_ids_.push_back(i);
+    } else {
+      ++weights_[it->second];
+    }
+  }
+  for (int i = 0; i < tasks.size(); ++i) {
+    if (!tasks[i].serialized_key.empty()) {
+      weights_[i] = weights_[first_task_ids.at(tasks[i].serialized_key)];
+    }
+  }
+}
+
+int GradientAllocation::NextTaskId() {
+  if (cur_task_id_ >= tuned_task_ids_.size()) {
+    return -1;
+  }
+  ++cur_task_id_;
+
+  int next_id = -1;
+  // tune every task once first
+  for (int i : tuned_task_ids_) {
+    if (num_picked_[i] == 0) {
+      next_id = i;
+      break;
+    }
+  }
+  if (next_id == -1) {
+    double min_gradient = std::numeric_limits<double>::infinity();
+    for (int i : tuned_task_ids_) {
+      double gradient = Gradient(i);
+      if (gradient < min_gradient) {
+        min_gradient = gradient;
+        next_id      = i;
+      }
+    }
+    VLOG(4) << "GradientAllocation picks task " << next_id << " with gradient " << min_gradient;
+  }
+  if (next_id == -1) {
+    // no task has been measured, fall back to the least tuned one
+    next_id = *std::min_element(tuned_task_ids_.begin(), tuned_task_ids_.end(), [this](int lhs, int rhs) {
+      return num_picked_[lhs] < num_picked_[rhs];
+    });
+  }
+  ++num_picked_[next_id];
+  return next_id;
+}
+
+void GradientAllocation::UpdateTaskCost(int task_id, double best_cost) {
+  CHECK(task_id >= 0 && task_id < cost_histories_.size()) << "Invalid task id: " << task_id;
+  if (std::isfinite(best_cost)) {
+    auto& history = cost_histories_[task_id];
+    history.push_back(history.empty() ? best_cost : std::min(best_cost, history.back()));
+  }
+}
+
+double GradientAllocation::Gradient(int task_id) const {
+  const auto& history = cost_histories_[task_id];
+  if (history.empty()) {
+    return std::numeric_limits<double>::infinity();
+  }
+  int num_tuned   = history.size();
+  double cur_cost = history.back();
+  // the average decrease of the best cost over the recent times of tuning
+  int window      = std::min(config_.backward_window, num_tuned - 1);
+  double backward = window > 0 ? (cur_cost - history[num_tuned - 1 - window]) / window : 0.0;
+  // optimistically assume the cost reduces to zero at the rate it has been tuned
+  double forward = -cur_cost / num_tuned;
+  return weights_[task_id] * (config_.backward_weight * backward + (1.0 - config_.backward_weight) * forward);
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -0,0 +1,58 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "cinn/auto_schedule/task_scheduler/task_scheduler.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+// Schedule tasks with gradient_allocation strategy, that is picking the task
+// expected to reduce the end-to-end latency most with the next tuning. The gain of a task
+// is estimated from the recent improvement of its best cost and an optimistic guess that
+// the cost keeps decreasing at its average rate so far. The tasks sharing the same
+// serialized_key are the same group appearing several times in the graph, so only the
+// first of them is tuned and its gain is weighted by the number of them. Every tuned task
+// is picked once before the estimation is used, and each round picks as many tasks as
+// the number of tuned ones.
+class GradientAllocation : public TaskScheduler {
+ public:
+  GradientAllocation(const std::vector<TuneTask>& tasks, const Config& config);
+
+  const char* Name() const override { return "gradient_allocation"; };
+
+  int NextTaskId() override;
+
+  void UpdateTaskCost(int task_id, double best_cost) override;
+
+ private:
+  // the estimated change of the end-to-end latency by tuning the task once more, the more negative the better
+  double Gradient(int task_id) const;
+
+  // the first task of every group of tasks sharing the same serialized_key, which is the only one tuned
+  std::vector<int> tuned_task_ids_;
+  // the number of tasks sharing the serialized_key of every task
+  std::vector<int> weights_;
+  // the best costs of every task after each time it is tuned
+  std::vector<std::vector<double>> cost_histories_;
+  // the number of times every task is picked
+  std::vector<int> num_picked_;
+};
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -34,6 +34,11 @@ class TaskScheduler {
   struct Config {
     // The minimum threshold of earnings ratio, used by EfficiencyPriority
     float minimum_gain_threshold = 0.0;
+    // The weight of the recent improvement against the optimistic estimation of
+    // the gain of tuning a task, used by GradientAllocation
+    double backward_weight = 0.5;
+    // The number of recent times of tuning to estimate the improvement, used by GradientAllocation
+    int backward_window = 3;
   };
 
   // Create a TaskScheduler with the specific strategy name
@@ -51,6 +56,11 @@ class TaskScheduler {
   // Select a task to tune
   virtual int NextTaskId() = 0;
 
+  // Receive the best cost of a task found so far after it is tuned
+  virtual void UpdateTaskCost(int task_id, double best_cost) {}
+
+  virtual ~TaskScheduler() = default;
+
  protected:
   // A taskScheduler object should be created with the static function Make
   TaskScheduler(const std::vector<TuneTask>& tasks, const Config& config);
@@ -19,6 +19,7 @@
 #include <type_traits>
 
 #include "cinn/auto_schedule/task_scheduler/efficiency_priority.h"
+#include "cinn/auto_schedule/task_scheduler/gradient_allocation.h"
 #include "cinn/auto_schedule/task_scheduler/round_robin.h"
 
 namespace cinn {
@@ -32,6 +33,8 @@ TEST(TaskScheduler, Make) {
   ASSERT_STREQ(round_robin->Name(), "round_robin");
   auto efficiency_priority = TaskScheduler::Make(tasks, config, "efficiency_priority");
   ASSERT_STREQ(efficiency_priority->Name(), "efficiency_priority");
+  auto gradient_allocation = TaskScheduler::Make(tasks, config, "gradient_allocation");
+  ASSERT_STREQ(gradient_allocation->Name(), "gradient_allocation");
 }
 
 TEST(RoundRobinScheduler, NextTaskId) {
@@ -52,5 +55,32 @@ TEST(EfficiencyPriorityScheduler, NextTaskId) {
   ASSERT_EQ(-1, efficiency_priority->NextTaskId());
 }
 
+TEST(GradientAllocationScheduler, NextTaskId) {
+  std::vector<TuneTask> tasks(3);
+  tasks[0].serialized_key = "k0";
+  tasks[1].serialized_key = "k1";
+  // the group of task-1 appears twice in the graph
+  tasks[2].serialized_key = "k1";
+  TaskScheduler::Config config;
+  auto gradient_allocation = TaskScheduler::Make(tasks, config, "gradient_allocation");
+
+  // every task is tuned once in the first round, except task-2 sharing the tuning of task-1
+  std::vector<double> best_costs = {100.0, 60.0};
+  for (int i = 0; i < 2; ++i) {
+    int task_id = gradient_allocation->NextTaskId();
+    ASSERT_EQ(i, task_id);
+    gradient_allocation->UpdateTaskCost(task_id, best_costs[task_id]);
+  }
+  ASSERT_EQ(-1, gradient_allocation->NextTaskId());
+
+  // then the task with the largest expected gain is picked, weighted by the number of its appearances,
+  // so task-1 is picked though its cost is lower
+  gradient_allocation->Reset();
+  ASSERT_EQ(1, gradient_allocation->NextTaskId());
+  gradient_allocation->UpdateTaskCost(1, 30.0);
+  ASSERT_EQ(0, gradient_allocation->NextTaskId());
+  ASSERT_EQ(-1, gradient_allocation->NextTaskId());
+}
+
 }  // namespace auto_schedule
 }  // namespace cinn
@@ -72,6 +72,15 @@ struct TuningOptions {
   //
   // It explores the cases evolutionary search won't predict precisely
   float evolution_eps_greedy = 0.1f;
+
+  // The number of threads crossing over and mutating the candidates and
+  // extracting their features, -1 means the number of hardware threads
+  int evolution_num_threads = 1;
+
+  // The seed of the random choices in evolutionary search, the candidates
+  // generated with the same seed don't depend on evolution_num_threads except
+  // for the suffixes of the generated names, -1 means a random seed
+  int evolution_random_seed = -1;
 };
 
 // Result of the tuning process
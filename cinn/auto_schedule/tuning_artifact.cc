@@ -0,0 +1,216 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/tuning_artifact.h"
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include <cctype>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "cinn/ir/ir_printer.h"
+#include "cinn/ir/ir_schedule.h"
+#include "cinn/ir/schedule_desc.h"
+#include "cinn/optim/ir_copy.h"
+#include "cinn/utils/string.h"
+
+DECLARE_string(cinn_tuning_artifact);
+
+namespace cinn {
+namespace auto_schedule {
+
+namespace {
+
+bool IsNameChar(char c) { return std::isalnum(static_cast<unsigned char>(c)) || c == '_'; }
+
+// replace the longest variable name of src_names at the beginning of the name (after the leading
+// underscores of buffer names) with the variable of the same index in dst_names, the name should
+// be the variable itself or followed by '_', such as the blocks of the variable "var_1_reduce_temp"
+std::string MapName(const std::string& name,
+                    const std::vector<std::string>& src_names,
+                    const std::vector<std::string>& dst_names) {
+  size_t begin = name.find_first_not_of('_');
+  if (begin == std::string::npos) {
+    return name;
+  }
+  int matched = -1;
+  for (int i = 0; i < src_names.size(); ++i) {
+    const std::string& src = src_names[i];
+    size_t end             = begin + src.size();
+    if (name.compare(begin, src.size(), src) == 0 && (end == name.size() || name[end] == '_') &&
+        (matched == -1 || src.size() > src_names[matched].size())) {
+      matched = i;
+    }
+  }
+  if (matched == -1) {
+    return name;
+  }
+  return name.substr(0, begin) + dst_names[matched] + name.substr(begin + src_names[matched].size());
+}
+
+// the hash of the IR whose variable names are replaced by their canonical indices in var_names and the
+// other names are removed the numeric suffixes generated by UniqName, so it's the same for the groups
+// with the same fingerprint which are lowered to the same IR
+uint64_t CanonicalIRHash(const std::vector<ir::Expr>& exprs, const std::vector<std::string>& var_names) {
+  std::vector<std::string> index_names(var_names.size());
+  for (size_t i = 0; i < var_names.size(); ++i) {
+    index_names[i] = "$" + std::to_string(i);
+  }
+  // FNV-1a, which doesn't depend on the implementation of std::hash
+  uint64_t hash = 14695981039346656037ULL;
+  auto update   = [&hash](const std::string& token) {
+    for (char c : token) {
+      hash ^= static_cast<unsigned char>(c);
+      hash *= 1099511628211ULL;
+    }
+  };
+  for (const ir::Expr& expr : exprs) {
+    std::string code = utils::GetStreamCnt(expr);
+    size_t i         = 0;
+    while (i < code.size()) {
+      if (!std::isalpha(static_cast<unsigned char>(code[i])) && code[i] != '_') {
+        update(std::string(1, code[i++]));
+        continue;
+      }
+      size_t end = i;
+      while (end < code.size() && IsNameChar(code[end])) ++end;
+      std::string name = MapName(code.substr(i, end - i), var_names, index_names);
+      size_t name_end  = name.find_last_not_of("0123456789") + 1;
+      if (name_end < name.size() && name_end > 1 && name[name_end - 1] == '_') {
+        name.resize(name_end - 1);
+      }
+      update(name);
+      i = end;
+    }
+  }
+  return hash;
+}
+
+}  // namespace
+
+void TuningArtifact::Add(const hlir::framework::GroupFingerprint& fingerprint,
+                         const std::vector<ir::Expr>& initial_exprs,
+                         const ir::proto::ScheduleDesc& trace,
+                         const std::vector<ir::Expr>& scheduled_exprs,
+                         double execution_cost) {
+  auto* schedules = artifact_.mutable_schedules();
+  auto it         = schedules->find(fingerprint.key);
+  if (it != schedules->end() && it->second.execution_cost() <= execution_cost) {
+    return;
+  }
+  proto::TuningArtifact::GroupSchedule schedule;
+  for (const std::string& name : fingerprint.var_names) {
+    schedule.add_var_names(name);
+  }
+  schedule.mutable_trace()->CopyFrom(trace);
+  schedule.set_execution_cost(execution_cost);
+  schedule.set_initial_hash(CanonicalIRHash(initial_exprs, fingerprint.var_names));
+  schedule.set_scheduled_hash(CanonicalIRHash(scheduled_exprs, fingerprint.var_names));
+  (*schedules)[fingerprint.key] = std::move(schedule);
+}
+
+bool TuningArtifact::Contains(const hlir::framework::GroupFingerprint& fingerprint) const {
+  return artifact_.schedules().count(fingerprint.key) > 0;
+}
+
+bool TuningArtifact::Find(const hlir::framework::GroupFingerprint& fingerprint, ir::proto::ScheduleDesc* trace) const {
+  auto it = artifact_.schedules().find(fingerprint.key);
+  if (it == artifact_.schedules().end()) {
+    return false;
+  }
+  const auto& schedule = it->second;
+  if (schedule.var_names_size() != fingerprint.var_names.size()) {
+    LOG(WARNING) << "The tuned group has " << schedule.var_names_size() << " variables, but the group with the "
+                 << "same fingerprint has " << fingerprint.var_names.size();
+    return false;
+  }
+  std::vector<std::string> src_names(schedule.var_names().begin(), schedule.var_names().end());
+  trace->CopyFrom(schedule.trace());
+  // the block and loop names in the trace are derived from the variable names of the tuned group
+  for (auto& step : *trace->mutable_steps()) {
+    for (auto& attr : *step.mutable_attrs()) {
+      if (attr.dtype() == ir::proto::ScheduleDesc_Attr_DataType_STRING) {
+        attr.set_s(MapName(attr.s(), src_names, fingerprint.var_names));
+      } else if (attr.dtype() == ir::proto::ScheduleDesc_Attr_DataType_STRINGS) {
+        for (auto& s : *attr.mutable_strings()) {
+          s = MapName(s, src_names, fingerprint.var_names);
+        }
+      }
+    }
+  }
+  return true;
+}
+
+bool TuningArtifact::Apply(const hlir::framework::GroupFingerprint& fingerprint,
+                           const std::vector<ir::Expr>& initial_exprs,
+                           std::vector<ir::Expr>* scheduled_exprs) const {
+  ir::proto::ScheduleDesc trace;
+  if (!Find(fingerprint, &trace)) {
+    return false;
+  }
+  const auto& schedule = artifact_.schedules().at(fingerprint.key);
+  // the trace can't be replayed on different IR, such as the IR lowered by another version of CINN
+  if (CanonicalIRHash(initial_exprs, fingerprint.var_names) != schedule.initial_hash()) {
+    LOG(WARNING) << "The IR of the group is different from the tuned one with the same fingerprint, "
+                 << "skip the tuned schedule:\n"
+                 << fingerprint.key;
+    return false;
+  }
+  ir::IRSchedule ir_sch(ir::ModuleExpr(optim::IRCopy(initial_exprs)));
+  ir::ScheduleDesc::ReplayWithProto(trace, &ir_sch);
+  std::vector<ir::Expr> exprs = ir_sch.GetModule().GetExprs();
+  if (CanonicalIRHash(exprs, fingerprint.var_names) != schedule.scheduled_hash()) {
+    LOG(WARNING) << "The tuned schedule doesn't reproduce the tuned IR of the group, skip it:\n" << fingerprint.key;
+    return false;
+  }
+  *scheduled_exprs = std::move(exprs);
+  return true;
+}
+
+void TuningArtifact::Save(const std::string& path) const {
+  std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+  CHECK(ofs.is_open()) << "Failed to open the tuning artifact file: " << path;
+  CHECK(artifact_.SerializeToOstream(&ofs)) << "Failed to save the tuning artifact to: " << path;
+}
+
+void TuningArtifact::Load(const std::string& path) {
+  std::ifstream ifs(path, std::ios::binary);
+  CHECK(ifs.is_open()) << "Failed to open the tuning artifact file: " << path;
+  CHECK(artifact_.ParseFromIstream(&ifs)) << "Failed to parse the tuning artifact from: " << path;
+  VLOG(3) << "Load " << artifact_.schedules_size() << " tuned schedules from " << path;
+}
+
+const TuningArtifact* TuningArtifact::Global() {
+  static std::mutex mtx;
+  static std::string loaded_path;
+  static std::unique_ptr<TuningArtifact> artifact;
+  std::lock_guard<std::mutex> lock(mtx);
+  // reload the artifact only when the flag is changed, which should not happen during compiling
+  if (FLAGS_cinn_tuning_artifact != loaded_path) {
+    loaded_path = FLAGS_cinn_tuning_artifact;
+    artifact.reset();
+    if (!loaded_path.empty()) {
+      artifact = std::make_unique<TuningArtifact>();
+      artifact->Load(loaded_path);
+    }
+  }
+  return artifact.get();
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -0,0 +1,75 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "cinn/auto_schedule/auto_schedule.pb.h"
+#include "cinn/hlir/framework/kernel_cache.h"
+#include "cinn/ir/ir_base.h"
+#include "cinn/ir/schedule_desc.pb.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+/**
+ * TuningArtifact saves the best schedule traces of the tuned groups keyed by the fingerprints of the groups.
+ *
+ * It is exported by AutoTuner after tuning offline, and OpLowerer replays the trace of a group with
+ * ScheduleDesc::ReplayWithProto when lowering a group with the same fingerprint, so the compilation in
+ * other processes applies the tuned schedules without tuning again. The fingerprint doesn't include the
+ * names of variables, so the names in the trace are mapped to the variables of the group being lowered.
+ * Since the fingerprint only covers the graph of the group, the hashes of the IR the trace is replayed on
+ * and the IR it produces are saved too, and a trace is applied only if both hashes match.
+ */
+class TuningArtifact {
+ public:
+  // add the trace of a group, which replaces the one of the same fingerprint only if it runs faster,
+  // initial_exprs is the IR of the group lowered without schedule and scheduled_exprs is the IR replayed from it
+  void Add(const hlir::framework::GroupFingerprint& fingerprint,
+           const std::vector<ir::Expr>& initial_exprs,
+           const ir::proto::ScheduleDesc& trace,
+           const std::vector<ir::Expr>& scheduled_exprs,
+           double execution_cost);
+
+  bool Contains(const hlir::framework::GroupFingerprint& fingerprint) const;
+
+  // find the trace of the group with the fingerprint and map the variable names in it to the group,
+  // return false if not found
+  bool Find(const hlir::framework::GroupFingerprint& fingerprint, ir::proto::ScheduleDesc* trace) const;
+
+  // replay the trace of the group with the fingerprint on a copy of initial_exprs, the IR of the group lowered
+  // without schedule, return false if the group isn't tuned, or if initial_exprs or the replayed IR is different
+  // from the IR the trace is tuned with, then the default schedule should be used
+  bool Apply(const hlir::framework::GroupFingerprint& fingerprint,
+             const std::vector<ir::Expr>& initial_exprs,
+             std::vector<ir::Expr>* scheduled_exprs) const;
+
+  size_t Size() const { return artifact_.schedules_size(); }
+
+  void Save(const std::string& path) const;
+
+  void Load(const std::string& path);
+
+  // the artifact loaded from the file FLAGS_cinn_tuning_artifact, nullptr if the flag is empty
+  static const TuningArtifact* Global();
+
+ private:
+  proto::TuningArtifact artifact_;
+};
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -0,0 +1,143 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/tuning_artifact.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "cinn/cinn.h"
+#include "cinn/ir/collect_ir_nodes.h"
+#include "cinn/ir/ir_schedule.h"
+#include "cinn/lang/lower.h"
+#include "cinn/optim/ir_copy.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+ir::proto::ScheduleDesc CreateTrace(const std::string& block_name) {
+  ir::proto::ScheduleDesc trace;
+  auto* step = trace.add_steps();
+  step->set_type("GetLoops");
+  step->add_outputs("e0");
+  auto* attr = step->add_attrs();
+  attr->set_name("block_name");
+  attr->set_dtype(ir::proto::ScheduleDesc_Attr_DataType_STRING);
+  attr->set_s(block_name);
+  return trace;
+}
+
+// the body of C = A + 1 with the given names lowered without schedule
+std::vector<ir::Expr> LowerAddOne(const std::string& a_name, const std::string& c_name, int extent) {
+#ifdef CINN_WITH_CUDA
+  Target target = common::DefaultNVGPUTarget();
+#else
+  Target target = common::DefaultHostTarget();
+#endif
+  Expr M(extent);
+  Placeholder<float> A(a_name, {M});
+  ir::Tensor C = Compute(
+      {M}, [&](Var i) { return A(i) + Expr(1.f); }, c_name);
+  poly::StageMap stages = CreateStages({C});
+  auto funcs            = lang::LowerVec("fn_" + c_name, stages, {A, C}, {}, {}, nullptr, target, true);
+  return {funcs[0]->body};
+}
+
+TEST(TuningArtifact, AddAndFind) {
+  hlir::framework::GroupFingerprint fingerprint;
+  fingerprint.key       = "add_relu";
+  fingerprint.var_names = {"var_1", "var_12", "var_2"};
+
+  TuningArtifact artifact;
+  artifact.Add(fingerprint, {}, CreateTrace("var_12"), {}, 2.0);
+  // only the faster schedule is kept
+  artifact.Add(fingerprint, {}, CreateTrace("var_2"), {}, 3.0);
+  ASSERT_EQ(artifact.Size(), 1UL);
+
+  ir::proto::ScheduleDesc trace;
+  ASSERT_TRUE(artifact.Find(fingerprint, &trace));
+  EXPECT_EQ(trace.steps(0).attrs(0).s(), "var_12");
+
+  // the names in the trace are mapped to the variables of a structurally identical group
+  hlir::framework::GroupFingerprint other = fingerprint;
+  other.var_names                         = {"var_5", "var_6", "var_7"};
+  artifact.Add(fingerprint, {}, CreateTrace("var_12_reduce_temp"), {}, 1.0);
+  ASSERT_TRUE(artifact.Find(other, &trace));
+  EXPECT_EQ(trace.steps(0).attrs(0).s(), "var_6_reduce_temp");
+  // a name only beginning with a variable name isn't mapped
+  artifact.Add(fingerprint, {}, CreateTrace("var_123"), {}, 0.5);
+  ASSERT_TRUE(artifact.Find(other, &trace));
+  EXPECT_EQ(trace.steps(0).attrs(0).s(), "var_123");
+
+  other.key = "add_sigmoid";
+  EXPECT_FALSE(artifact.Find(other, &trace));
+}
+
+TEST(TuningArtifact, SaveAndLoad) {
+  std::string path = "/tmp/test_tuning_artifact_save_load.pb";
+  hlir::framework::GroupFingerprint fingerprint;
+  fingerprint.key       = "add_relu";
+  fingerprint.var_names = {"A", "B"};
+  TuningArtifact artifact;
+  artifact.Add(fingerprint, {}, CreateTrace("B"), {}, 1.0);
+  artifact.Save(path);
+
+  TuningArtifact loaded;
+  loaded.Load(path);
+  ASSERT_EQ(loaded.Size(), 1UL);
+  ir::proto::ScheduleDesc trace;
+  ASSERT_TRUE(loaded.Find(fingerprint, &trace));
+  EXPECT_EQ(trace.steps(0).attrs(0).s(), "B");
+  std::remove(path.c_str());
+}
+
+TEST(TuningArtifact, Apply) {
+  Context::Global().ResetNameId();
+  hlir::framework::GroupFingerprint fingerprint;
+  fingerprint.key       = "add_one";
+  fingerprint.var_names = {"A", "C"};
+  std::vector<ir::Expr> initial_exprs = LowerAddOne("A", "C", 32);
+  ir::IRSchedule ir_sch(ir::ModuleExpr(optim::IRCopy(initial_exprs)));
+  ir_sch.Split(ir_sch.GetLoops("C")[0], {4, 8});
+  TuningArtifact artifact;
+  artifact.Add(fingerprint, initial_exprs, ir_sch.GetTraceDesc().ToProto(), ir_sch.GetModule().GetExprs(), 1.0);
+
+  auto num_loops = [](const std::vector<ir::Expr>& exprs) {
+    return ir::CollectIRNodesWithoutTensor(exprs[0], [](const Expr* x) { return x->As<ir::For>(); }).size();
+  };
+  // the trace is replayed on the group with other names
+  hlir::framework::GroupFingerprint other = fingerprint;
+  other.var_names                         = {"X", "Y"};
+  std::vector<ir::Expr> scheduled_exprs;
+  ASSERT_TRUE(artifact.Apply(other, LowerAddOne("X", "Y", 32), &scheduled_exprs));
+  ASSERT_EQ(scheduled_exprs.size(), 1UL);
+  EXPECT_EQ(num_loops(scheduled_exprs), 2UL);
+  EXPECT_NE(utils::GetStreamCnt(scheduled_exprs[0]).find("Y["), std::string::npos);
+
+  // the trace isn't replayed on different IR with the same fingerprint, and the IR is kept unchanged
+  std::vector<ir::Expr> different_exprs = LowerAddOne("X", "Y", 30);
+  std::string different_ir              = utils::GetStreamCnt(different_exprs[0]);
+  EXPECT_FALSE(artifact.Apply(other, different_exprs, &scheduled_exprs));
+  EXPECT_EQ(utils::GetStreamCnt(different_exprs[0]), different_ir);
+  // nor with the schedule failing to reproduce the tuned IR
+  TuningArtifact stale_artifact;
+  stale_artifact.Add(fingerprint, initial_exprs, ir_sch.GetTraceDesc().ToProto(), initial_exprs, 1.0);
+  EXPECT_FALSE(stale_artifact.Apply(other, LowerAddOne("X", "Y", 32), &scheduled_exprs));
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -18,6 +18,7 @@
 
 #include "cinn/backends/llvm/runtime_symbol_registry.h"
 #include "cinn/common/context.h"
+#include "cinn/ir/ir_arena.h"
 #ifdef CINN_WITH_CUDA
 #include "cinn/backends/codegen_cuda_dev.h"
 #include "cinn/backends/codegen_cuda_host.h"
@@ -28,6 +29,8 @@
 #endif
 
 DECLARE_string(cinn_source_code_save_path);
+DECLARE_bool(cinn_enable_ir_arena);
+DECLARE_bool(cinn_ir_hash_consing);
 
 namespace cinn {
 namespace backends {
@@ -36,6 +39,7 @@ using ir::Module;
 static constexpr int DebugLogMaxLen = 30000;
 
 void Compiler::Build(const Module& module, const std::string& code) {
+  ir::IrArenaScope arena_scope(FLAGS_cinn_enable_ir_arena, FLAGS_cinn_ir_hash_consing);
   if (target_.arch == Target::Arch::NVGPU) {
     CompileCudaModule(module, code);
   } else if (target_.arch == Target::Arch::X86) {
@@ -119,7 +123,7 @@ void Compiler::CompileCudaModule(const Module& module, const std::string& code)
     symbols.RegisterVar(kernel_fn_name + "_ptr_", reinterpret_cast<void*>(fn_kernel));
   }
 
-  engine_ = ExecutionEngine::Create(ExecutionOptions(), std::move(symbols));
+  engine_ = ExecutionEngine::Create(options_, std::move(symbols));
   engine_->Link<CodeGenCUDA_Host>(host_module);
 
 #else
@@ -131,6 +135,8 @@ void Compiler::CompileX86Module(const Module& module) { engine_->Link<CodeGenX86
 
 void Compiler::ExportObject(const std::string& path) { engine_->ExportObject(path); }
 
+std::string Compiler::GetObject() const { return engine_->GetObject(); }
+
 void* Compiler::Lookup(absl::string_view fn_name) {
   CHECK(engine_);
   if (engine_->Lookup(fn_name) != nullptr) {
@@ -139,5 +145,10 @@ void* Compiler::Lookup(absl::string_view fn_name) {
   return nullptr;
 }
 
+std::vector<void*> Compiler::Lookup(const std::vector<std::string>& fn_names) {
+  CHECK(engine_);
+  return engine_->Lookup(fn_names);
+}
+
 }  // namespace backends
 }  // namespace cinn
@@ -18,6 +18,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "cinn/backends/llvm/codegen_llvm.h"
 #include "cinn/backends/llvm/execution_engine.h"
@@ -32,8 +33,8 @@ namespace backends {
 
 class Compiler final {
  public:
-  static std::unique_ptr<Compiler> Create(const Target& target) {
-    return std::unique_ptr<Compiler>(new Compiler(target));
+  static std::unique_ptr<Compiler> Create(const Target& target, const ExecutionOptions& options = ExecutionOptions()) {
+    return std::unique_ptr<Compiler>(new Compiler(target, options));
   }
 
   /**
@@ -43,6 +44,9 @@ class Compiler final {
 
   void ExportObject(const std::string& path);
 
+  //! Get the object code of the host module compiled eagerly.
+  std::string GetObject() const;
+
   std::string GetSourceCode(const ir::Module& module);
 
   void BuildDefault(const ir::Module& module);
@@ -53,17 +57,24 @@ class Compiler final {
    */
   void* Lookup(absl::string_view fn_name);
 
+  /**
+   * Retrieve the functions of \p fn_names at once, they are compiled concurrently if the engine has compile threads.
+   */
+  std::vector<void*> Lookup(const std::vector<std::string>& fn_names);
+
  private:
   void CompileCudaModule(const ir::Module& module, const std::string& code = "");
 
   void CompileX86Module(const ir::Module& module);
 
-  explicit Compiler(const Target& target) : target_(target), engine_(ExecutionEngine::Create(ExecutionOptions())) {}
+  Compiler(const Target& target, const ExecutionOptions& options)
+      : target_(target), options_(options), engine_(ExecutionEngine::Create(options)) {}
 
   CINN_DISALLOW_COPY_AND_ASSIGN(Compiler);
 
  private:
   Target target_;
+  ExecutionOptions options_;
   std::unique_ptr<ExecutionEngine> engine_;
 
 #ifdef CINN_WITH_CUDA
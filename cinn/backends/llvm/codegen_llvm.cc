@@ -263,11 +263,11 @@ llvm::Value *CodeGenLLVM::Visit(const ir::Mul *op) {
 }
 
 llvm::Value *CodeGenLLVM::Visit(const ir::Div *op) {
-  return EmitBinaryOp(Visit(&op->a()), Visit(&op->b()), '/', is_integral_type(op->type()));
+  return EmitBinaryOp(Visit(&op->a()), Visit(&op->b()), '/', is_integral_type(op->type()), !op->type().is_uint());
 }
 
 llvm::Value *CodeGenLLVM::Visit(const ir::Mod *op) {
-  return EmitBinaryOp(Visit(&op->a()), Visit(&op->b()), '%', is_integral_type(op->type()));
+  return EmitBinaryOp(Visit(&op->a()), Visit(&op->b()), '%', is_integral_type(op->type()), !op->type().is_uint());
 }
 
 #define __IR_EMITTER_DEFINE_CMP_VISITOR(__sop, __uop, __fop) \
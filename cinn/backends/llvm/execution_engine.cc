@@ -15,6 +15,7 @@
 #include "cinn/backends/llvm/execution_engine.h"
 
 #include <absl/strings/string_view.h>
+#include <gflags/gflags.h>
 #include <llvm/ADT/Triple.h>
 #include <llvm/AsmParser/Parser.h>
 #include <llvm/Config/llvm-config.h>
@@ -34,8 +35,11 @@
 #include <llvm/PassRegistry.h>
 #include <llvm/Passes/PassBuilder.h>
 #include <llvm/Support/Error.h>
+#include <llvm/Support/FileSystem.h>
 #include <llvm/Support/Host.h>
+#include <llvm/Support/MD5.h>
 #include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/Path.h>
 #include <llvm/Support/SourceMgr.h>
 #include <llvm/Support/TargetRegistry.h>
 #include <llvm/Support/TargetSelect.h>
@@ -48,11 +52,17 @@
 #include <llvm/Transforms/Scalar/Reassociate.h>
 #include <llvm/Transforms/Scalar/SimplifyCFG.h>
 
+#include <utime.h>
+
+#include <algorithm>
 #include <cmath>
 #include <memory>
 #include <mutex>  // NOLINT
+#include <sstream>
 #include <string>
+#include <tuple>
 #include <utility>
+#include <vector>
 
 #include "cinn/backends/codegen_cuda_host.h"
 #include "cinn/backends/llvm/cinn_runtime_llvm_ir.h"
@@ -63,6 +73,10 @@
 #include "cinn/backends/llvm/runtime_symbol_registry.h"
 #include "cinn/ir/ir_printer.h"
 #include "cinn/runtime/intrinsic.h"
+#include "cinn/utils/string.h"
+
+DECLARE_string(cinn_jit_object_cache_dir);
+DECLARE_int64(cinn_jit_object_cache_capacity_mb);
 
 namespace cinn::backends {
 namespace {
@@ -85,13 +99,69 @@ void InitializeLLVMPasses() {
   // llvm::initializeTarget(registry);
   // llvm::initializeCodeGenPreparePass(registry);
 }
+
+llvm::CodeGenOpt::Level GetCodeGenOptLevel(int opt_level) {
+  if (opt_level <= 0) {
+    return llvm::CodeGenOpt::None;
+  } else if (opt_level == 1) {
+    return llvm::CodeGenOpt::Less;
+  } else if (opt_level == 2) {
+    return llvm::CodeGenOpt::Default;
+  }
+  return llvm::CodeGenOpt::Aggressive;
+}
+
+// the builder of the machines for both the optimization and the code generation of the JIT
+llvm::orc::JITTargetMachineBuilder CreateTargetMachineBuilder(const ExecutionOptions &config) {
+  // the host CPU and all its features, such as AVX2 and AVX-512, are detected by default
+  auto builder = llvm::cantFail(llvm::orc::JITTargetMachineBuilder::detectHost());
+  if (!config.target_cpu.empty()) {
+    builder.setCPU(config.target_cpu);
+  }
+  if (!config.target_features.empty()) {
+    // the later features override the former ones with the same name
+    llvm::SmallVector<llvm::StringRef, 8> features;
+    llvm::StringRef(config.target_features).split(features, ',', -1, /*KeepEmpty=*/false);
+    builder.addFeatures(std::vector<std::string>(features.begin(), features.end()));
+  }
+  builder.setCodeGenOptLevel(GetCodeGenOptLevel(config.opt_level));
+  if (config.enable_fast_math) {
+    auto &options               = builder.getOptions();
+    options.UnsafeFPMath        = true;
+    options.NoInfsFPMath        = true;
+    options.NoNaNsFPMath        = true;
+    options.NoSignedZerosFPMath = true;
+    options.AllowFPOpFusion     = llvm::FPOpFusion::Fast;
+  }
+  return builder;
+}
 }  // namespace
+
+OptimizeOptions ExecutionOptions::GetOptimizeOptions() const {
+  OptimizeOptions options;
+  options.opt_level            = opt_level;
+  options.use_new_pass_manager = use_new_pass_manager;
+  options.enable_fast_math     = enable_fast_math;
+  options.loop_vectorize       = loop_vectorize;
+  options.slp_vectorize        = slp_vectorize;
+  return options;
+}
+
+std::string ExecutionOptions::ToString() const {
+  std::stringstream ss;
+  ss << GetOptimizeOptions().ToString() << (enable_debug_info ? "-g" : "") << "|" << target_cpu << "|"
+     << target_features;
+  return ss.str();
+}
+
 void NaiveObjectCache::notifyObjectCompiled(const llvm::Module *m, llvm::MemoryBufferRef obj_buffer) {
+  std::lock_guard<std::mutex> lock(mu_);
   cached_objects_[m->getModuleIdentifier()] =
       llvm::MemoryBuffer::getMemBufferCopy(obj_buffer.getBuffer(), obj_buffer.getBufferIdentifier());
 }
 
 std::unique_ptr<llvm::MemoryBuffer> NaiveObjectCache::getObject(const llvm::Module *m) {
+  std::lock_guard<std::mutex> lock(mu_);
   auto it = cached_objects_.find(m->getModuleIdentifier());
   if (it == cached_objects_.end()) {
     VLOG(1) << "No object for " << m->getModuleIdentifier() << " in cache. Compiling.";
@@ -102,6 +172,135 @@ std::unique_ptr<llvm::MemoryBuffer> NaiveObjectCache::getObject(const llvm::Modu
   return llvm::MemoryBuffer::getMemBuffer(it->second->getMemBufferRef());
 }
 
+namespace {
+// the prefix of the module identifiers and file names of the persisted objects
+constexpr char kObjectKeyPrefix[] = "cinn_obj_";
+}  // namespace
+
+DiskObjectCache::DiskObjectCache(const std::string &cache_dir, uint64_t capacity_bytes)
+    : cache_dir_(cache_dir), capacity_bytes_(capacity_bytes) {
+  if (auto ec = llvm::sys::fs::create_directories(cache_dir_)) {
+    LOG(WARNING) << "Failed to create the object cache directory " << cache_dir_ << ": " << ec.message();
+  }
+  // count the objects saved by the previous processes
+  ScanAndEvict();
+}
+
+std::string DiskObjectCache::ComputeKey(const llvm::Module &module,
+                                        const llvm::TargetMachine &machine,
+                                        const OptimizeOptions &options) {
+  std::string module_ir;
+  llvm::raw_string_ostream os(module_ir);
+  module.print(os, nullptr);
+  os.flush();
+
+  llvm::MD5 hash;
+  hash.update(LLVM_VERSION_STRING);
+  hash.update(machine.getTargetTriple().str());
+  hash.update(machine.getTargetCPU());
+  hash.update(machine.getTargetFeatureString());
+  hash.update(options.ToString());
+  hash.update(module_ir);
+  llvm::MD5::MD5Result result;
+  hash.final(result);
+  return kObjectKeyPrefix + result.digest().str().str();
+}
+
+std::string DiskObjectCache::ObjectPath(const std::string &key) const {
+  llvm::SmallString<128> path(cache_dir_);
+  llvm::sys::path::append(path, key + ".o");
+  return path.str().str();
+}
+
+std::unique_ptr<llvm::MemoryBuffer> DiskObjectCache::Load(const std::string &key) {
+  auto path   = ObjectPath(key);
+  auto buffer = llvm::MemoryBuffer::getFile(path);
+  if (!buffer) {
+    return nullptr;
+  }
+  // refresh the modification time to record the recent use for eviction
+  utime(path.c_str(), nullptr);
+  VLOG(3) << "Object " << key << " loaded from " << path;
+  return std::move(buffer.get());
+}
+
+void DiskObjectCache::notifyObjectCompiled(const llvm::Module *m, llvm::MemoryBufferRef obj_buffer) {
+  NaiveObjectCache::notifyObjectCompiled(m, obj_buffer);
+  const auto &key = m->getModuleIdentifier();
+  if (!llvm::StringRef(key).startswith(kObjectKeyPrefix)) {
+    return;
+  }
+
+  // write into a temporary file then rename it, so the concurrent readers never see a partial object
+  int fd;
+  llvm::SmallString<128> tmp_path;
+  if (auto ec = llvm::sys::fs::createUniqueFile(ObjectPath(key) + ".tmp%%%%%%", fd, tmp_path)) {
+    LOG(WARNING) << "Failed to create the object file of " << key << ": " << ec.message();
+    return;
+  }
+  {
+    llvm::raw_fd_ostream os(fd, /*shouldClose=*/true);
+    os << obj_buffer.getBuffer();
+  }
+  if (auto ec = llvm::sys::fs::rename(tmp_path, ObjectPath(key))) {
+    LOG(WARNING) << "Failed to save the object file of " << key << ": " << ec.message();
+    llvm::sys::fs::remove(tmp_path);
+    return;
+  }
+  VLOG(3) << "Object " << key << " saved to " << ObjectPath(key);
+  AddObjectBytes(obj_buffer.getBufferSize());
+}
+
+std::unique_ptr<llvm::MemoryBuffer> DiskObjectCache::getObject(const llvm::Module *m) {
+  if (auto object = NaiveObjectCache::getObject(m)) {
+    return object;
+  }
+  const auto &key = m->getModuleIdentifier();
+  if (!llvm::StringRef(key).startswith(kObjectKeyPrefix)) {
+    return nullptr;
+  }
+  return Load(key);
+}
+
+void DiskObjectCache::AddObjectBytes(uint64_t nbytes) {
+  std::lock_guard<std::mutex> lock(disk_mu_);
+  total_bytes_ += nbytes;
+  if (total_bytes_ > capacity_bytes_) {
+    ScanAndEvict();
+  }
+}
+
+void DiskObjectCache::ScanAndEvict() {
+  // (modification time, size, path) of every object file
+  std::vector<std::tuple<llvm::sys::TimePoint<>, uint64_t, std::string>> objects;
+  total_bytes_ = 0;
+  std::error_code ec;
+  for (llvm::sys::fs::directory_iterator it(cache_dir_, ec), end; it != end && !ec; it.increment(ec)) {
+    llvm::sys::fs::file_status status;
+    if (llvm::sys::path::extension(it->path()) != ".o" || llvm::sys::fs::status(it->path(), status)) {
+      continue;
+    }
+    objects.emplace_back(status.getLastModificationTime(), status.getSize(), it->path());
+    total_bytes_ += status.getSize();
+  }
+  if (total_bytes_ <= capacity_bytes_) {
+    return;
+  }
+
+  // evict to a quarter below the capacity, so the following objects don't scan the directory again at once
+  uint64_t target_bytes = capacity_bytes_ - capacity_bytes_ / 4;
+  std::sort(objects.begin(), objects.end());
+  for (const auto &object : objects) {
+    if (total_bytes_ <= target_bytes) {
+      break;
+    }
+    if (!llvm::sys::fs::remove(std::get<2>(object))) {
+      total_bytes_ -= std::get<1>(object);
+      VLOG(3) << "Evict object file " << std::get<2>(object);
+    }
+  }
+}
+
 /*static*/ std::unique_ptr<ExecutionEngine> ExecutionEngine::Create(const ExecutionOptions &config) {
   return Create(config, {});
 }
@@ -116,7 +315,15 @@ std::unique_ptr<llvm::MemoryBuffer> NaiveObjectCache::getObject(const llvm::Modu
   static std::once_flag flag;
   std::call_once(flag, InitializeLLVMPasses);
 
-  auto engine = std::make_unique<ExecutionEngine>(/*enable_object_cache=*/true, std::move(module_symbols));
+  auto engine      = std::make_unique<ExecutionEngine>(/*enable_object_cache=*/true, std::move(module_symbols));
+  engine->options_ = config;
+  std::string object_cache_dir =
+      config.object_cache_dir.empty() ? FLAGS_cinn_jit_object_cache_dir : config.object_cache_dir;
+  if (!object_cache_dir.empty()) {
+    VLOG(1) << "persist the compiled objects into " << object_cache_dir;
+    engine->cache_ = std::make_unique<DiskObjectCache>(
+        object_cache_dir, static_cast<uint64_t>(FLAGS_cinn_jit_object_cache_capacity_mb) << 20);
+  }
 
   auto compile_layer_creator = [&engine](llvm::orc::JITTargetMachineBuilder jtmb)
       -> llvm::Expected<std::unique_ptr<llvm::orc::IRCompileLayer::IRCompiler>> {
@@ -124,6 +331,11 @@ std::unique_ptr<llvm::MemoryBuffer> NaiveObjectCache::getObject(const llvm::Modu
     VLOG(1) << "create llvm compile layer";
     VLOG(1) << "Target Name: " << machine->getTarget().getName();
     VLOG(1) << "Target CPU: " << machine->getTargetCPU().str() << std::endl;
+    VLOG(1) << "Target Features: " << machine->getTargetFeatureString().str();
+    if (engine->options_.num_compile_threads > 0) {
+      // create a target machine for every module, so the modules can be compiled concurrently
+      return std::make_unique<llvm::orc::ConcurrentIRCompiler>(std::move(jtmb), engine->cache_.get());
+    }
     return std::make_unique<llvm::orc::TMOwningSimpleCompiler>(std::move(machine), engine->cache_.get());
   };
 
@@ -139,9 +351,24 @@ std::unique_ptr<llvm::MemoryBuffer> NaiveObjectCache::getObject(const llvm::Modu
 
   VLOG(2) << "create jit execution engine";
   engine->jit_ = llvm::cantFail(llvm::orc::LLJITBuilder()
+                                    .setJITTargetMachineBuilder(CreateTargetMachineBuilder(config))
                                     .setCompileFunctionCreator(compile_layer_creator)
                                     .setObjectLinkingLayerCreator(object_layer_creator)
+                                    .setNumCompileThreads(std::max(config.num_compile_threads, 0))
                                     .create());
+  if (config.num_compile_threads > 0) {
+    // the modules are optimized on the compile threads right before they are compiled
+    engine->jit_->getIRTransformLayer().setTransform(
+        [config](llvm::orc::ThreadSafeModule tsm,
+                 llvm::orc::MaterializationResponsibility &) -> llvm::Expected<llvm::orc::ThreadSafeModule> {
+          tsm.withModuleDo([&config](llvm::Module &m) {
+            auto machine = llvm::cantFail(CreateTargetMachineBuilder(config).createTargetMachine());
+            LLVMModuleOptimizer optimize(machine.get(), config.GetOptimizeOptions());
+            optimize(&m);
+          });
+          return std::move(tsm);
+        });
+  }
   engine->jit_->getMainJITDylib().addGenerator(llvm::cantFail(
       llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(engine->jit_->getDataLayout().getGlobalPrefix())));
 
@@ -153,21 +380,83 @@ std::unique_ptr<llvm::MemoryBuffer> NaiveObjectCache::getObject(const llvm::Modu
   return engine;
 }
 
+namespace {
+// if \p internalize_runtime is true, the definitions of the runtime are private to the module, so the modules
+// added to one JITDylib separately don't define the runtime symbols repeatedly
 template <typename CodeGenT>
-void ExecutionEngine::Link(const ir::Module &module) {
+std::unique_ptr<llvm::Module> EmitLLVMModule(const ir::Module &module,
+                                             llvm::LLVMContext *ctx,
+                                             bool internalize_runtime = false) {
   llvm::SMDiagnostic error;
-  auto ctx        = std::make_unique<llvm::LLVMContext>();
-  auto m          = llvm::parseAssemblyString(AsStringRef(backends::kRuntimeLlvmIr), error, *ctx);
+  auto m = llvm::parseAssemblyString(AsStringRef(backends::kRuntimeLlvmIr), error, *ctx);
+  std::vector<llvm::GlobalValue *> runtime_definitions;
+  for (auto &value : m->global_values()) {
+    // the appending globals, such as llvm.global_ctors, are special and can't be internal
+    if (!value.isDeclaration() && !value.hasLocalLinkage() && !value.hasAppendingLinkage()) {
+      runtime_definitions.push_back(&value);
+    }
+  }
+
   auto b          = std::make_unique<llvm::IRBuilder<>>(*ctx);
   auto ir_emitter = std::make_unique<CodeGenT>(m.get(), b.get());
   VLOG(3) << "ir_emitter->Compile(module) Begin";
   ir_emitter->Compile(module);
   VLOG(3) << "ir_emitter->Compile(module) Succeed!";
+  if (internalize_runtime) {
+    for (auto *value : runtime_definitions) {
+      value->setLinkage(llvm::GlobalValue::InternalLinkage);
+    }
+  }
   CHECK(!llvm::verifyModule(*m, &llvm::errs())) << "Invalid module found";
+  return m;
+}
+}  // namespace
+
+template <typename CodeGenT>
+void ExecutionEngine::Link(const ir::Module &module) {
+  if (options_.num_compile_threads > 0) {
+    // every function is emitted into a separate module, which is optimized and compiled on the compile threads when
+    // it is looked up for the first time, so the functions looked up together are compiled concurrently
+    for (auto &fn : module.functions()) {
+      ir::Module::Builder builder(module.name() + "_" + fn->name, module.target());
+      builder.AddFunction(fn);
+      auto ctx = std::make_unique<llvm::LLVMContext>();
+      auto m   = EmitLLVMModule<CodeGenT>(builder.Build(), ctx.get(), /*internalize_runtime=*/true);
+      // the objects are cached by the module identifiers, which should be unique
+      m->setModuleIdentifier(module.name() + "_" + fn->name);
+      if (auto *disk_cache = dynamic_cast<DiskObjectCache *>(cache_.get())) {
+        auto machine = llvm::cantFail(CreateTargetMachineBuilder(options_).createTargetMachine());
+        auto key     = DiskObjectCache::ComputeKey(*m, *machine, options_.GetOptimizeOptions());
+        m->setModuleIdentifier(key);
+        if (auto object = disk_cache->Load(key)) {
+          llvm::cantFail(jit_->addObjectFile(std::move(object)));
+          continue;
+        }
+      }
+      CHECK(AddModule(std::move(m), std::move(ctx)));
+    }
+    return;
+  }
+
+  auto ctx = std::make_unique<llvm::LLVMContext>();
+  auto m   = EmitLLVMModule<CodeGenT>(module, ctx.get());
+
+  auto machine          = llvm::cantFail(CreateTargetMachineBuilder(options_).createTargetMachine());
+  auto optimize_options = options_.GetOptimizeOptions();
+  // the object compiled from the same module on the same machine can be reused, which skips both the
+  // optimization and code generation
+  if (auto *disk_cache = dynamic_cast<DiskObjectCache *>(cache_.get())) {
+    auto key = DiskObjectCache::ComputeKey(*m, *machine, optimize_options);
+    m->setModuleIdentifier(key);
+    if (auto object = disk_cache->Load(key)) {
+      buffer_.assign(object->getBufferStart(), object->getBufferEnd());
+      llvm::cantFail(jit_->addObjectFile(std::move(object)));
+      return;
+    }
+  }
 
-  auto machine =
-      std::move(llvm::cantFail(llvm::cantFail(llvm::orc::JITTargetMachineBuilder::detectHost()).createTargetMachine()));
-  LLVMModuleOptimizer optimize(machine.get(), 3, {}, true);
+  optimize_options.print_passes = true;
+  LLVMModuleOptimizer optimize(machine.get(), optimize_options);
   optimize(m.get());
   CHECK(!llvm::verifyModule(*m, &llvm::errs())) << "Invalid optimized module detected";
   for (auto &f : *m) {
@@ -210,13 +499,28 @@ bool ExecutionEngine::AddModule(std::unique_ptr<llvm::Module> module, std::uniqu
 }
 
 void ExecutionEngine::ExportObject(const std::string &path) {
+  CHECK_LE(options_.num_compile_threads, 0) << "The object can't be exported when the modules are compiled lazily";
   FILE *of = fopen(path.c_str(), "w");
   fwrite(buffer_.data(), 1, buffer_.size(), of);
   fclose(of);
 }
 
-void *ExecutionEngine::Lookup(absl::string_view name) {
+std::string ExecutionEngine::GetObject() const {
+  CHECK_LE(options_.num_compile_threads, 0) << "The object can't be got when the modules are compiled lazily";
+  return std::string(buffer_.data(), buffer_.size());
+}
+
+void ExecutionEngine::AddObject(const std::string &object) {
   std::lock_guard<std::mutex> lock(mu_);
+  llvm::cantFail(jit_->addObjectFile(llvm::MemoryBuffer::getMemBufferCopy(object)));
+}
+
+void *ExecutionEngine::Lookup(absl::string_view name) {
+  // the compiler owns a single target machine if there is no compile thread, which can't compile concurrently
+  std::unique_lock<std::mutex> lock(mu_, std::defer_lock);
+  if (options_.num_compile_threads <= 0) {
+    lock.lock();
+  }
   if (auto symbol = jit_->lookup(AsStringRef(name))) {
     return reinterpret_cast<void *>(symbol->getAddress());
   }
@@ -225,6 +529,34 @@ void *ExecutionEngine::Lookup(absl::string_view name) {
   return nullptr;
 }
 
+std::vector<void *> ExecutionEngine::Lookup(const std::vector<std::string> &names) {
+  std::vector<void *> addresses;
+  if (options_.num_compile_threads <= 0) {
+    for (const auto &name : names) {
+      addresses.push_back(Lookup(name));
+    }
+    return addresses;
+  }
+
+  // dispatch the materialization of all the symbols at once
+  llvm::orc::SymbolLookupSet symbols;
+  for (const auto &name : names) {
+    symbols.add(jit_->mangleAndIntern(name));
+  }
+  auto result = jit_->getExecutionSession().lookup(
+      llvm::orc::makeJITDylibSearchOrder(&jit_->getMainJITDylib(), llvm::orc::JITDylibLookupFlags::MatchAllSymbols),
+      symbols);
+  if (!result) {
+    LOG(ERROR) << "Failed to look up symbols [" << utils::Join(names, ", ")
+               << "]: " << llvm::toString(result.takeError());
+    return std::vector<void *>(names.size(), nullptr);
+  }
+  for (const auto &name : names) {
+    addresses.push_back(reinterpret_cast<void *>((*result)[jit_->mangleAndIntern(name)].getAddress()));
+  }
+  return addresses;
+}
+
 void ExecutionEngine::RegisterRuntimeSymbols() {
   const auto &registry = GlobalSymbolRegistry::Global();
   auto *session        = &jit_->getExecutionSession();
@@ -35,6 +35,7 @@
 #include <llvm/Support/SmallVectorMemoryBuffer.h>
 #include <llvm/Support/TargetSelect.h>
 #include <llvm/Support/raw_ostream.h>
+#include <llvm/Target/TargetMachine.h>
 
 #include <functional>
 #include <memory>
@@ -44,6 +45,7 @@
 #include <vector>
 
 #include "cinn/backends/llvm/codegen_x86.h"
+#include "cinn/backends/llvm/llvm_optimizer.h"
 #include "cinn/backends/llvm/llvm_util.h"
 #include "cinn/backends/llvm/runtime_symbol_registry.h"
 #include "cinn/ir/module.h"
@@ -56,15 +58,72 @@ class NaiveObjectCache : public llvm::ObjectCache {
   std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module *) override;
 
  private:
+  // the modules may be compiled concurrently
+  std::mutex mu_;
   llvm::StringMap<std::unique_ptr<llvm::MemoryBuffer>> cached_objects_;
 };
 
+/**
+ * An object cache persisting the compiled objects into a directory, so that they can be reused across processes.
+ *
+ * Only the modules whose identifiers are generated by ComputeKey are persisted, the key is a hash of the module IR,
+ * target triple, CPU name, CPU features and optimization level. The least recently used objects are evicted once the
+ * total size of the directory exceeds the capacity. The size is scanned once on construction and then tracked in
+ * memory, the directory is only scanned again to evict.
+ */
+class DiskObjectCache : public NaiveObjectCache {
+ public:
+  DiskObjectCache(const std::string &cache_dir, uint64_t capacity_bytes);
+
+  void notifyObjectCompiled(const llvm::Module *, llvm::MemoryBufferRef) override;
+  std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module *) override;
+
+  //! Load the object of \p key from the directory, return null if not exists.
+  std::unique_ptr<llvm::MemoryBuffer> Load(const std::string &key);
+
+  //! Compute the key of a module to be compiled by \p machine with the optimization options \p options.
+  static std::string ComputeKey(const llvm::Module &module,
+                                const llvm::TargetMachine &machine,
+                                const OptimizeOptions &options);
+
+ private:
+  std::string ObjectPath(const std::string &key) const;
+  // add the size of a newly saved object and evict the objects if the capacity is exceeded
+  void AddObjectBytes(uint64_t nbytes);
+  // recount the object files in the directory and evict the least recently used ones if the capacity is exceeded
+  void ScanAndEvict();
+
+  std::string cache_dir_;
+  uint64_t capacity_bytes_;
+
+  // the objects may be saved concurrently
+  std::mutex disk_mu_;
+  // the total size of the object files in the directory, including the ones saved by other processes when it was
+  // scanned last time
+  uint64_t total_bytes_{0};
+};
+
 struct ExecutionOptions {
   int opt_level{3};
   bool enable_debug_info{false};
-  // TODO(fc500110)
-  // int num_compile_threads{1};
-  // bool enable_fast_math;
+  // the directory to persist the compiled objects, empty means using FLAGS_cinn_jit_object_cache_dir
+  std::string object_cache_dir;
+  bool use_new_pass_manager{false};
+  bool enable_fast_math{false};
+  bool loop_vectorize{true};
+  bool slp_vectorize{true};
+  // the CPU to generate code for, empty means the host CPU
+  std::string target_cpu;
+  // the features to enable or disable on top of the ones detected on the host, such as "+avx2,-avx512f"
+  std::string target_features;
+  // the number of threads to optimize and compile the modules concurrently, 0 means compiling eagerly on Link.
+  // if it is positive, every function is materialized lazily when it is looked up for the first time
+  int num_compile_threads{0};
+
+  OptimizeOptions GetOptimizeOptions() const;
+
+  // the options affecting the generated code, used to identify the compiled kernels
+  std::string ToString() const;
 };
 
 class ExecutionEngine {
@@ -75,11 +134,21 @@ class ExecutionEngine {
 
   void *Lookup(absl::string_view name);
 
+  //! Look up the functions in one batch, which are materialized concurrently if there are compile threads.
+  std::vector<void *> Lookup(const std::vector<std::string> &names);
+
   template <typename CodeGenT = CodeGenLLVM>
   void Link(const ir::Module &module);
 
+  //! Export the object compiled eagerly, not supported if there are compile threads.
   void ExportObject(const std::string &path);
 
+  //! Get the object compiled eagerly, not supported if there are compile threads.
+  std::string GetObject() const;
+
+  //! Add an object compiled by an engine with the same options, such as the one got by GetObject in another process.
+  void AddObject(const std::string &object);
+
   bool AddModule(std::unique_ptr<llvm::Module> module, std::unique_ptr<llvm::LLVMContext> context);
 
  protected:
@@ -99,6 +168,7 @@ class ExecutionEngine {
   std::unique_ptr<llvm::orc::LLJIT> jit_;
   std::unique_ptr<NaiveObjectCache> cache_;
   RuntimeSymbols module_symbols_;
+  ExecutionOptions options_;
 };
 
 }  // namespace cinn::backends
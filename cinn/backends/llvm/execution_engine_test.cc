@@ -21,13 +21,17 @@
 #include <llvm/IR/Argument.h>
 #include <llvm/IR/BasicBlock.h>
 #include <llvm/IR/Function.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
 #include <llvm/IRReader/IRReader.h>
 #include <llvm/Support/FileSystem.h>
 #include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/Process.h>
 #include <llvm/Support/SourceMgr.h>
 #include <llvm/Support/raw_ostream.h>
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <iomanip>
 #include <memory>
@@ -147,6 +151,220 @@ TEST(llvm_test01, elementwise_add) {
   }
 }
 
+namespace {
+// a temporary directory removed with all its contents on destruction
+struct TempDirectory {
+  explicit TempDirectory(const std::string &prefix) {
+    CHECK(!llvm::sys::fs::createUniqueDirectory(prefix, path)) << "Failed to create the directory " << prefix;
+  }
+  ~TempDirectory() { llvm::sys::fs::remove_directories(path); }
+
+  llvm::SmallString<128> path;
+};
+}  // namespace
+
+TEST(ExecutionEngine, disk_object_cache) {
+  TempDirectory cache_dir("cinn_object_cache");
+  ExecutionOptions options;
+  options.object_cache_dir = cache_dir.path.str().str();
+
+  auto module = CreateTestCinnModule();
+  auto list_objects = [&cache_dir]() {
+    std::vector<std::string> objects;
+    std::error_code ec;
+    for (llvm::sys::fs::directory_iterator it(cache_dir.path, ec), end; it != end && !ec; it.increment(ec)) {
+      objects.push_back(it->path());
+    }
+    return objects;
+  };
+
+  // the first engine compiles the module and saves the object when it is materialized
+  auto engine1 = backends::ExecutionEngine::Create(options);
+  engine1->Link<CodeGenX86>(module);
+  ASSERT_NE(engine1->Lookup("elementwise_add"), nullptr);
+  auto objects = list_objects();
+  ASSERT_EQ(objects.size(), 1);
+
+  // set the object to an old modification time, which is refreshed only when the object is loaded
+  const auto &object_path = objects.front();
+  auto old_time           = std::chrono::system_clock::now() - std::chrono::hours(24);
+  {
+    int fd;
+    ASSERT_FALSE(llvm::sys::fs::openFileForWrite(object_path, fd, llvm::sys::fs::CD_OpenExisting));
+    ASSERT_FALSE(llvm::sys::fs::setLastAccessAndModificationTime(fd, old_time));
+    llvm::sys::Process::SafelyCloseFileDescriptor(fd);
+  }
+
+  // the second engine loads the object from the directory instead of compiling the module again
+  auto engine2 = backends::ExecutionEngine::Create(options);
+  engine2->Link<CodeGenX86>(module);
+  auto elementwise_add = reinterpret_cast<void (*)(void *, int32_t)>(engine2->Lookup("elementwise_add"));
+  ASSERT_NE(elementwise_add, nullptr);
+  ASSERT_EQ(list_objects().size(), 1);
+  llvm::sys::fs::file_status status;
+  ASSERT_FALSE(llvm::sys::fs::status(object_path, status));
+  EXPECT_GT(status.getLastModificationTime(), old_time + std::chrono::hours(1));
+
+  auto _a_b_c_ = CreateTestBuffer();  // NOLINT
+  auto &a      = std::get<0>(_a_b_c_);
+  auto &b      = std::get<1>(_a_b_c_);
+  auto &c      = std::get<2>(_a_b_c_);
+  cinn_pod_value_t a_arg(a), b_arg(b), c_arg(c);
+  cinn_pod_value_t args[3] = {a_arg, b_arg, c_arg};
+  elementwise_add(args, 3);
+
+  float *ad = reinterpret_cast<float *>(a->memory);
+  float *bd = reinterpret_cast<float *>(b->memory);
+  float *cd = reinterpret_cast<float *>(c->memory);
+  for (int i = 0; i < c->num_elements(); i++) {
+    EXPECT_EQ(ad[i] + bd[i], cd[i]);
+  }
+}
+
+TEST(DiskObjectCache, evict_least_recently_used) {
+  TempDirectory cache_dir("cinn_object_cache");
+  const std::string dir = cache_dir.path.str().str();
+  llvm::LLVMContext context;
+  const std::string object(1000, 'x');
+  auto object_path = [&dir](const std::string &key) { return dir + "/" + key + ".o"; };
+  auto save        = [&](DiskObjectCache *cache, const std::string &key, int hours_ago) {
+    llvm::Module module(key, context);
+    cache->notifyObjectCompiled(&module, llvm::MemoryBufferRef(object, key));
+    int fd;
+    ASSERT_FALSE(llvm::sys::fs::openFileForWrite(object_path(key), fd, llvm::sys::fs::CD_OpenExisting));
+    ASSERT_FALSE(llvm::sys::fs::setLastAccessAndModificationTime(
+        fd, std::chrono::system_clock::now() - std::chrono::hours(hours_ago)));
+    llvm::sys::Process::SafelyCloseFileDescriptor(fd);
+  };
+
+  {
+    DiskObjectCache cache(dir, 4000);
+    save(&cache, "cinn_obj_0", 3);
+    save(&cache, "cinn_obj_1", 2);
+    save(&cache, "cinn_obj_2", 1);
+  }
+  ASSERT_TRUE(llvm::sys::fs::exists(object_path("cinn_obj_0")));
+
+  // a new cache counts the objects saved before, the fourth object exceeds the capacity and
+  // the least recently used ones are evicted until the directory is a quarter below the capacity
+  DiskObjectCache cache(dir, 3500);
+  ASSERT_TRUE(llvm::sys::fs::exists(object_path("cinn_obj_0")));
+  save(&cache, "cinn_obj_3", 0);
+  EXPECT_FALSE(llvm::sys::fs::exists(object_path("cinn_obj_0")));
+  EXPECT_FALSE(llvm::sys::fs::exists(object_path("cinn_obj_1")));
+  EXPECT_TRUE(llvm::sys::fs::exists(object_path("cinn_obj_2")));
+  EXPECT_TRUE(llvm::sys::fs::exists(object_path("cinn_obj_3")));
+}
+
+TEST(ExecutionEngine, optimize_options) {
+  auto module = CreateTestCinnModule();
+
+  std::vector<ExecutionOptions> all_options(3);
+  all_options[0].enable_fast_math     = true;
+  all_options[0].target_features      = "-avx512f";
+  all_options[1].opt_level            = 2;
+  all_options[1].loop_vectorize       = false;
+  all_options[1].slp_vectorize        = false;
+  all_options[2].use_new_pass_manager = true;
+
+  for (auto &options : all_options) {
+    auto engine = backends::ExecutionEngine::Create(options);
+    engine->Link<CodeGenX86>(module);
+    auto elementwise_add = reinterpret_cast<void (*)(void *, int32_t)>(engine->Lookup("elementwise_add"));
+    ASSERT_NE(elementwise_add, nullptr);
+
+    auto _a_b_c_ = CreateTestBuffer();  // NOLINT
+    auto &a      = std::get<0>(_a_b_c_);
+    auto &b      = std::get<1>(_a_b_c_);
+    auto &c      = std::get<2>(_a_b_c_);
+    cinn_pod_value_t a_arg(a), b_arg(b), c_arg(c);
+    cinn_pod_value_t args[3] = {a_arg, b_arg, c_arg};
+    elementwise_add(args, 3);
+
+    float *ad = reinterpret_cast<float *>(a->memory);
+    float *bd = reinterpret_cast<float *>(b->memory);
+    float *cd = reinterpret_cast<float *>(c->memory);
+    for (int i = 0; i < c->num_elements(); i++) {
+      EXPECT_EQ(ad[i] + bd[i], cd[i]);
+    }
+  }
+}
+
+TEST(ExecutionEngine, concurrent_compile) {
+  ExecutionOptions options;
+  options.num_compile_threads = 2;
+  auto engine                 = backends::ExecutionEngine::Create(options);
+  engine->Link<CodeGenX86>(CreateTestCinnModule());
+
+  // the function is compiled on the compile threads when it is looked up
+  auto fn_ptrs = engine->Lookup(std::vector<std::string>({"elementwise_add"}));
+  ASSERT_EQ(fn_ptrs.size(), 1);
+  auto elementwise_add = reinterpret_cast<void (*)(void *, int32_t)>(fn_ptrs[0]);
+  ASSERT_NE(elementwise_add, nullptr);
+
+  auto _a_b_c_ = CreateTestBuffer();  // NOLINT
+  auto &a      = std::get<0>(_a_b_c_);
+  auto &b      = std::get<1>(_a_b_c_);
+  auto &c      = std::get<2>(_a_b_c_);
+  cinn_pod_value_t a_arg(a), b_arg(b), c_arg(c);
+  cinn_pod_value_t args[3] = {a_arg, b_arg, c_arg};
+  elementwise_add(args, 3);
+
+  float *ad = reinterpret_cast<float *>(a->memory);
+  float *bd = reinterpret_cast<float *>(b->memory);
+  float *cd = reinterpret_cast<float *>(c->memory);
+  for (int i = 0; i < c->num_elements(); i++) {
+    EXPECT_EQ(ad[i] + bd[i], cd[i]);
+  }
+}
+
+TEST(ExecutionEngine, concurrent_compile_multiple_functions) {
+  ir::Expr M(kM);
+  ir::Expr N(kN);
+  lang::Placeholder<float> A("A", {M, N});
+  lang::Placeholder<float> B("B", {M, N});
+  auto C = lang::Compute(
+      {M, N}, [&](Var i, Var j) { return A(i, j) + B(i, j); }, "C");
+  auto D = lang::Compute(
+      {M, N}, [&](Var i, Var j) { return A(i, j) * B(i, j); }, "D");
+  lang::Buffer C_buf(Float(32)), D_buf(Float(32));
+  C->Bind(C_buf);
+  D->Bind(D_buf);
+
+  // every function is emitted into its own module along with the runtime, which must not be defined repeatedly
+  ir::Module::Builder builder("module_multiple_functions", common::DefaultHostTarget());
+  auto add_func = lang::Lower("elementwise_add", CreateStages({C}), {A, B, C});
+  auto mul_func = lang::Lower("elementwise_mul", CreateStages({D}), {A, B, D});
+  builder.AddFunction(ir::LoweredFunc(add_func.As<ir::_LoweredFunc_>()));
+  builder.AddFunction(ir::LoweredFunc(mul_func.As<ir::_LoweredFunc_>()));
+
+  ExecutionOptions options;
+  options.num_compile_threads = 2;
+  auto engine                 = backends::ExecutionEngine::Create(options);
+  engine->Link<CodeGenX86>(builder.Build());
+  auto fn_ptrs = engine->Lookup(std::vector<std::string>({"elementwise_add", "elementwise_mul"}));
+  ASSERT_EQ(fn_ptrs.size(), 2);
+  ASSERT_NE(fn_ptrs[0], nullptr);
+  ASSERT_NE(fn_ptrs[1], nullptr);
+
+  for (int k = 0; k < 2; ++k) {
+    auto _a_b_c_ = CreateTestBuffer();  // NOLINT
+    auto &a      = std::get<0>(_a_b_c_);
+    auto &b      = std::get<1>(_a_b_c_);
+    auto &c      = std::get<2>(_a_b_c_);
+    cinn_pod_value_t a_arg(a), b_arg(b), c_arg(c);
+    cinn_pod_value_t args[3] = {a_arg, b_arg, c_arg};
+    reinterpret_cast<void (*)(void *, int32_t)>(fn_ptrs[k])(args, 3);
+
+    float *ad = reinterpret_cast<float *>(a->memory);
+    float *bd = reinterpret_cast<float *>(b->memory);
+    float *cd = reinterpret_cast<float *>(c->memory);
+    for (int i = 0; i < c->num_elements(); i++) {
+      EXPECT_EQ(k == 0 ? ad[i] + bd[i] : ad[i] * bd[i], cd[i]);
+    }
+  }
+}
+
 TEST(llvm, module_call_lowered_func) {
   ir::Module::Builder builder("some_module", common::DefaultHostTarget());
   ir::Expr M(kM);
@@ -31,6 +31,8 @@
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/LegacyPassManager.h>
 #include <llvm/IR/Module.h>
+#include <llvm/IR/Operator.h>
+#include <llvm/IR/PassInstrumentation.h>
 #include <llvm/IR/PassManager.h>
 #include <llvm/IRReader/IRReader.h>
 #include <llvm/Passes/PassBuilder.h>
@@ -55,6 +57,7 @@
 
 #include <algorithm>
 #include <memory>
+#include <sstream>
 #include <string>
 #include <type_traits>
 #include <utility>
@@ -115,43 +118,122 @@ using CustomFunctionPassManager = CustomPassManager<llvm::legacy::FunctionPassMa
 using CustomModulePassManager   = CustomPassManager<llvm::legacy::PassManager>;
 }  // namespace
 
-LLVMModuleOptimizer::LLVMModuleOptimizer(llvm::TargetMachine *machine,
-                                         int opt_level,
-                                         llvm::FastMathFlags fast_math_flags,
-                                         bool print_passes)
-    : opt_level_(opt_level), print_passes_(print_passes), machine_(machine) {}
+std::string OptimizeOptions::ToString() const {
+  std::stringstream ss;
+  ss << "O" << opt_level << (use_new_pass_manager ? "-newpm" : "-legacypm") << (enable_fast_math ? "-fastmath" : "")
+     << (loop_vectorize ? "-loopvec" : "") << (slp_vectorize ? "-slpvec" : "");
+  return ss.str();
+}
+
+void ApplyFastMathFlags(llvm::Module *m) {
+  for (auto &fn : *m) {
+    if (fn.isDeclaration()) {
+      continue;
+    }
+    // the function attributes are used by the code generator
+    for (const char *attr :
+         {"unsafe-fp-math", "no-infs-fp-math", "no-nans-fp-math", "no-signed-zeros-fp-math", "approx-func-fp-math"}) {
+      fn.addFnAttr(attr, "true");
+    }
+    // the instruction flags are used by the IR passes, such as vectorizing the floating-point reductions
+    for (auto &block : fn) {
+      for (auto &inst : block) {
+        if (llvm::isa<llvm::FPMathOperator>(&inst)) {
+          inst.setFast(true);
+        }
+      }
+    }
+  }
+}
+
+LLVMModuleOptimizer::LLVMModuleOptimizer(llvm::TargetMachine *machine, const OptimizeOptions &options)
+    : machine_(machine), options_(options) {
+  CHECK(machine_) << "The target machine of LLVMModuleOptimizer should not be null";
+}
 
 void LLVMModuleOptimizer::operator()(llvm::Module *m) {
-  auto machine =
-      std::move(llvm::cantFail(llvm::cantFail(llvm::orc::JITTargetMachineBuilder::detectHost()).createTargetMachine()));
-  auto fpm = std::make_unique<CustomFunctionPassManager>(print_passes_, m);
-  // fpm->add(llvm::createTargetTransformInfoWrapperPass(llvm::TargetIRAnalysis()));
-  // fpm->add(llvm::createInstructionCombiningPass());
-  // fpm->add(llvm::createReassociatePass());
-  // fpm->add(llvm::createGVNPass());
-  // fpm->add(llvm::createCFGSimplificationPass());
-  // fpm->add(llvm::createSROAPass());
-  // fpm->add(llvm::createEarlyCSEPass());
-  // fpm->add(llvm::createLowerExpectIntrinsicPass());
-  // fpm->add(llvm::createCallSiteSplittingPass());
-  // fpm->add(llvm::createLoopVectorizePass());
-  // fpm->add(llvm::createSLPVectorizerPass());
-  // fpm->add(llvm::createLoadStoreVectorizerPass());
-  // fpm->add(llvm::createLoopUnrollPass());
-
-  auto mpm = std::make_unique<CustomModulePassManager>(print_passes_);
-  // mpm->add(llvm::createTargetTransformInfoWrapperPass(llvm::TargetIRAnalysis()));
-  // LOG(INFO) << "llvm run pass: target machine: name[" << machine_->getTarget().getName() << "]";
-  // LOG(INFO) << "llvm run pass: target machine: cpu[" << machine_->getTargetCPU().str() << "]";
-  fpm->add(llvm::createTargetTransformInfoWrapperPass(machine->getTargetIRAnalysis()));
-  mpm->add(llvm::createTargetTransformInfoWrapperPass(machine->getTargetIRAnalysis()));
+  if (options_.enable_fast_math) {
+    ApplyFastMathFlags(m);
+  }
+  if (options_.use_new_pass_manager) {
+    RunNewPassManager(m);
+  } else {
+    RunLegacyPassManager(m);
+  }
+}
+
+void LLVMModuleOptimizer::RunNewPassManager(llvm::Module *m) {
+#if LLVM_VERSION_MAJOR >= 14
+  using OptimizationLevel = llvm::OptimizationLevel;
+#else
+  using OptimizationLevel = llvm::PassBuilder::OptimizationLevel;
+#endif
+  if (options_.opt_level <= 0) {
+    return;
+  }
+
+  llvm::PipelineTuningOptions tuning_options;
+  tuning_options.LoopVectorization = options_.loop_vectorize;
+  tuning_options.SLPVectorization  = options_.slp_vectorize;
+  tuning_options.LoopUnrolling     = true;
+
+  llvm::PassInstrumentationCallbacks callbacks;
+  if (options_.print_passes) {
+#if LLVM_VERSION_MAJOR >= 12
+    callbacks.registerBeforeNonSkippedPassCallback(
+        [](llvm::StringRef pass, llvm::Any) { VLOG(1) << "llvm run pass[" << pass.str() << "]"; });
+#else
+    callbacks.registerBeforePassCallback([](llvm::StringRef pass, llvm::Any) {
+      VLOG(1) << "llvm run pass[" << pass.str() << "]";
+      return true;
+    });
+#endif
+  }
+#if LLVM_VERSION_MAJOR == 12
+  llvm::PassBuilder builder(/*DebugLogging=*/false, machine_, tuning_options, llvm::None, &callbacks);
+#else
+  llvm::PassBuilder builder(machine_, tuning_options, llvm::None, &callbacks);
+#endif
+  // the target specific passes, which are added by adjustPassManager in the legacy pass manager
+#if LLVM_VERSION_MAJOR == 12
+  machine_->registerPassBuilderCallbacks(builder, /*DebugPassManager=*/false);
+#else
+  machine_->registerPassBuilderCallbacks(builder);
+#endif
+
+  llvm::LoopAnalysisManager lam;
+  llvm::FunctionAnalysisManager fam;
+  llvm::CGSCCAnalysisManager cgam;
+  llvm::ModuleAnalysisManager mam;
+  // the target transform info of the machine is registered along with the function analyses
+  builder.registerModuleAnalyses(mam);
+  builder.registerCGSCCAnalyses(cgam);
+  builder.registerFunctionAnalyses(fam);
+  builder.registerLoopAnalyses(lam);
+  builder.crossRegisterProxies(lam, fam, cgam, mam);
+
+  OptimizationLevel level = OptimizationLevel::O3;
+  if (options_.opt_level == 1) {
+    level = OptimizationLevel::O1;
+  } else if (options_.opt_level == 2) {
+    level = OptimizationLevel::O2;
+  }
+  auto mpm = builder.buildPerModuleDefaultPipeline(level);
+  mpm.run(*m, mam);
+}
+
+void LLVMModuleOptimizer::RunLegacyPassManager(llvm::Module *m) {
+  auto fpm = std::make_unique<CustomFunctionPassManager>(options_.print_passes, m);
+  auto mpm = std::make_unique<CustomModulePassManager>(options_.print_passes);
+  fpm->add(llvm::createTargetTransformInfoWrapperPass(machine_->getTargetIRAnalysis()));
+  mpm->add(llvm::createTargetTransformInfoWrapperPass(machine_->getTargetIRAnalysis()));
   auto builder           = std::make_unique<llvm::PassManagerBuilder>();
-  builder->OptLevel      = opt_level_;
+  builder->OptLevel      = options_.opt_level;
   builder->Inliner       = llvm::createFunctionInliningPass();
-  builder->LoopVectorize = true;
-  builder->SLPVectorize  = true;
+  builder->LoopVectorize = options_.loop_vectorize;
+  builder->SLPVectorize  = options_.slp_vectorize;
 #if LLVM_VERSION_MAJOR >= 11
-  machine->adjustPassManager(*builder);
+  machine_->adjustPassManager(*builder);
 #endif
   builder->populateFunctionPassManager(*fpm);
   builder->populateModulePassManager(*mpm);
@@ -21,23 +21,38 @@
 #include <llvm/Target/TargetMachine.h>
 
 #include <functional>
+#include <string>
 
 namespace cinn::backends {
 
-// TODO(fc500110): define class OptimizeOptions
+struct OptimizeOptions {
+  int opt_level{3};
+  // run the default pipeline with the new pass manager, otherwise with the legacy one
+  bool use_new_pass_manager{false};
+  // allow the optimizations breaking the strict IEEE semantics, such as reassociating the floating-point reductions
+  bool enable_fast_math{false};
+  bool loop_vectorize{true};
+  bool slp_vectorize{true};
+  bool print_passes{false};
+
+  // the options affecting the generated code, used to identify the compiled objects
+  std::string ToString() const;
+};
 
 // llvm module optimizer
 class LLVMModuleOptimizer final {
  public:
-  explicit LLVMModuleOptimizer(llvm::TargetMachine *machine,
-                               int opt_level,
-                               llvm::FastMathFlags fast_math_flags,
-                               bool print_passes = false);
+  LLVMModuleOptimizer(llvm::TargetMachine *machine, const OptimizeOptions &options);
   void operator()(llvm::Module *m);
 
  private:
+  void RunNewPassManager(llvm::Module *m);
+  void RunLegacyPassManager(llvm::Module *m);
+
   llvm::TargetMachine *machine_;
-  int opt_level_{};
-  bool print_passes_{};
+  OptimizeOptions options_;
 };
+
+// mark all the floating-point operations and functions in \p m as fast-math
+void ApplyFastMathFlags(llvm::Module *m);
 }  // namespace cinn::backends
@@ -16,12 +16,15 @@
 
 #include <algorithm>
 #include <cmath>
+#include <queue>
+#include <set>
 #include <string>
 #include <utility>
 
 #include "cinn/common/arithmatic.h"
 #include "cinn/common/ir_util.h"
 #include "cinn/ir/collect_ir_nodes.h"
+#include "cinn/ir/ir_compare.h"
 #include "cinn/ir/ir_mutator.h"
 #include "cinn/ir/ir_operators.h"
 #include "cinn/ir/ir_printer.h"
@@ -36,7 +39,14 @@ using namespace ir;  // NOLINT
 
 Expr AutoSimplify(Expr u, const absl::flat_hash_map<std::string, CasInterval>& var_intervals) {
   VLOG(7) << "Begin AutoSimplify: " << u;
-  u = detail::ConvertCinnToCAS(u);
+  CasSimplifyCache* cache = CasSimplifyCache::Current();
+  Expr cached;
+  if (cache && cache->Find(u, var_intervals, &cached)) {
+    VLOG(7) << "End AutoSimplify with the cached " << cached;
+    return cached;
+  }
+  Expr origin = u;
+  u           = detail::ConvertCinnToCAS(u);
   absl::flat_hash_map<std::string, CasInterval> s_var_intervals;
   for (auto& item : var_intervals) {
     if (item.second.e_l.defined() && item.second.e_r.defined()) {
@@ -49,6 +59,7 @@ Expr AutoSimplify(Expr u, const absl::flat_hash_map<std::string, CasInterval>& v
   }
   u = CasSimplify(u, s_var_intervals);
   u = detail::ConvertCasToCinn(u);
+  if (cache) cache->Insert(origin, var_intervals, u);
   VLOG(7) << "End AutoSimplify " << u;
   return u;
 }
@@ -2164,5 +2175,158 @@ Expr SolveInequality(Expr inequality, Var val) {
   return Expr();
 }
 
+namespace {
+
+thread_local CasSimplifyCache* current_cas_simplify_cache = nullptr;
+
+void HashCombine(size_t* seed, size_t value) { *seed ^= value + 0x9e3779b9 + (*seed << 6) + (*seed >> 2); }
+
+std::vector<const Expr*> Fields(const Expr& expr) {
+  const ir::IrNode* node          = expr.ptr();
+  std::vector<const Expr*> fields = node->expr_fields();
+  // the CAS nodes like Sum and Product keep their operands only
+  if (fields.empty()) {
+    for (auto& operand : node->operands) fields.push_back(&operand);
+  }
+  return fields;
+}
+
+// the structural hash of an expression, the expressions equal under IrEqualVisitor have the same hash
+size_t StructuralHash(const Expr& expr) {
+  if (!expr.defined()) return 0;
+  size_t hash = static_cast<size_t>(expr->node_type());
+  if (auto* var = expr.As<_Var_>()) {
+    HashCombine(&hash, std::hash<std::string>()(var->name));
+  } else if (auto* imm = expr.As<IntImm>()) {
+    HashCombine(&hash, std::hash<int64_t>()(imm->value));
+  } else if (auto* imm = expr.As<UIntImm>()) {
+    HashCombine(&hash, std::hash<int64_t>()(imm->value));
+  } else if (auto* imm = expr.As<FloatImm>()) {
+    HashCombine(&hash, std::hash<double>()(imm->value));
+  } else if (auto* tensor = expr.As<_Tensor_>()) {
+    // the tensors are told apart by their names, their bodies are too large to hash
+    HashCombine(&hash, std::hash<std::string>()(tensor->name));
+  } else {
+    if (auto* call = expr.As<Call>()) HashCombine(&hash, std::hash<std::string>()(call->name));
+    for (const Expr* field : Fields(expr)) HashCombine(&hash, StructuralHash(*field));
+  }
+  return hash;
+}
+
+// IrEqualVisitor doesn't compare the types of the nodes, which matter to the results of simplification
+bool SameTypes(const Expr& a, const Expr& b) {
+  if (!a.defined() || !b.defined()) return a.defined() == b.defined();
+  if (a.type() != b.type()) return false;
+  if (a.As<_Tensor_>()) return true;
+  auto a_fields = Fields(a);
+  auto b_fields = Fields(b);
+  if (a_fields.size() != b_fields.size()) return false;
+  for (size_t i = 0; i < a_fields.size(); ++i) {
+    if (!SameTypes(*a_fields[i], *b_fields[i])) return false;
+  }
+  return true;
+}
+
+bool StructurallyEqual(const Expr& a, const Expr& b) { return ir::IrEqualVisitor().Compare(a, b) && SameTypes(a, b); }
+
+bool SameInterval(const CasInterval& a, const CasInterval& b) {
+  bool a_expr = a.e_l.defined() && a.e_r.defined();
+  bool b_expr = b.e_l.defined() && b.e_r.defined();
+  if (a_expr != b_expr) return false;
+  if (!a_expr) return a.l == b.l && a.r == b.r;
+  return StructurallyEqual(a.e_l, b.e_l) && StructurallyEqual(a.e_r, b.e_r);
+}
+
+// the intervals of the vars in u and in the bounds of their intervals, sorted by the names of the vars
+std::vector<std::pair<std::string, CasInterval>> RelevantIntervals(const Expr& u,
+                                                                   const cas_intervals_t& var_intervals) {
+  std::vector<std::pair<std::string, CasInterval>> res;
+  if (var_intervals.empty()) return res;
+
+  std::set<std::string> visited;
+  std::queue<Expr> exprs;
+  exprs.push(u);
+  while (!exprs.empty()) {
+    Expr expr = exprs.front();
+    exprs.pop();
+    ir::CollectIRNodesWithoutTensor(expr, [&](const Expr* x) {
+      auto* var = x->As<_Var_>();
+      if (!var || !visited.insert(var->name).second) return false;
+      auto it = var_intervals.find(var->name);
+      if (it != var_intervals.end()) {
+        res.emplace_back(it->first, it->second);
+        if (it->second.e_l.defined()) exprs.push(it->second.e_l);
+        if (it->second.e_r.defined()) exprs.push(it->second.e_r);
+      }
+      return false;
+    });
+  }
+  std::sort(res.begin(), res.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+  return res;
+}
+
+size_t EntryHash(const Expr& u, const std::vector<std::pair<std::string, CasInterval>>& var_intervals) {
+  size_t hash = StructuralHash(u);
+  for (auto& item : var_intervals) {
+    HashCombine(&hash, std::hash<std::string>()(item.first));
+    if (!item.second.e_l.defined() || !item.second.e_r.defined()) {
+      HashCombine(&hash, std::hash<int>()(item.second.l));
+      HashCombine(&hash, std::hash<int>()(item.second.r));
+    }
+  }
+  return hash;
+}
+
+}  // namespace
+
+CasSimplifyCache* CasSimplifyCache::Current() { return current_cas_simplify_cache; }
+
+bool CasSimplifyCache::Find(const Expr& u, const cas_intervals_t& var_intervals, Expr* result) const {
+  auto intervals = RelevantIntervals(u, var_intervals);
+  auto it        = entries_.find(EntryHash(u, intervals));
+  if (it == entries_.end()) return false;
+  for (auto& entry : it->second) {
+    if (entry.var_intervals.size() != intervals.size() || !StructurallyEqual(entry.expr, u)) continue;
+    bool same_intervals = true;
+    for (size_t i = 0; i < intervals.size() && same_intervals; ++i) {
+      same_intervals = entry.var_intervals[i].first == intervals[i].first &&
+                       SameInterval(entry.var_intervals[i].second, intervals[i].second);
+    }
+    if (same_intervals) {
+      ++num_hits_;
+      *result = optim::IRCopy(entry.result);
+      return true;
+    }
+  }
+  return false;
+}
+
+void CasSimplifyCache::Insert(const Expr& u, const cas_intervals_t& var_intervals, const Expr& result) {
+  auto intervals = RelevantIntervals(u, var_intervals);
+  size_t hash    = EntryHash(u, intervals);
+  for (auto& item : intervals) {
+    if (item.second.e_l.defined() && item.second.e_r.defined()) {
+      item.second.e_l = optim::IRCopy(item.second.e_l);
+      item.second.e_r = optim::IRCopy(item.second.e_r);
+    }
+  }
+  entries_[hash].push_back(Entry{optim::IRCopy(u), std::move(intervals), optim::IRCopy(result)});
+  ++num_entries_;
+}
+
+CasSimplifyCacheScope::CasSimplifyCacheScope(bool enabled) {
+  if (enabled && !current_cas_simplify_cache) {
+    cache_.reset(new CasSimplifyCache);
+    current_cas_simplify_cache = cache_.get();
+  }
+}
+
+CasSimplifyCacheScope::~CasSimplifyCacheScope() {
+  if (cache_) {
+    VLOG(4) << "CasSimplifyCache hit " << cache_->num_hits() << " times with " << cache_->num_entries() << " entries";
+    current_cas_simplify_cache = nullptr;
+  }
+}
+
 }  // namespace common
 }  // namespace cinn
@@ -16,9 +16,12 @@
 #include <absl/container/flat_hash_map.h>
 
 #include <functional>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "cinn/common/macros.h"
 #include "cinn/ir/ir.h"
 #include "cinn/ir/ir_printer.h"
 #include "cinn/optim/ir_simplify.h"
@@ -87,6 +90,56 @@ Expr AutoSimplify(Expr u, const absl::flat_hash_map<std::string, CasInterval>& v
 //! Simplify a CAS expression.
 Expr CasSimplify(Expr u, const absl::flat_hash_map<std::string, CasInterval>& var_intervals = {});
 
+/**
+ * A cache of the results of AutoSimplify in the current thread while a CasSimplifyCacheScope is alive.
+ *
+ * The results are keyed by the structure of the expression and the intervals of the vars it depends on, including
+ * the vars in the bounds of those intervals, so simplifying an expression again in the same lowering session is a
+ * lookup. The cached expressions are copied in and out, so the callers can mutate them in place.
+ */
+class CasSimplifyCache {
+ public:
+  //! The cache of the current thread, nullptr if no CasSimplifyCacheScope is alive.
+  static CasSimplifyCache* Current();
+
+  //! Get the cached result of simplifying \p u with \p var_intervals, return false if not cached.
+  bool Find(const Expr& u, const cas_intervals_t& var_intervals, Expr* result) const;
+
+  //! Cache the \p result of simplifying \p u with \p var_intervals.
+  void Insert(const Expr& u, const cas_intervals_t& var_intervals, const Expr& result);
+
+  int num_hits() const { return num_hits_; }
+  int num_entries() const { return num_entries_; }
+
+ private:
+  struct Entry {
+    Expr expr;
+    // the intervals of the vars the expression depends on, sorted by the names of the vars
+    std::vector<std::pair<std::string, CasInterval>> var_intervals;
+    Expr result;
+  };
+
+  absl::flat_hash_map<size_t, std::vector<Entry>> entries_;
+  mutable int num_hits_ = 0;
+  int num_entries_      = 0;
+};
+
+/**
+ * Cache the results of AutoSimplify in the current thread during the lifetime of this object if \p enabled, a
+ * nested scope shares the cache of the outermost one.
+ */
+class CasSimplifyCacheScope {
+ public:
+  explicit CasSimplifyCacheScope(bool enabled);
+  ~CasSimplifyCacheScope();
+
+ private:
+  // the cache created by this scope, nullptr if an outer scope is alive
+  std::unique_ptr<CasSimplifyCache> cache_;
+
+  CINN_DISALLOW_COPY_AND_ASSIGN(CasSimplifyCacheScope);
+};
+
 /**
  * \brief Solve an equality.
  * Currently this is an naive implementation using the GiNaC.
@@ -400,5 +400,32 @@ TEST(CAS, cond) {
   }
 }
 
+TEST(CAS, SimplifyCache) {
+  Var x = ir::_Var_::Make("x", Int(32));
+  Var y = ir::_Var_::Make("y", Int(32));
+  auto make_expr = [&]() { return (Expr(x) * 32 + y) / 32; };
+
+  CasSimplifyCacheScope scope(true);
+  CasSimplifyCache* cache = CasSimplifyCache::Current();
+  ASSERT_TRUE(cache);
+
+  Expr u0 = AutoSimplify(make_expr(), {{"y", CasInterval(0, 31)}});
+  EXPECT_EQ(GetStreamCnt(u0), "x");
+  EXPECT_EQ(cache->num_hits(), 0);
+
+  // the same expression with the same interval of y is a lookup, the interval of the unused var doesn't matter
+  Expr u1 = AutoSimplify(make_expr(), {{"y", CasInterval(0, 31)}, {"z", CasInterval(0, 7)}});
+  EXPECT_EQ(GetStreamCnt(u1), "x");
+  EXPECT_EQ(cache->num_hits(), 1);
+  // the cached results are copied out
+  EXPECT_FALSE(u0.same_as(u1));
+
+  // another interval of y is simplified again
+  Expr u2 = AutoSimplify(make_expr(), {{"y", CasInterval(0, 63)}});
+  EXPECT_NE(GetStreamCnt(u2), "x");
+  EXPECT_EQ(cache->num_hits(), 1);
+  EXPECT_EQ(cache->num_entries(), 2);
+}
+
 }  // namespace common
 }  // namespace cinn
@@ -44,6 +44,17 @@ void Buffer::Resize(uint32_t alignment, uint32_t size) {
   }
 }
 
+void Buffer::ShareMemory(const std::shared_ptr<Buffer>& arena, size_t offset, size_t size) {
+  CHECK(arena && arena.get() != this) << "The arena to share memory should be another buffer";
+  CHECK_LE(offset + size, arena->size_) << "The shared memory exceeds the size of arena";
+  Free();
+  SetTarget(arena->target_);
+  arena_            = arena;
+  data_.memory      = arena->data_.memory + offset;
+  data_.memory_size = size;
+  size_             = size;
+}
+
 void Buffer::SetTarget(const common::Target& target) {
   target_           = target;
   memory_mng_cache_ = MemoryManager::Global().RetrieveSafely(target_.arch);
@@ -56,8 +56,18 @@ struct Buffer final {
   const cinn_buffer_t* data() const { return &data_; }
   cinn_buffer_t* data() { return &data_; }
 
+  //! Use a piece of the memory hold by \p arena instead of allocating by itself, the memory is
+  //! never freed by this buffer and \p arena will be kept alive as long as it is used.
+  void ShareMemory(const std::shared_ptr<Buffer>& arena, size_t offset, size_t size);
+
   //! Free all the memory owned by this buffer.
   void Free() {
+    if (arena_) {
+      arena_.reset();
+      data_.memory = nullptr;
+      size_        = 0;
+      return;
+    }
     if (!data_.memory) return;
     memory_mng_cache_->free(data_.memory);
   }
@@ -79,11 +89,14 @@ struct Buffer final {
   //! The place where this buffer locates.
   common::Target target_;
 
-  //! Number of bytes of this buffer.
-  uint32_t size_{};
+  //! Number of bytes of this buffer, which may be a piece of an arena larger than 4GB.
+  size_t size_{};
 
   //! Hold the corresponding memory manager for speed.
   MemoryInterface* memory_mng_cache_{};
+
+  //! The buffer whose memory is shared by this buffer, null if this buffer owns its memory.
+  std::shared_ptr<Buffer> arena_;
 };
 
 }  // namespace framework
@@ -31,6 +31,24 @@ TEST(Buffer, basic) {
   for (int i = 0; i < 10; i++) data[i] = i;
 }
 
+TEST(Buffer, share_memory) {
+  auto arena = std::make_shared<Buffer>(common::DefaultHostTarget());
+  arena->Resize(20 * sizeof(float));
+  auto* arena_data = reinterpret_cast<float*>(arena->data()->memory);
+
+  Buffer buffer;
+  buffer.ShareMemory(arena, 10 * sizeof(float), 10 * sizeof(float));
+  ASSERT_EQ(reinterpret_cast<float*>(buffer.data()->memory), arena_data + 10);
+  // lazily resizing to a smaller size won't allocate memory again
+  buffer.ResizeLazy(5 * sizeof(float), common::DefaultHostTarget());
+  ASSERT_EQ(reinterpret_cast<float*>(buffer.data()->memory), arena_data + 10);
+
+  // the arena is kept alive by the buffer sharing its memory
+  arena.reset();
+  auto* data = reinterpret_cast<float*>(buffer.data()->memory);
+  for (int i = 0; i < 10; i++) data[i] = i;
+}
+
 #ifdef CINN_WITH_CUDA
 TEST(Buffer, nvgpu) {
   const int num_elements = 10;
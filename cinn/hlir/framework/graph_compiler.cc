@@ -16,21 +16,35 @@
 
 #include <absl/container/flat_hash_map.h>
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <limits>
 #include <memory>
+#include <set>
+#include <thread>
+#include <unordered_map>
 #include <unordered_set>
 
 #include "cinn/backends/codegen_cuda_dev.h"
 #include "cinn/common/context.h"
 #include "cinn/hlir/framework/instruction.h"
+#include "cinn/hlir/framework/kernel_cache.h"
+#include "cinn/hlir/framework/memory_planner.h"
 #include "cinn/hlir/framework/op_lowering.h"
 #include "cinn/hlir/framework/tensor.h"
 #include "cinn/hlir/pe/schedule.h"
+#include "cinn/ir/ir_arena.h"
 #include "cinn/lang/lower.h"
 #include "cinn/optim/transform_gpu_forloop.h"
 #include "cinn/poly/stage.h"
 
 DECLARE_bool(cinn_ir_schedule);
+DECLARE_bool(cinn_enable_kernel_cache);
 DECLARE_int32(cinn_parallel_compile_size);
+DECLARE_int32(cinn_parallel_execute_threads);
+DECLARE_bool(cinn_enable_ir_arena);
+DECLARE_bool(cinn_ir_hash_consing);
 
 namespace cinn {
 namespace hlir {
@@ -208,8 +222,15 @@ void Program::Export(const std::vector<std::string>& persistent_vars, const std:
 }
 
 void Program::Execute(const std::map<std::string, cinn_pod_value_t>* name2podargs, void* stream, bool use_cache) {
-  for (auto& ins : instrs_) {
-    ins->Run(name2podargs, false, stream, use_cache);
+  if (FLAGS_cinn_parallel_execute_threads > 0 && !instrs_.empty() && instrs_[0]->target_.arch == Target::Arch::X86) {
+    ExecuteParallel(name2podargs, use_cache, FLAGS_cinn_parallel_execute_threads);
+    return;
+  }
+  for (int i = 0; i < instrs_.size(); ++i) {
+    if (prefetch_pool_) {
+      PrefetchInstructions(i + 1);
+    }
+    instrs_[i]->Run(name2podargs, false, stream, use_cache);
   }
 #ifdef CINN_WITH_CUDA
   VLOG(4) << "-- The value of the used stream: " << stream;
@@ -219,6 +240,187 @@ void Program::Execute(const std::map<std::string, cinn_pod_value_t>* name2podarg
 #endif
 }
 
+void Program::SetLazyJitPrefetch(int num_instrs) {
+  CHECK_GE(num_instrs, 0) << "The number of instructions to prefetch should be non-negative";
+  prefetch_num_ = num_instrs;
+  prefetch_end_ = 0;
+  if (prefetch_num_ == 0) {
+    prefetch_pool_.reset();
+  } else if (!prefetch_pool_) {
+    // one background thread is enough, the compilation itself may be concurrent inside the JIT engine
+    prefetch_pool_ = std::make_unique<utils::ThreadPool>(1);
+  }
+}
+
+void Program::PrefetchInstructions(int begin) {
+  int end = std::min<int>(begin + prefetch_num_, instrs_.size());
+  for (int i = std::max(begin, prefetch_end_); i < end; ++i) {
+    auto* instr = instrs_[i].get();
+    if (!instr->materialized()) {
+      prefetch_pool_->Submit([instr]() { instr->Materialize(); });
+    }
+  }
+  prefetch_end_ = std::max(prefetch_end_, end);
+}
+
+void Program::BuildDependencyGraph() {
+  // the variables may alias each other, such as the reused variables sharing one buffer and the variables planned
+  // into overlapping pieces of one arena, so the instructions are ordered by the byte ranges they access
+  struct Access {
+    uintptr_t begin;
+    uintptr_t end;
+    int step;
+    bool is_write;
+  };
+  // the variables not allocated yet are told apart by their buffers, which never overlap the allocated memory,
+  // and the ones not in the scope by their names, whose addresses in a node based map stay stable on rehashing
+  std::unordered_map<std::string, char> unknown_vars;
+  auto get_range = [&](const std::string& name) -> std::pair<uintptr_t, uintptr_t> {
+    auto* var = scope_->FindVar(name);
+    if (!var) {
+      auto begin = reinterpret_cast<uintptr_t>(&unknown_vars[name]);
+      return {begin, begin + 1};
+    }
+    auto buffer = absl::get<Tensor>(*var)->get_buffer();
+    auto* data  = buffer->data();
+    if (!data->memory || data->memory_size == 0) {
+      auto begin = reinterpret_cast<uintptr_t>(buffer.get());
+      return {begin, begin + 1};
+    }
+    auto begin = reinterpret_cast<uintptr_t>(data->memory);
+    return {begin, begin + data->memory_size};
+  };
+
+  // the accesses which are not covered by a later write
+  std::vector<Access> accesses;
+  successors_.assign(instrs_.size(), {});
+  num_predecessors_.assign(instrs_.size(), 0);
+  for (int step = 0; step < instrs_.size(); ++step) {
+    std::vector<Access> step_accesses;
+    for (const auto& args : instrs_[step]->GetInArgs()) {
+      for (const auto& arg : args) {
+        auto range = get_range(arg);
+        step_accesses.push_back({range.first, range.second, step, false});
+      }
+    }
+    for (const auto& args : instrs_[step]->GetOutArgs()) {
+      for (const auto& arg : args) {
+        auto range = get_range(arg);
+        step_accesses.push_back({range.first, range.second, step, true});
+      }
+    }
+
+    // read after write, write after write and write after read
+    std::set<int> predecessors;
+    for (const auto& access : step_accesses) {
+      for (const auto& pre : accesses) {
+        if ((access.is_write || pre.is_write) && access.begin < pre.end && pre.begin < access.end) {
+          predecessors.insert(pre.step);
+        }
+      }
+    }
+    predecessors.erase(step);
+
+    for (int pre : predecessors) {
+      successors_[pre].push_back(step);
+    }
+    num_predecessors_[step] = predecessors.size();
+
+    // the accesses covered by a write of this step are ordered before it, so the later ones only depend on it
+    for (const auto& access : step_accesses) {
+      if (!access.is_write) continue;
+      accesses.erase(std::remove_if(accesses.begin(),
+                                    accesses.end(),
+                                    [&](const Access& pre) {
+                                      return access.begin <= pre.begin && pre.end <= access.end;
+                                    }),
+                     accesses.end());
+    }
+    accesses.insert(accesses.end(), step_accesses.begin(), step_accesses.end());
+  }
+  VLOG(3) << "Build the dependency graph of " << instrs_.size() << " instructions";
+}
+
+void Program::ExecuteParallel(const std::map<std::string, cinn_pod_value_t>* name2podargs,
+                              bool use_cache,
+                              int num_threads) {
+  if (instrs_.empty()) {
+    return;
+  }
+  CHECK(instrs_[0]->target_.arch == Target::Arch::X86) << "ExecuteParallel only supports the X86 target now";
+
+  int max_threads = std::thread::hardware_concurrency();
+  if (num_threads == -1 || num_threads > max_threads) {
+    num_threads = max_threads;
+  }
+  if (!thread_pool_ || thread_pool_->num_threads() != num_threads) {
+    thread_pool_ = std::make_unique<utils::ThreadPool>(num_threads);
+  }
+  if (successors_.size() != instrs_.size()) {
+    BuildDependencyGraph();
+  }
+
+  // an instruction is ready to run when all the instructions it depends on have finished
+  std::unique_ptr<std::atomic<int>[]> remaining(new std::atomic<int>[instrs_.size()]);
+  for (int i = 0; i < instrs_.size(); ++i) {
+    remaining[i] = num_predecessors_[i];
+  }
+
+  std::function<void(int)> run_instr = [&](int idx) {
+    instrs_[idx]->Run(name2podargs, false, nullptr, use_cache);
+    for (int succ : successors_[idx]) {
+      if (--remaining[succ] == 0) {
+        thread_pool_->Submit([&run_instr, succ]() { run_instr(succ); });
+      }
+    }
+  };
+  for (int i = 0; i < instrs_.size(); ++i) {
+    if (num_predecessors_[i] == 0) {
+      thread_pool_->Submit([&run_instr, i]() { run_instr(i); });
+    }
+  }
+  thread_pool_->Wait();
+}
+
+int ArgumentBinding::IndexOf(const std::string& name) const {
+  auto it = std::find(names_.begin(), names_.end(), name);
+  return it == names_.end() ? -1 : static_cast<int>(it - names_.begin());
+}
+
+ArgumentBinding Program::BindArguments(const std::vector<std::string>& arg_names,
+                                       const std::map<std::string, cinn_pod_value_t>* name2podargs) {
+  ArgumentBinding binding;
+  binding.names_ = arg_names;
+  binding.slots_.resize(arg_names.size());
+  absl::flat_hash_map<std::string, int> name2index;
+  for (int i = 0; i < arg_names.size(); ++i) {
+    CHECK(name2index.emplace(arg_names[i], i).second) << "Argument [" << arg_names[i] << "] is bound repeatedly";
+  }
+
+  for (auto& ins : instrs_) {
+    // build the caches in advance, the arguments are placed in the order of the inputs and then the outputs
+    ins->UpdateArgsCache(name2podargs);
+    auto in_args  = ins->GetInArgs();
+    auto out_args = ins->GetOutArgs();
+    for (int fn_idx = 0; fn_idx < ins->size(); ++fn_idx) {
+      auto all_args = in_args[fn_idx];
+      all_args.insert(all_args.end(), out_args[fn_idx].begin(), out_args[fn_idx].end());
+      for (int arg_idx = 0; arg_idx < all_args.size(); ++arg_idx) {
+        auto it = name2index.find(all_args[arg_idx]);
+        if (it != name2index.end()) {
+          binding.slots_[it->second].push_back(ins->GetCachedArg(fn_idx, arg_idx));
+        }
+      }
+    }
+  }
+  for (int i = 0; i < arg_names.size(); ++i) {
+    if (binding.slots_[i].empty()) {
+      VLOG(3) << "Argument [" << arg_names[i] << "] is not used by any instruction";
+    }
+  }
+  return binding;
+}
+
 void Program::ExecuteTest(int repeat_) {
   cinn::utils::Timer timer1;
   for (int i = 0; i < 100; i++) {
@@ -706,27 +908,15 @@ void GraphCompiler::CompileOptions::Apply(const auto_schedule::TuningResult& tun
 GraphCompiler::CompilationResult GraphCompiler::Build(const GraphCompiler::CompileOptions& options,
                                                       std::unordered_set<std::string>&& fetch_var_ids,
                                                       void* stream) {
+  compile_options_ = options;
+  fetch_var_ids_   = std::move(fetch_var_ids);
   if (FLAGS_cinn_parallel_compile_size) {
-    if (options.with_instantiate_variables) {
-      VLOG(3) << "Initantiate all variables on compile-time";
-      // All variables reside in scope_, so traverse it to instantiate each one
-      for (auto& name : scope_->var_names()) {
-        auto* var    = scope_->Var<Tensor>(std::string({name.data(), name.size()}));
-        auto& tensor = absl::get<Tensor>(*var);
-        if (reuse_vars_map_.count(name)) {
-          auto src_var_name = reuse_vars_map_.at(name);
-          auto* src_var     = scope_->Var<Tensor>(src_var_name);
-          auto& src_tensor  = absl::get<Tensor>(*src_var);
-          tensor->set_buffer(src_tensor->get_buffer());
-        } else {
-          tensor->mutable_data(target_, tensor->type());
-        }
-      }
-    }
-
     VLOG(2) << "Compile With Parallel Compiler!";
+    LOG_IF(WARNING, options.with_lazy_jit) << "with_lazy_jit is not supported by the parallel compiler, ignore it";
+    LOG_IF(WARNING, options.export_object) << "export_object is not supported by the parallel compiler, ignore it";
     ParallelCompiler::CompileOptions option;
-    option.lowered_funcs = options.lowered_funcs;
+    option.lowered_funcs     = options.lowered_funcs;
+    option.execution_options = options.execution_options;
 
     parallel_compiler_ = std::make_shared<ParallelCompiler>(scope_, graph_, option, target_);
     auto instructions  = (*parallel_compiler_.get())();
@@ -739,20 +929,31 @@ GraphCompiler::CompilationResult GraphCompiler::Build(const GraphCompiler::Compi
       VLOG(3) << "option.with_buffer_handle_instruction_inserted enable";
       InsertBufferHandlers(&instructions);
     }
+    if (options.with_static_memory_plan) {
+      CHECK(!options.with_buffer_handle_instruction_inserted)
+          << "with_static_memory_plan and with_buffer_handle_instruction_inserted can't be enabled together";
+      PlanStaticMemory(instructions);
+    }
+    // the variables are instantiated after planning, otherwise they have been allocated and can't be planned
+    if (options.with_instantiate_variables) {
+      InstantiateVariables();
+    }
     VLOG(2) << "Compile With Parallel Compiler Done!";
 
     GraphCompiler::CompilationResult compilation_result;
     compilation_result.runtime_program.reset(new Program(scope_, std::move(instructions)));
+    compilation_result.runtime_program->KeepAlive(parallel_compiler_);
     return compilation_result;
   }
 
   Context::Global().ResetNameId();
-  compile_options_ = options;
-  fetch_var_ids_   = std::move(fetch_var_ids);
-  auto topo_order  = graph_->topological_order();
-  auto& nodes      = std::get<0>(topo_order);
+  // the groups are lowered and compiled in one arena, which the scopes inside share
+  ir::IrArenaScope arena_scope(FLAGS_cinn_enable_ir_arena, FLAGS_cinn_ir_hash_consing);
+  auto topo_order = graph_->topological_order();
+  auto& nodes     = std::get<0>(topo_order);
   VLOG(3) << "Begin GraphCompiler::Build";
   m_builder_.Clear();
+  reused_func_map_.clear();
   // if there are no avaiable groups, we will take each node as a group
   if (options.groups.empty() && graph_->groups.empty() && graph_->fusion_groups.empty()) {
     VLOG(3) << "not run opfusion pass";
@@ -783,9 +984,28 @@ GraphCompiler::CompilationResult GraphCompiler::Build(const GraphCompiler::Compi
       auto& shape_dict = graph_->GetMutableAttrs<absl::flat_hash_map<std::string, shape_t>>("infershape");
 
       OpLowerer op_lowerer(dtype_dict, shape_dict, target_);
+      // the lowered groups indexed by their fingerprints
+      absl::flat_hash_map<std::string, std::pair<std::shared_ptr<Graph::Group>, GroupFingerprint>> lowered_groups;
       for (auto& group : graph_->fusion_groups) {
         VLOG(3) << "group_id is : " << group->group_id << ", and its number is : " << group->nodes.size();
         groups.push_back(std::move(group->CollectNodes()));
+        if (FLAGS_cinn_enable_kernel_cache) {
+          auto fingerprint = GroupFingerprint::Compute(group, dtype_dict, shape_dict, target_);
+          auto it          = lowered_groups.find(fingerprint.key);
+          std::vector<std::string> input_names, output_names;
+          if (it != lowered_groups.end() &&
+              fingerprint.MapNames(it->second.second, it->second.first->input_names, &input_names) &&
+              fingerprint.MapNames(it->second.second, it->second.first->output_names, &output_names)) {
+            // reuse the function of the structurally identical group, nothing to lower
+            VLOG(3) << "group " << group->group_id << " reuses the function of group " << it->second.first->group_id;
+            group->input_names  = std::move(input_names);
+            group->output_names = std::move(output_names);
+            reused_func_map_[group->GetFuncName()] = it->second.first->GetFuncName();
+            local_lowered_funcs.emplace_back();
+            continue;
+          }
+          lowered_groups.emplace(fingerprint.key, std::make_pair(group, std::move(fingerprint)));
+        }
         local_lowered_funcs.emplace_back(std::move(op_lowerer.Lower(group)));
         CHECK_EQ(local_lowered_funcs.back().size(), 1) << "Lowerd Function Is Not Equal 1!";
         VLOG(3) << local_lowered_funcs.back()[0];
@@ -825,7 +1045,7 @@ GraphCompiler::CompilationResult GraphCompiler::Build(const GraphCompiler::Compi
   // compile the module
   // Need to create a new compiler for every call of Build,
   // because the underneath jit engine does't support addIRModule repeatedly now.
-  compiler_ = backends::Compiler::Create(target_);
+  compiler_ = backends::Compiler::Create(target_, options.execution_options);
 
   auto build_module = m_builder_.Build();
   VLOG(3) << "End of m_builder_.Build()";
@@ -838,6 +1058,15 @@ GraphCompiler::CompilationResult GraphCompiler::Build(const GraphCompiler::Compi
 
   compiler_->Build(build_module, options.attached_code);
   VLOG(3) << "End of compiler_->Build";
+  if (target_.arch == Target::Arch::X86 && options.execution_options.num_compile_threads > 0 &&
+      !options.with_lazy_jit) {
+    // materialize all the functions concurrently before building the instructions
+    std::vector<std::string> fn_names;
+    for (auto& fn : build_module.functions()) {
+      fn_names.push_back(fn->name);
+    }
+    compiler_->Lookup(fn_names);
+  }
   auto instructions = BuildInstructions(groups, options.groups.empty() ? graph_->fusion_groups : options.groups);
 
   VLOG(3) << "End of BuildInstructions";
@@ -848,26 +1077,27 @@ GraphCompiler::CompilationResult GraphCompiler::Build(const GraphCompiler::Compi
     VLOG(3) << "option.with_buffer_handle_instruction_inserted enable";
     InsertBufferHandlers(&instructions);
   }
+  if (options.with_static_memory_plan) {
+    CHECK(!options.with_buffer_handle_instruction_inserted)
+        << "with_static_memory_plan and with_buffer_handle_instruction_inserted can't be enabled together";
+    PlanStaticMemory(instructions);
+  }
 
   if (options.with_instantiate_variables) {
-    VLOG(3) << "Initantiate all variables on compile-time";
-    // All variables reside in scope_, so traverse it to instantiate each one
-    for (auto& name : scope_->var_names()) {
-      auto* var    = scope_->Var<Tensor>(std::string({name.data(), name.size()}));
-      auto& tensor = absl::get<Tensor>(*var);
-      if (reuse_vars_map_.count(name)) {
-        auto src_var_name = reuse_vars_map_.at(name);
-        auto* src_var     = scope_->Var<Tensor>(src_var_name);
-        auto& src_tensor  = absl::get<Tensor>(*src_var);
-        tensor->set_buffer(src_tensor->get_buffer());
-      } else {
-        tensor->mutable_data(target_, tensor->type());
-      }
-    }
+    InstantiateVariables();
   }
 
   GraphCompiler::CompilationResult result;
+  if (options.export_object) {
+    CHECK(target_.arch == Target::Arch::X86) << "The object can only be exported on the CPU target";
+    result.object = compiler_->GetObject();
+  }
   result.runtime_program.reset(new Program(scope_, std::move(instructions)));
+  // the next Build replaces compiler_, so the program holds the compiler its functions live in
+  result.runtime_program->KeepAlive(compiler_);
+  if (options.with_lazy_jit) {
+    result.runtime_program->SetLazyJitPrefetch(options.lazy_jit_prefetch);
+  }
   return result;
 }
 
@@ -880,9 +1110,7 @@ void GraphCompiler::SetSubKernels(Instruction* instr, const std::string& func_na
     instr->AddOutArgs(function2output_args_[func_name]);
   }
   while (function2input_args_.count(new_op_func) != 0) {
-    auto* fn_ptr = compiler_->Lookup(new_op_func);
-    CHECK(fn_ptr);
-    instr->SetLoweredFunc(reinterpret_cast<void*>(fn_ptr), new_op_func);
+    SetLoweredFunc(instr, new_op_func);
     instr->AddInArgs(function2input_args_[new_op_func]);
     instr->AddOutArgs(function2output_args_[new_op_func]);
     i++;
@@ -890,6 +1118,17 @@ void GraphCompiler::SetSubKernels(Instruction* instr, const std::string& func_na
   }
 }
 
+void GraphCompiler::SetLoweredFunc(Instruction* instr, const std::string& func_name) {
+  if (compile_options_.with_lazy_jit) {
+    auto compiler = compiler_;
+    instr->SetLazyLoweredFunc([compiler, func_name]() { return compiler->Lookup(func_name); }, func_name);
+    return;
+  }
+  auto* fn_ptr = compiler_->Lookup(func_name);
+  CHECK(fn_ptr) << "Can't find the function " << func_name;
+  instr->SetLoweredFunc(reinterpret_cast<void*>(fn_ptr), func_name);
+}
+
 void GraphCompiler::BuildCublasInstr(const Node& node, Instruction* instr) const {
   instr->ClearInArgs();
   instr->AddInArgs(OpGetInputNames(&node));
@@ -1115,9 +1354,10 @@ std::vector<std::unique_ptr<Instruction>> GraphCompiler::BuildInstructions(
       }
       std::string op_func_name =
           fusion_group.get() ? fusion_group->GetFuncName() : GetOrGenFullFuncName(GenOpFuncName(node));
-      auto* fn_ptr = compiler_->Lookup(op_func_name);
-      CHECK(fn_ptr);
-      instr->SetLoweredFunc(reinterpret_cast<void*>(fn_ptr), op_func_name);
+      if (reused_func_map_.count(op_func_name)) {
+        op_func_name = reused_func_map_.at(op_func_name);
+      }
+      SetLoweredFunc(instr.get(), op_func_name);
 
       // As some instruction like reduce, will generate more than one kernel.
       // So try to find the rest kernel, if it exist.
@@ -1173,6 +1413,9 @@ std::vector<std::unique_ptr<Instruction>> GraphCompiler::BuildInstructions(
         VLOG(3) << "out_names: " << utils::Join(outputNames, ", ");
       }
       fuse_name = fusion_group.get() ? fusion_group->GetFuncName() : GetOrGenFullFuncName(fuse_name);
+      if (reused_func_map_.count(fuse_name)) {
+        fuse_name = reused_func_map_.at(fuse_name);
+      }
       auto instr =
           std::unique_ptr<Instruction>(new Instruction(target_,
                                                        scope_.get(),
@@ -1180,9 +1423,7 @@ std::vector<std::unique_ptr<Instruction>> GraphCompiler::BuildInstructions(
                                                        fusion_group.get() ? fusion_group->output_names : outputNames,
                                                        fuse_name));
 
-      auto* fn_ptr = compiler_->Lookup(fuse_name);
-      CHECK(fn_ptr);
-      instr->SetLoweredFunc(reinterpret_cast<void*>(fn_ptr), fuse_name);
+      SetLoweredFunc(instr.get(), fuse_name);
       // As some situation like reduce,will generate more than one kernel.
       // So try to find the rest kernel, if it exist.
       SetSubKernels(instr.get(), fuse_name);
@@ -1334,6 +1575,100 @@ void GraphCompiler::InsertBufferHandlers(std::vector<std::unique_ptr<Instruction
   instructions->swap(results);
 }
 
+void GraphCompiler::InstantiateVariables() {
+  VLOG(3) << "Initantiate all variables on compile-time";
+  // All variables reside in scope_, so traverse it to instantiate each one
+  for (auto& name : scope_->var_names()) {
+    auto* var    = scope_->Var<Tensor>(std::string({name.data(), name.size()}));
+    auto& tensor = absl::get<Tensor>(*var);
+    if (reuse_vars_map_.count(name)) {
+      auto src_var_name = reuse_vars_map_.at(name);
+      auto* src_var     = scope_->Var<Tensor>(src_var_name);
+      auto& src_tensor  = absl::get<Tensor>(*src_var);
+      tensor->set_buffer(src_tensor->get_buffer());
+    } else {
+      tensor->mutable_data(target_, tensor->type());
+    }
+  }
+}
+
+void GraphCompiler::PlanStaticMemory(const std::vector<std::unique_ptr<Instruction>>& instructions) {
+  absl::flat_hash_map<std::string, int> variable_first_used, variable_last_used;
+  // variables read by any instruction before written are inputs of the program
+  std::unordered_set<std::string> input_variables, read_variables;
+  for (auto step = 0; step < instructions.size(); ++step) {
+    const auto& instr = instructions.at(step);
+    for (const auto& args : instr->GetInArgs()) {
+      for (const auto& var_name : args) {
+        if (!variable_first_used.count(var_name)) {
+          input_variables.insert(var_name);
+        }
+        variable_first_used.try_emplace(var_name, step);
+        variable_last_used[var_name] = step;
+        read_variables.insert(var_name);
+      }
+    }
+    for (const auto& args : instr->GetOutArgs()) {
+      for (const auto& var_name : args) {
+        variable_first_used.try_emplace(var_name, step);
+        variable_last_used[var_name] = step;
+      }
+    }
+  }
+  std::unordered_set<std::string> reused_variables;
+  for (const auto& dst2src : reuse_vars_map_) {
+    reused_variables.insert(dst2src.first);
+    reused_variables.insert(dst2src.second);
+  }
+
+  std::vector<MemoryBlock> blocks;
+  for (const auto& var2first : variable_first_used) {
+    const auto& var_name = var2first.first;
+    auto* var            = scope_->FindVar(var_name);
+    if (!var || input_variables.count(var_name) || reused_variables.count(var_name)) {
+      continue;
+    }
+    auto& tensor = absl::get<Tensor>(*var);
+    if (tensor->buffer()->memory) {
+      // the variable has been allocated outside, such as a parameter
+      continue;
+    }
+    // the fetched variables and outputs of the program should be alive until the end
+    int last_use = variable_last_used.at(var_name);
+    if (fetch_var_ids_.count(var_name) || !read_variables.count(var_name)) {
+      last_use = instructions.size();
+    }
+    blocks.emplace_back(var_name, tensor->shape().numel() * tensor->type().bytes(), var2first.second, last_use);
+  }
+  if (blocks.empty()) {
+    return;
+  }
+
+  // keep the same alignment as Tensor::mutable_data on host
+  size_t alignment  = target_ == common::DefaultHostTarget() ? 1024 : 256;
+  size_t arena_size = StaticMemoryPlanner::Plan(&blocks, alignment);
+  if (arena_size > std::numeric_limits<uint32_t>::max()) {
+    // Buffer can't allocate more than 4GB at once, leave the variables allocated by themselves
+    LOG(WARNING) << "The arena of " << arena_size << " bytes is too large to plan the static memory, skip it";
+    return;
+  }
+
+  auto arena = std::make_shared<Buffer>(target_);
+  if (target_ == common::DefaultHostTarget()) {
+    arena->Resize(alignment, arena_size);
+  } else {
+    arena->Resize(arena_size);
+  }
+  size_t total_size = 0;
+  for (const auto& block : blocks) {
+    auto tensor = scope_->GetTensor(block.name);
+    tensor->get_buffer()->ShareMemory(arena, block.offset, block.size);
+    total_size += block.size;
+  }
+  VLOG(3) << "Plan " << blocks.size() << " variables into an arena of " << arena_size << " bytes, "
+          << "the total size of them is " << total_size << " bytes";
+}
+
 std::vector<std::string> GraphCompiler::OpGetInputNames(const Node* node) const {
   std::vector<std::string> res;
   if (node->op()->name == "cublas_gemm" || node->op()->name == "cublas_matmul" || node->op()->name == "conv2d" ||
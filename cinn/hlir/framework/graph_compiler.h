@@ -34,12 +34,46 @@
 #include "cinn/hlir/framework/scope.h"
 #include "cinn/ir/lowered_func.h"
 #include "cinn/lang/packed_func.h"
+#include "cinn/utils/thread_pool.h"
 #include "cinn/utils/timer.h"
 
 namespace cinn {
 namespace hlir {
 namespace framework {
 
+/**
+ * ArgumentBinding holds the positions where the external arguments of a Program are placed in the arguments
+ * caches of its instructions, so the buffers of the arguments can be replaced for every execution by index,
+ * without looking up names or rebuilding the caches.
+ */
+class ArgumentBinding {
+ public:
+  // the index of the argument named \p name, -1 if it is not bound
+  int IndexOf(const std::string& name) const;
+
+  // set the buffer of the index-th argument for the following executions
+  void Bind(int index, cinn_buffer_t* buffer) { Bind(index, cinn_pod_value_t(buffer)); }
+
+  void Bind(int index, const cinn_pod_value_t& value) {
+    CHECK(index >= 0 && index < static_cast<int>(slots_.size()))
+        << "The index of argument " << index << " is out of range [0, " << slots_.size() << ")";
+    for (auto* slot : slots_[index]) {
+      *slot = value;
+    }
+  }
+
+  size_t size() const { return names_.size(); }
+
+  const std::vector<std::string>& names() const { return names_; }
+
+ private:
+  friend class Program;
+
+  std::vector<std::string> names_;
+  // the addresses of the index-th argument in the arguments caches
+  std::vector<std::vector<cinn_pod_value_t*>> slots_;
+};
+
 /**
  * The Program is the runtime instance for running a computation.
  */
@@ -63,6 +97,26 @@ class Program {
                void* stream                                                = nullptr,
                bool use_cache                                              = true);
 
+  /**
+   * Execute the program on a thread pool, the instructions are scheduled by a DAG built from the
+   * variables they read and write, so independent instructions can run concurrently.
+   * Only supported on the CPU target.
+   * @param num_threads The number of threads in the pool, -1 means utilizing the maximum limit of hardware.
+   */
+  void ExecuteParallel(const std::map<std::string, cinn_pod_value_t>* name2podargs = nullptr,
+                       bool use_cache                                              = true,
+                       int num_threads                                             = -1);
+
+  /**
+   * Resolve the arguments to their positions in the arguments caches of the instructions, the buffers of them
+   * can be rebound through the returned binding before every execution. The binding is valid as long as the
+   * caches are not rebuilt, so the program should be executed with use_cache = true, and after PreRun if any.
+   * @param arg_names The names of the arguments to bind, usually the inputs and outputs fed by the caller.
+   * @param name2podargs The initial values of all the arguments, nullptr means using the tensors in the scope.
+   */
+  ArgumentBinding BindArguments(const std::vector<std::string>& arg_names,
+                                const std::map<std::string, cinn_pod_value_t>* name2podargs = nullptr);
+
   void ExecuteTest(int repeat_);
 
   /**
@@ -73,13 +127,42 @@ class Program {
   const std::vector<std::unique_ptr<Instruction>>& GetPreRunInstructions() { return prerun_instrs_; }
   const std::vector<std::unique_ptr<Instruction>>& GetRunInstructions() { return instrs_; }
 
+  /**
+   * Compile the lazy functions of the next instructions in background while executing the program.
+   * @param num_instrs The number of instructions to compile ahead, 0 means no prefetching.
+   */
+  void SetLazyJitPrefetch(int num_instrs);
+
+  // keep \p holder alive as long as the program, such as the compiler owning the code of the instructions
+  void KeepAlive(std::shared_ptr<void> holder) { holders_.push_back(std::move(holder)); }
+
  private:
+  // the objects used by the instructions, declared first to be destroyed last
+  std::vector<std::shared_ptr<void>> holders_;
   // We need to hold scope to assure tensors alive used in instructions.
   std::shared_ptr<Scope> scope_;
   // prerun instructions
   std::vector<std::unique_ptr<Instruction>> prerun_instrs_;
   // only runtime instructions
   std::vector<std::unique_ptr<Instruction>> instrs_;
+
+  // build the dependencies between instructions according to the order they read and write variables
+  void BuildDependencyGraph();
+
+  // the indices of the instructions that can run only after the i-th instruction finished
+  std::vector<std::vector<int>> successors_;
+  // the number of instructions that the i-th instruction depends on
+  std::vector<int> num_predecessors_;
+  std::unique_ptr<utils::ThreadPool> thread_pool_;
+
+  // submit the instructions in [begin, begin + prefetch_num_) which are not materialized to the prefetch pool
+  void PrefetchInstructions(int begin);
+
+  int prefetch_num_{0};
+  // the end of the instructions already submitted to prefetch
+  int prefetch_end_{0};
+  // declared last to be destroyed first, as the running tasks access the instructions
+  std::unique_ptr<utils::ThreadPool> prefetch_pool_;
 };
 
 /**
@@ -92,6 +175,8 @@ class GraphCompiler final {
 
   struct CompilationResult {
     std::unique_ptr<Program> runtime_program;
+    // the object code of the functions of the program, only kept if CompileOptions::export_object is set
+    std::string object;
   };
 
   struct CompileOptions {
@@ -99,12 +184,25 @@ class GraphCompiler final {
     bool with_instantiate_variables              = false;
     bool with_buffer_handle_instruction_inserted = false;
     bool remove_unused_variables                 = true;
+    // pack the intermediate variables into a single preallocated arena according to their
+    // lifetimes, so no memory allocation happens when executing the program
+    bool with_static_memory_plan = false;
     // nodes group, it may come from the result of op fusion or graph tuning.
     // nodes in a group will be built into an Instruction
     std::vector<std::shared_ptr<Graph::Group>> groups;
     // corresponding LoweredFuncs of above grouped nodes,
     // if it is empty then graph_compiler will generate for them
     std::vector<std::vector<ir::LoweredFunc>> lowered_funcs;
+    // delay the JIT compilation of every function until its instruction runs for the first time,
+    // works best with execution_options.num_compile_threads > 0 so the functions are compiled one by one
+    bool with_lazy_jit = false;
+    // the number of the next instructions to compile in background while executing, only for with_lazy_jit
+    int lazy_jit_prefetch = 0;
+    // the options of the LLVM optimization and code generation, such as fast-math and the target CPU
+    backends::ExecutionOptions execution_options;
+    // keep the object code in the result, so the functions can be loaded into another process, only supported
+    // on the CPU target without compile threads
+    bool export_object = false;
 
     // apply results of auto-tune to compile
     void Apply(const auto_schedule::TuningResult& tuning_result);
@@ -124,6 +222,8 @@ class GraphCompiler final {
 
   const std::shared_ptr<Scope>& GetScope() const { return scope_; }
 
+  const std::shared_ptr<Graph>& GetGraph() const { return graph_; }
+
  private:
   std::vector<ir::LoweredFunc> GetOpFunc(const std::vector<Node*>& nodes);
 
@@ -165,12 +265,21 @@ class GraphCompiler final {
   // applying on variables after no instruction will use them anymore
   void InsertBufferHandlers(std::vector<std::unique_ptr<Instruction>>* instructions);
 
+  // allocate the memory of all the variables in scope_, the reused variables share the buffers of their sources
+  void InstantiateVariables();
+
+  // plan the memory of the intermediate variables produced by the instructions into one arena,
+  // variables whose lifetimes are disjoint can share the same piece of memory
+  void PlanStaticMemory(const std::vector<std::unique_ptr<Instruction>>& instructions);
+
  private:
   // parallel compiler
   std::shared_ptr<ParallelCompiler> parallel_compiler_;
 
   void ProcessFunction(const std::vector<ir::LoweredFunc>& lowered_funcs);
   void SetSubKernels(Instruction* instr, const std::string& func_name);
+  // set the function to the instruction, it is looked up in the compiler now or lazily according to the options
+  void SetLoweredFunc(Instruction* instr, const std::string& func_name);
   Target target_;
   std::shared_ptr<Graph> graph_;
   std::shared_ptr<Scope> scope_;
@@ -184,8 +293,11 @@ class GraphCompiler final {
   absl::flat_hash_map<std::string, std::string> prefix2full_namemap_;
   // map dst reuse var to the src var sharing buffer
   absl::flat_hash_map<std::string, std::string> reuse_vars_map_;
+  // map the function name of a fused group to the function of the structurally identical group it reuses
+  absl::flat_hash_map<std::string, std::string> reused_func_map_;
 
-  std::unique_ptr<backends::Compiler> compiler_;
+  // shared with the lazy function loaders of the instructions built from it
+  std::shared_ptr<backends::Compiler> compiler_;
   CompileOptions compile_options_;
 
   ir::Module::Builder m_builder_;
@@ -16,6 +16,8 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+
 #include "cinn/frontend/net_builder.h"
 #include "cinn/frontend/optimize.h"
 #include "cinn/frontend/program_pass.h"
@@ -117,6 +119,178 @@ TEST(GraphCompilerTest, TestInsertBufferHandlers) {
             used_variable_names);
 }
 
+TEST(GraphCompilerTest, TestExecuteParallel) {
+  frontend::NetBuilder builder("test");
+  auto a = builder.CreateInput(Float(32), {32, 64}, "A");
+  auto b = builder.CreateInput(Float(32), {32, 64}, "B");
+
+  // two independent branches joined at the end
+  auto c = builder.Relu(builder.Add(a, b));
+  auto d = builder.Exp(builder.Multiply(a, b));
+  auto e = builder.Subtract(c, d);
+
+  auto target  = common::DefaultHostTarget();
+  auto program = builder.Build();
+  auto graph   = Optimize(&program, {}, target);
+  auto scope   = BuildScope(target, graph);
+
+  GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+
+  SetRandData<float>(scope->GetTensor("A"), target);
+  SetRandData<float>(scope->GetTensor("B"), target);
+
+  runtime_program->Execute();
+  auto expected = GetTensorData<float>(scope->GetTensor(e->id), target);
+
+  // clear the output and run again in parallel
+  auto* out_data = scope->GetTensor(e->id)->mutable_data<float>(target);
+  std::fill(out_data, out_data + expected.size(), 0.0f);
+  runtime_program->ExecuteParallel(nullptr, true, 4);
+  auto results = GetTensorData<float>(scope->GetTensor(e->id), target);
+  ASSERT_EQ(results.size(), expected.size());
+  for (int i = 0; i < results.size(); ++i) {
+    ASSERT_FLOAT_EQ(results[i], expected[i]);
+  }
+}
+
+TEST(GraphCompilerTest, TestExecuteParallelWithStaticMemoryPlan) {
+  frontend::NetBuilder builder("test");
+  auto a = builder.CreateInput(Float(32), {32, 64}, "A");
+  auto b = builder.CreateInput(Float(32), {64, 32}, "B");
+
+  // the intermediate variables of the independent branches are short-lived, so the planner aliases them in the arena
+  auto c = builder.Relu(builder.Matmul(a, b));
+  auto d = builder.Exp(builder.Matmul(a, b));
+  auto e = builder.Matmul(builder.Add(c, d), builder.Transpose(builder.Multiply(c, d), {1, 0}));
+
+  auto target  = common::DefaultHostTarget();
+  auto program = builder.Build();
+  auto graph   = Optimize(&program, {}, target);
+
+  auto run = [&](bool with_static_memory_plan, bool parallel) {
+    auto scope = BuildScope(target, graph);
+    GraphCompiler gc(target, scope, graph);
+    GraphCompiler::CompileOptions options;
+    options.with_static_memory_plan = with_static_memory_plan;
+    auto runtime_program            = gc.Build(options, {e->id}).runtime_program;
+
+    std::vector<float> data_a(32 * 64), data_b(64 * 32);
+    for (int i = 0; i < data_a.size(); ++i) {
+      data_a[i] = static_cast<float>(i % 7) / 7;
+      data_b[i] = static_cast<float>(i % 5) / 5;
+    }
+    std::copy(data_a.begin(), data_a.end(), scope->GetTensor("A")->mutable_data<float>(target));
+    std::copy(data_b.begin(), data_b.end(), scope->GetTensor("B")->mutable_data<float>(target));
+    if (parallel) {
+      runtime_program->ExecuteParallel(nullptr, true, 4);
+    } else {
+      runtime_program->Execute();
+    }
+    return GetTensorData<float>(scope->GetTensor(e->id), target);
+  };
+
+  auto expected = run(false, false);
+  // the planned program must not race on the aliased memory, repeat it to catch the missed dependencies
+  for (int repeat = 0; repeat < 10; ++repeat) {
+    auto results = run(true, true);
+    ASSERT_EQ(results.size(), expected.size());
+    for (int i = 0; i < results.size(); ++i) {
+      ASSERT_FLOAT_EQ(results[i], expected[i]);
+    }
+  }
+}
+
+TEST(GraphCompilerTest, TestLazyJitWithPrefetch) {
+  frontend::NetBuilder builder("test");
+  auto a = builder.CreateInput(Float(32), {32, 64}, "A");
+  auto b = builder.CreateInput(Float(32), {64, 32}, "B");
+
+  // the matmuls are not fused, so there are several kernels compiled one by one
+  auto c = builder.Relu(builder.Matmul(a, b));
+  auto d = builder.Exp(builder.Matmul(a, b));
+  auto e = builder.Matmul(builder.Add(c, d), builder.Transpose(c, {1, 0}));
+
+  auto target  = common::DefaultHostTarget();
+  auto program = builder.Build();
+  auto graph   = Optimize(&program, {}, target);
+
+  auto run = [&](bool with_lazy_jit) {
+    auto scope = BuildScope(target, graph);
+    GraphCompiler gc(target, scope, graph);
+    GraphCompiler::CompileOptions options;
+    options.with_lazy_jit                         = with_lazy_jit;
+    options.lazy_jit_prefetch                     = 2;
+    options.execution_options.num_compile_threads = 2;
+    auto runtime_program                          = gc.Build(options, {e->id}).runtime_program;
+    const auto& instrs                            = runtime_program->GetRunInstructions();
+    EXPECT_GT(instrs.size(), 1);
+    if (with_lazy_jit) {
+      // nothing is compiled before the first execution
+      for (const auto& instr : instrs) {
+        EXPECT_FALSE(instr->materialized());
+      }
+    }
+
+    SetRandData<float>(scope->GetTensor("A"), target, 1);
+    SetRandData<float>(scope->GetTensor("B"), target, 2);
+    runtime_program->Execute();
+    for (const auto& instr : instrs) {
+      EXPECT_TRUE(instr->materialized());
+    }
+    return GetTensorData<float>(scope->GetTensor(e->id), target);
+  };
+
+  auto expected = run(false);
+  auto results  = run(true);
+  ASSERT_EQ(results.size(), expected.size());
+  for (int i = 0; i < results.size(); ++i) {
+    ASSERT_FLOAT_EQ(results[i], expected[i]);
+  }
+}
+
+TEST(GraphCompilerTest, TestBindArguments) {
+  frontend::NetBuilder builder("test");
+  frontend::Variable a = builder.CreateInput(Float(32), {32, 64}, "A");
+  frontend::Variable b = builder.CreateInput(Float(32), {32, 64}, "B");
+  auto c = builder.Relu(builder.Add(a, b));
+
+  auto target  = common::DefaultHostTarget();
+  auto program = builder.Build();
+  auto graph   = Optimize(&program, {}, target);
+  auto scope   = BuildScope(target, graph);
+
+  GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+  auto binding         = runtime_program->BindArguments({a->id, b->id, c->id});
+  ASSERT_EQ(binding.size(), 3);
+  ASSERT_EQ(binding.IndexOf(c->id), 2);
+  ASSERT_EQ(binding.IndexOf("unknown"), -1);
+  // the index not found can't be bound
+  ASSERT_DEATH(binding.Bind(-1, cinn_pod_value_t()), "out of range");
+  ASSERT_DEATH(binding.Bind(3, cinn_pod_value_t()), "out of range");
+
+  // feed the buffers owned by the caller for every execution
+  for (int repeat = 0; repeat < 2; ++repeat) {
+    std::vector<Tensor> tensors(3);
+    for (int i = 0; i < 3; ++i) {
+      tensors[i]->Resize(Shape({32, 64}));
+      tensors[i]->mutable_data<float>(target);
+      binding.Bind(i, tensors[i]->buffer());
+    }
+    SetRandData<float>(tensors[0], target);
+    SetRandData<float>(tensors[1], target);
+    runtime_program->Execute();
+
+    auto data_a = GetTensorData<float>(tensors[0], target);
+    auto data_b = GetTensorData<float>(tensors[1], target);
+    auto data_c = GetTensorData<float>(tensors[2], target);
+    for (int i = 0; i < data_c.size(); ++i) {
+      ASSERT_FLOAT_EQ(data_c[i], std::max(data_a[i] + data_b[i], 0.0f));
+    }
+  }
+}
+
 #ifdef CINN_WITH_CUDA
 std::vector<float> test_mul(
     const std::vector<float>& A, const std::vector<float>& B, int M, int K, int N, bool trans_a, bool trans_b) {
@@ -66,6 +66,25 @@ void Instruction::Finalize() {
   finalized_flag_ = true;
 }
 
+void Instruction::Materialize() {
+  if (materialized_.load(std::memory_order_acquire)) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(materialize_mtx_);
+  // double check as another thread may have done it while waiting for the lock
+  if (materialized_.load(std::memory_order_relaxed)) {
+    return;
+  }
+  utils::RecordEvent record_materialize("Materialize");
+  for (auto& loader : fn_loaders_) {
+    VLOG(3) << "JIT compile function " << fn_names_[loader.first] << " of instruction " << function_name_;
+    fn_ptrs_[loader.first] = loader.second();
+    CHECK(fn_ptrs_[loader.first]) << "Failed to JIT compile the function " << fn_names_[loader.first];
+  }
+  fn_loaders_.clear();
+  materialized_.store(true, std::memory_order_release);
+}
+
 void Instruction::Run(const std::map<std::string, cinn_pod_value_t>* name2podargs,
                       bool dryrun,
                       void* stream,
@@ -78,6 +97,7 @@ void Instruction::Run(const std::map<std::string, cinn_pod_value_t>* name2podarg
   }
 
   VLOG(2) << "Run function " << function_name_;
+  Materialize();
 
   {
     utils::RecordEvent record_args("PrepareArgs");
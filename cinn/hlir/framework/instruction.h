@@ -14,7 +14,10 @@
 
 #pragma once
 
+#include <atomic>
+#include <functional>
 #include <map>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
@@ -39,6 +42,8 @@ namespace framework {
 class Instruction {
  public:
   using infershape_t = std::function<void(Scope*, const std::vector<std::string>&)>;
+  // the handler returning the JIT-compiled function address, it is called when the function is first needed
+  using fn_loader_t = std::function<void*()>;
 
   /**
    * Constructor.
@@ -64,6 +69,23 @@ class Instruction {
     fn_names_.push_back(name);
   }
 
+  /**
+   * Set a function which is JIT-compiled lazily, on the first run of the instruction or by Materialize.
+   * @param loader The handler to compile the function and return its address.
+   */
+  void SetLazyLoweredFunc(fn_loader_t loader, const std::string& name = "") {
+    fn_loaders_.emplace_back(fn_ptrs_.size(), std::move(loader));
+    fn_ptrs_.push_back(nullptr);
+    fn_names_.push_back(name);
+    materialized_ = false;
+  }
+
+  // compile the lazy functions and fill their addresses, it is thread-safe and only takes effect once
+  void Materialize();
+
+  // whether all the function addresses are available
+  bool materialized() const { return materialized_.load(std::memory_order_acquire); }
+
   // explicitly finalize the instruction, and can't append function again after call it
   void Finalize();
 
@@ -77,6 +99,7 @@ class Instruction {
            bool use_cache                                              = true);
 
   void PreRun(const std::map<std::string, cinn_pod_value_t>* name2podargs = nullptr) {
+    Materialize();
     CHECK_EQ(fn_ptrs_.size(), 4);
     if (fn_ptrs_.size() > 1 && fn_ptrs_.size() != in_args_.size()) {
       out_args_.back()[0] = out_args_.front()[0];
@@ -117,11 +140,20 @@ class Instruction {
 
   int size() { return fn_ptrs_.size(); }
 
+  // the address of the arg_idx-th argument of the fn_idx-th function in the arguments cache,
+  // it becomes invalid once the cache is rebuilt
+  cinn_pod_value_t* GetCachedArg(int fn_idx, int arg_idx) {
+    CHECK_LT(fn_idx, args_cached_.size()) << "The arguments cache should be built first by UpdateArgsCache";
+    CHECK_LT(arg_idx, args_cached_[fn_idx].size());
+    return &args_cached_[fn_idx][arg_idx];
+  }
+
   std::vector<std::vector<std::string>> GetInArgs() { return in_args_; }
   std::vector<std::vector<std::string>> GetOutArgs() { return out_args_; }
   void ClearInArgs() { in_args_.clear(); }
   void ClearOutArgs() { out_args_.clear(); }
   std::vector<std::string> GetFnNames() { return fn_names_; }
+  const std::string& GetFunctionName() const { return function_name_; }
   void AddInArgs(const std::vector<std::string>& in_args) { in_args_.push_back(in_args); }
   void AddOutArgs(const std::vector<std::string>& out_args) { out_args_.push_back(out_args); }
   std::vector<int> attrs;
@@ -143,6 +175,11 @@ class Instruction {
 
   std::vector<void*> fn_ptrs_{};
   std::vector<std::string> fn_names_;
+
+  // the functions to be compiled lazily, indexed by their positions in fn_ptrs_
+  std::vector<std::pair<int, fn_loader_t>> fn_loaders_;
+  std::atomic<bool> materialized_{true};
+  std::mutex materialize_mtx_;
 };
 
 }  // namespace framework
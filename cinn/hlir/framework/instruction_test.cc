@@ -96,6 +96,39 @@ TEST(Instruction, basic) {
   }
 }
 
+TEST(Instruction, LazyLoweredFunc) {
+  const int M = 10;
+  const int N = 20;
+
+  Scope scope;
+  InstantiateScope(M, N, &scope);
+  Instruction instr(common::DefaultHostTarget(), &scope, {"x", "y"}, {"z"});
+  auto jit       = GetLoweredFunc(M, N);
+  int num_loaded = 0;
+  instr.SetLazyLoweredFunc(
+      [&]() {
+        ++num_loaded;
+        return reinterpret_cast<void*>(jit->Lookup("fn"));
+      },
+      "fn");
+  instr.Finalize();
+  // the function is not looked up until the instruction runs
+  ASSERT_FALSE(instr.materialized());
+  ASSERT_EQ(num_loaded, 0);
+
+  instr.Run();
+  instr.Run();
+  ASSERT_TRUE(instr.materialized());
+  ASSERT_EQ(num_loaded, 1);
+
+  auto* xd = scope.GetTensor("x")->data<float>();
+  auto* yd = scope.GetTensor("y")->data<float>();
+  auto* zd = scope.GetTensor("z")->data<float>();
+  for (int i = 0; i < M * N; i++) {
+    ASSERT_NEAR(xd[i] + yd[i], zd[i], 1e-5);
+  }
+}
+
 TEST(Instruction, RunWithRawPodArgs) {
   const int M       = 10;
   const int N       = 20;
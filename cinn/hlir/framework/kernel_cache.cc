@@ -0,0 +1,249 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/kernel_cache.h"
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <iterator>
+#include <limits>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "cinn/hlir/framework/op.h"
+
+DECLARE_int32(cinn_kernel_cache_capacity);
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+namespace {
+
+// print an attribute without losing precision, the strings are prefixed with their length to avoid ambiguity
+struct AttrPrinter {
+  std::ostream* os;
+
+  void Print(bool v) const { *os << (v ? "true" : "false"); }
+  void Print(int v) const { *os << v; }
+  void Print(int64_t v) const { *os << v << "l"; }
+  void Print(float v) const { *os << std::setprecision(std::numeric_limits<float>::max_digits10) << v << "f"; }
+  void Print(double v) const { *os << std::setprecision(std::numeric_limits<double>::max_digits10) << v << "d"; }
+  void Print(const std::string& v) const { *os << v.size() << ":" << v; }
+
+  template <typename T>
+  void operator()(const T& v) const {
+    Print(v);
+  }
+  template <typename T>
+  void operator()(const std::vector<T>& v) const {
+    *os << "[";
+    for (const auto& item : v) {
+      Print(static_cast<T>(item));
+      *os << ",";
+    }
+    *os << "]";
+  }
+};
+
+std::string AttrMapToString(const utils::AttributeMap& attrs) {
+  std::vector<std::string> keys;
+  for (const auto& attr : attrs) {
+    keys.push_back(attr.first);
+  }
+  std::sort(keys.begin(), keys.end());
+
+  std::stringstream ss;
+  ss << "{";
+  for (const auto& key : keys) {
+    ss << key << "=";
+    absl::visit(AttrPrinter{&ss}, attrs.at(key));
+    ss << ";";
+  }
+  ss << "}";
+  return ss.str();
+}
+
+}  // namespace
+
+GroupFingerprint GroupFingerprint::Compute(const std::shared_ptr<Graph::Group>& group,
+                                           const absl::flat_hash_map<std::string, Type>& type_dict,
+                                           const absl::flat_hash_map<std::string, shape_t>& shape_dict,
+                                           const common::Target& target) {
+  GroupFingerprint fingerprint;
+  std::unordered_map<std::string, int> var_ids;
+  std::stringstream ss;
+
+  // number the variable on its first visit, and record its dtype and shape only at that time
+  auto visit_var = [&](NodeData* var) {
+    auto it = var_ids.find(var->id());
+    if (it != var_ids.end()) {
+      ss << "%" << it->second;
+      return;
+    }
+    int id = fingerprint.var_names.size();
+    var_ids.emplace(var->id(), id);
+    fingerprint.var_names.push_back(var->id());
+    ss << "%" << id << "<";
+    if (type_dict.count(var->id())) {
+      ss << type_dict.at(var->id());
+    }
+    ss << "|";
+    if (shape_dict.count(var->id())) {
+      for (auto dim : shape_dict.at(var->id())) {
+        ss << dim << ",";
+      }
+    }
+    ss << ">";
+  };
+
+  ss << target << "|" << static_cast<int>(group->op_pattern_kind) << "|";
+
+  // the nodes and their roles in the sub-groups, the nodes are collected in the same order as OpLowerer
+  std::vector<std::pair<std::shared_ptr<Graph::Group>, Node*>> nodes;
+  if (group->fused_sub_groups.empty()) {
+    for (auto* node : group->nodes) {
+      nodes.emplace_back(group, node);
+    }
+  } else {
+    for (auto& sub_group : group->fused_sub_groups) {
+      for (auto* node : sub_group->nodes) {
+        nodes.emplace_back(sub_group, node);
+      }
+    }
+  }
+  std::unordered_set<Node*> nodes_set;
+  for (auto& node : nodes) {
+    nodes_set.insert(node.second);
+  }
+
+  std::shared_ptr<Graph::Group> last_group;
+  for (auto& iter : nodes) {
+    auto& sub_group = iter.first;
+    auto* node      = iter.second;
+    if (sub_group != last_group) {
+      ss << "group(" << static_cast<int>(sub_group->op_pattern_kind) << "):";
+      last_group = sub_group;
+    }
+
+    ss << node->op()->name << AttrMapToString(node->attrs.attr_store);
+    ss << (group->output_nodes.count(node) ? "O" : "") << (group->internal_nodes.count(node) ? "I" : "")
+       << (group->master_nodes.count(node) ? "M" : "");
+    if (sub_group != group) {
+      ss << "/" << (sub_group->output_nodes.count(node) ? "O" : "")
+         << (sub_group->internal_nodes.count(node) ? "I" : "") << (sub_group->master_nodes.count(node) ? "M" : "");
+    }
+
+    ss << "(";
+    for (auto& link : node->inlinks_in_order()) {
+      auto* var = link->source()->safe_as<NodeData>();
+      CHECK(var) << "The input of node " << node->id() << " should be NodeData!";
+      visit_var(var);
+      ss << ",";
+    }
+    ss << ")->(";
+    for (auto& link : node->outlinks_in_order()) {
+      auto* var = link->sink()->safe_as<NodeData>();
+      CHECK(var) << "The output of node " << node->id() << " should be NodeData!";
+      visit_var(var);
+      // whether the output is used outside the group
+      bool used_outside = false;
+      for (auto& out_link : var->outlinks()) {
+        auto* consumer = out_link->sink()->safe_as<Node>();
+        if (consumer && !nodes_set.count(consumer)) {
+          used_outside = true;
+          break;
+        }
+      }
+      ss << (used_outside ? "!" : "") << ",";
+    }
+    ss << ");";
+  }
+
+  fingerprint.key = ss.str();
+  return fingerprint;
+}
+
+int GroupFingerprint::IndexOf(const std::string& var_name) const {
+  auto it = std::find(var_names.begin(), var_names.end(), var_name);
+  return it == var_names.end() ? -1 : static_cast<int>(it - var_names.begin());
+}
+
+bool GroupFingerprint::MapNames(const GroupFingerprint& src,
+                                const std::vector<std::string>& names,
+                                std::vector<std::string>* mapped_names) const {
+  CHECK_EQ(src.key, key) << "Can not map the names between groups with different fingerprints!";
+  mapped_names->clear();
+  for (const auto& name : names) {
+    int index = src.IndexOf(name);
+    if (index < 0) {
+      return false;
+    }
+    mapped_names->push_back(var_names.at(index));
+  }
+  return true;
+}
+
+KernelCache& KernelCache::Global() {
+  static KernelCache instance;
+  return instance;
+}
+
+std::shared_ptr<KernelCache::Kernel> KernelCache::Find(const std::string& key) const {
+  std::lock_guard<std::mutex> lock(mu_);
+  auto it = kernels_.find(key);
+  if (it == kernels_.end()) {
+    return nullptr;
+  }
+  lru_keys_.splice(lru_keys_.end(), lru_keys_, it->second.second);
+  return it->second.first;
+}
+
+void KernelCache::Insert(const std::string& key, std::shared_ptr<Kernel> kernel) {
+  CHECK(kernel && kernel->fn_ptr) << "Can not cache an empty kernel!";
+  std::lock_guard<std::mutex> lock(mu_);
+  auto it = kernels_.find(key);
+  if (it != kernels_.end()) {
+    lru_keys_.splice(lru_keys_.end(), lru_keys_, it->second.second);
+    return;
+  }
+  lru_keys_.push_back(key);
+  kernels_.emplace(key, std::make_pair(std::move(kernel), std::prev(lru_keys_.end())));
+
+  size_t capacity = FLAGS_cinn_kernel_cache_capacity > 0 ? FLAGS_cinn_kernel_cache_capacity : kernels_.size();
+  while (kernels_.size() > capacity) {
+    VLOG(3) << "Evict the kernel " << kernels_.at(lru_keys_.front()).first->func_name << " from the kernel cache";
+    kernels_.erase(lru_keys_.front());
+    lru_keys_.pop_front();
+  }
+}
+
+void KernelCache::Clear() {
+  std::lock_guard<std::mutex> lock(mu_);
+  kernels_.clear();
+  lru_keys_.clear();
+}
+
+size_t KernelCache::size() const {
+  std::lock_guard<std::mutex> lock(mu_);
+  return kernels_.size();
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
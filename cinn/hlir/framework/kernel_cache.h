@@ -0,0 +1,108 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <absl/container/flat_hash_map.h>
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "cinn/common/macros.h"
+#include "cinn/common/target.h"
+#include "cinn/common/type.h"
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/ir/lowered_func.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+/**
+ * The canonical fingerprint of a fused group.
+ *
+ * The fingerprint records the op types, attributes, dtypes and shapes of the nodes in a group, the fusion
+ * pattern and how the nodes are connected, but not the names of nodes and variables. The variables are
+ * numbered by the order they are visited, so two groups with the same key compute the same function on
+ * their variables with the same canonical indices, and can share one compiled kernel.
+ */
+struct GroupFingerprint {
+  std::string key;
+  // the variable names of the group indexed by their canonical indices
+  std::vector<std::string> var_names;
+
+  static GroupFingerprint Compute(const std::shared_ptr<Graph::Group>& group,
+                                  const absl::flat_hash_map<std::string, Type>& type_dict,
+                                  const absl::flat_hash_map<std::string, shape_t>& shape_dict,
+                                  const common::Target& target);
+
+  // the canonical index of a variable, -1 if the variable does not belong to the group
+  int IndexOf(const std::string& var_name) const;
+
+  // map the names of \p names in the group of \p src to the variables with the same canonical indices in
+  // this group, return false if any name can not be mapped
+  bool MapNames(const GroupFingerprint& src,
+                const std::vector<std::string>& names,
+                std::vector<std::string>* mapped_names) const;
+};
+
+/**
+ * KernelCache maps the fingerprints of fused groups to the kernels compiled for them, so the structurally
+ * identical groups, such as the repeated blocks of a model, are lowered and compiled only once in a process.
+ * At most FLAGS_cinn_kernel_cache_capacity kernels are kept, the least recently used ones are evicted, while
+ * the programs using an evicted kernel still keep it alive.
+ */
+class KernelCache {
+ public:
+  struct Kernel {
+    // the fingerprint of the group which the kernel is compiled from
+    GroupFingerprint fingerprint;
+    // the input and output variable names of the group, in the order of the kernel arguments
+    std::vector<std::string> input_names;
+    std::vector<std::string> output_names;
+    std::string func_name;
+    void* fn_ptr{nullptr};
+    // the objects to keep alive as long as fn_ptr is used, such as the JIT engine holding the code
+    std::vector<std::shared_ptr<void>> holders;
+  };
+
+  static KernelCache& Global();
+
+  // find the kernel of the key, return null if not exists
+  std::shared_ptr<Kernel> Find(const std::string& key) const;
+
+  // the key should identify both the fingerprint of the group and the options the kernel is compiled with
+  void Insert(const std::string& key, std::shared_ptr<Kernel> kernel);
+
+  void Clear();
+
+  size_t size() const;
+
+ private:
+  KernelCache() = default;
+
+  mutable std::mutex mu_;
+  // the keys ordered from the least recently used to the most recently used
+  mutable std::list<std::string> lru_keys_;
+  absl::flat_hash_map<std::string, std::pair<std::shared_ptr<Kernel>, std::list<std::string>::iterator>> kernels_;
+
+  CINN_DISALLOW_COPY_AND_ASSIGN(KernelCache);
+};
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,175 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/kernel_cache.h"
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include "cinn/common/target.h"
+#include "cinn/frontend/net_builder.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/op/use_ops.h"
+#include "cinn/hlir/pass/use_pass.h"
+#include "cinn/utils/data_util.h"
+
+DECLARE_int32(cinn_parallel_compile_size);
+DECLARE_bool(cinn_enable_kernel_cache);
+DECLARE_int32(cinn_kernel_cache_capacity);
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+TEST(GroupFingerprint, StructurallyIdenticalGroups) {
+  frontend::NetBuilder builder("StructurallyIdenticalGroups");
+  frontend::Variable A = builder.CreateInput(Float(32), {32, 64}, "A");
+  frontend::Variable B = builder.CreateInput(Float(32), {32, 64}, "B");
+  auto C = builder.Add(A, B);
+  auto D = builder.Add(C, B);
+  auto E = builder.Relu(D);
+
+  auto target  = common::DefaultHostTarget();
+  auto program = builder.Build();
+  auto graph   = std::make_shared<Graph>(program, target);
+  ApplyPasses(graph.get(), {"BuildNonFusedGroupsPass"});
+  ASSERT_EQ(graph->fusion_groups.size(), 3);
+
+  auto& dtype_dict = graph->GetMutableAttrs<absl::flat_hash_map<std::string, Type>>("inferdtype");
+  auto& shape_dict = graph->GetMutableAttrs<absl::flat_hash_map<std::string, shape_t>>("infershape");
+  // the fingerprints indexed by the output of the groups
+  absl::flat_hash_map<std::string, GroupFingerprint> fingerprints;
+  absl::flat_hash_map<std::string, std::shared_ptr<Graph::Group>> groups;
+  for (auto& group : graph->fusion_groups) {
+    auto* out = group->nodes.front()->outlinks_in_order().front()->sink()->safe_as<NodeData>();
+    fingerprints.emplace(out->id(), GroupFingerprint::Compute(group, dtype_dict, shape_dict, target));
+    groups.emplace(out->id(), group);
+  }
+
+  // A + B and C + B share one kernel, but relu does not
+  EXPECT_EQ(fingerprints.at(C->id).key, fingerprints.at(D->id).key);
+  EXPECT_NE(fingerprints.at(C->id).key, fingerprints.at(E->id).key);
+
+  // the arguments are mapped by their positions in the groups
+  std::vector<std::string> mapped_names;
+  ASSERT_TRUE(fingerprints.at(D->id).MapNames(fingerprints.at(C->id), {A->id, B->id, C->id}, &mapped_names));
+  EXPECT_EQ(mapped_names, std::vector<std::string>({C->id, B->id, D->id}));
+  EXPECT_FALSE(fingerprints.at(D->id).MapNames(fingerprints.at(C->id), {E->id}, &mapped_names));
+
+  // the shapes are part of the fingerprint
+  shape_dict[C->id]    = {64, 32};
+  shape_dict[D->id]    = {64, 32};
+  auto new_fingerprint = GroupFingerprint::Compute(groups.at(D->id), dtype_dict, shape_dict, target);
+  EXPECT_NE(new_fingerprint.key, fingerprints.at(C->id).key);
+}
+
+TEST(KernelCache, FindAndInsert) {
+  auto& cache = KernelCache::Global();
+  cache.Clear();
+  EXPECT_EQ(cache.Find("fingerprint"), nullptr);
+
+  int dummy_func      = 0;
+  auto kernel         = std::make_shared<KernelCache::Kernel>();
+  kernel->func_name   = "fn_dummy";
+  kernel->fn_ptr      = &dummy_func;
+  kernel->input_names = {"x"};
+  cache.Insert("fingerprint", kernel);
+  ASSERT_EQ(cache.size(), 1);
+  EXPECT_EQ(cache.Find("fingerprint")->fn_ptr, &dummy_func);
+
+  cache.Clear();
+  EXPECT_EQ(cache.size(), 0);
+}
+
+TEST(KernelCache, EvictLeastRecentlyUsed) {
+  auto& cache                      = KernelCache::Global();
+  auto capacity                    = FLAGS_cinn_kernel_cache_capacity;
+  FLAGS_cinn_kernel_cache_capacity = 2;
+  cache.Clear();
+
+  int dummy_func = 0;
+  auto kernel    = std::make_shared<KernelCache::Kernel>();
+  kernel->fn_ptr = &dummy_func;
+  cache.Insert("k0", kernel);
+  cache.Insert("k1", kernel);
+  // k0 becomes the most recently used one, so k1 is evicted
+  ASSERT_NE(cache.Find("k0"), nullptr);
+  cache.Insert("k2", kernel);
+  EXPECT_EQ(cache.size(), 2);
+  EXPECT_NE(cache.Find("k0"), nullptr);
+  EXPECT_EQ(cache.Find("k1"), nullptr);
+  EXPECT_NE(cache.Find("k2"), nullptr);
+
+  FLAGS_cinn_kernel_cache_capacity = capacity;
+  cache.Clear();
+}
+
+TEST(KernelCache, ReuseAcrossGraphs) {
+  auto parallel_compile_size       = FLAGS_cinn_parallel_compile_size;
+  auto enable_kernel_cache         = FLAGS_cinn_enable_kernel_cache;
+  FLAGS_cinn_parallel_compile_size = 1;
+  FLAGS_cinn_enable_kernel_cache   = true;
+  KernelCache::Global().Clear();
+
+  frontend::NetBuilder builder("ReuseAcrossGraphs");
+  frontend::Variable A = builder.CreateInput(Float(32), {32, 64}, "A");
+  frontend::Variable B = builder.CreateInput(Float(32), {32, 64}, "B");
+  auto C = builder.Add(A, B);
+  auto D = builder.Add(C, B);
+  auto E = builder.Relu(D);
+
+  auto target  = common::DefaultHostTarget();
+  auto program = builder.Build();
+  auto run     = [&](const backends::ExecutionOptions& execution_options) {
+    auto graph = std::make_shared<Graph>(program, target);
+    auto scope = BuildScope(target, graph);
+    GraphCompiler gc(target, scope, graph);
+    GraphCompiler::CompileOptions options;
+    options.execution_options = execution_options;
+    auto runtime_program      = gc.Build(options, {E->id}).runtime_program;
+
+    SetRandData<float>(scope->GetTensor(A->id), target, 1);
+    SetRandData<float>(scope->GetTensor(B->id), target, 2);
+    runtime_program->Execute();
+    auto data_a = GetTensorData<float>(scope->GetTensor(A->id), target);
+    auto data_b = GetTensorData<float>(scope->GetTensor(B->id), target);
+    auto data_e = GetTensorData<float>(scope->GetTensor(E->id), target);
+    for (int i = 0; i < data_e.size(); ++i) {
+      EXPECT_FLOAT_EQ(data_e[i], std::max(data_a[i] + data_b[i] + data_b[i], 0.0f));
+    }
+  };
+
+  // the two additions share one kernel
+  backends::ExecutionOptions execution_options;
+  run(execution_options);
+  ASSERT_EQ(KernelCache::Global().size(), 2);
+  // the second graph reuses all the kernels of the first one
+  run(execution_options);
+  ASSERT_EQ(KernelCache::Global().size(), 2);
+  // the kernels compiled with different options are not reused
+  execution_options.enable_fast_math = true;
+  run(execution_options);
+  ASSERT_EQ(KernelCache::Global().size(), 4);
+
+  FLAGS_cinn_parallel_compile_size = parallel_compile_size;
+  FLAGS_cinn_enable_kernel_cache   = enable_kernel_cache;
+  KernelCache::Global().Clear();
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -14,6 +14,14 @@
 
 #include "cinn/hlir/framework/memory.h"
 
+#include <gflags/gflags.h>
+
+#include <algorithm>
+#include <limits>
+#include <string>
+
+#include "cinn/utils/string.h"
+
 #ifdef CINN_WITH_CUDA
 #include <cuda.h>
 #include <cuda_runtime.h>
@@ -21,12 +29,111 @@
 #include "cinn/backends/cuda_util.h"
 #endif
 
+DECLARE_string(cinn_caching_allocator_archs);
+DECLARE_int64(cinn_caching_allocator_max_cached_mb);
+
 namespace cinn {
 namespace hlir {
 namespace framework {
 
 using common::Target;
 
+namespace {
+// blocks smaller than it are rounded up to it
+constexpr size_t kMinBlockSize = 256;
+// blocks larger than it are rounded up to a multiple of it instead of a power of 2
+constexpr size_t kLargeBlockSize = 1 << 20;
+}  // namespace
+
+CachingMemoryMng::CachingMemoryMng(std::unique_ptr<MemoryInterface> underlying, size_t max_cached_bytes)
+    : underlying_(std::move(underlying)), max_cached_bytes_(max_cached_bytes) {
+  CHECK(underlying_) << "The underlying MemoryInterface of CachingMemoryMng should not be null";
+}
+
+CachingMemoryMng::~CachingMemoryMng() { ReleaseCache(); }
+
+size_t CachingMemoryMng::RoundUpSize(size_t nbytes) {
+  if (nbytes <= kMinBlockSize) {
+    return kMinBlockSize;
+  }
+  if (nbytes > kLargeBlockSize) {
+    return (nbytes + kLargeBlockSize - 1) / kLargeBlockSize * kLargeBlockSize;
+  }
+  size_t size = kMinBlockSize;
+  while (size < nbytes) {
+    size <<= 1;
+  }
+  return size;
+}
+
+void* CachingMemoryMng::malloc(size_t nbytes) { return Allocate(0, nbytes); }
+
+void* CachingMemoryMng::aligned_alloc(size_t alignment, size_t nbytes) { return Allocate(alignment, nbytes); }
+
+void* CachingMemoryMng::Allocate(size_t alignment, size_t nbytes) {
+  BlockKey key(RoundUpSize(nbytes), alignment);
+  std::lock_guard<std::mutex> lock(mu_);
+  void* data = nullptr;
+  auto it    = free_blocks_.find(key);
+  if (it != free_blocks_.end() && !it->second.empty()) {
+    data = it->second.back();
+    it->second.pop_back();
+    stats_.cached_bytes -= key.first;
+    ++stats_.hits;
+  } else {
+    data = alignment ? underlying_->aligned_alloc(alignment, key.first) : underlying_->malloc(key.first);
+    if (!data && stats_.cached_bytes > 0) {
+      // retry after releasing the cached blocks
+      ReleaseCacheUnlocked();
+      data = alignment ? underlying_->aligned_alloc(alignment, key.first) : underlying_->malloc(key.first);
+    }
+    if (!data) {
+      return nullptr;
+    }
+    ++stats_.misses;
+  }
+  allocated_blocks_.emplace(data, key);
+  stats_.allocated_bytes += key.first;
+  stats_.peak_bytes = std::max(stats_.peak_bytes, stats_.allocated_bytes + stats_.cached_bytes);
+  return data;
+}
+
+void CachingMemoryMng::free(void* data) {
+  if (!data) return;
+  std::lock_guard<std::mutex> lock(mu_);
+  auto it = allocated_blocks_.find(data);
+  CHECK(it != allocated_blocks_.end()) << "The memory to be freed is not allocated by this CachingMemoryMng";
+  BlockKey key = it->second;
+  allocated_blocks_.erase(it);
+  stats_.allocated_bytes -= key.first;
+  if (stats_.cached_bytes + key.first > max_cached_bytes_) {
+    underlying_->free(data);
+    return;
+  }
+  free_blocks_[key].push_back(data);
+  stats_.cached_bytes += key.first;
+}
+
+void CachingMemoryMng::ReleaseCache() {
+  std::lock_guard<std::mutex> lock(mu_);
+  ReleaseCacheUnlocked();
+}
+
+void CachingMemoryMng::ReleaseCacheUnlocked() {
+  for (auto& key2blocks : free_blocks_) {
+    for (void* data : key2blocks.second) {
+      underlying_->free(data);
+    }
+  }
+  free_blocks_.clear();
+  stats_.cached_bytes = 0;
+}
+
+CachingMemoryMng::Stats CachingMemoryMng::GetStats() const {
+  std::lock_guard<std::mutex> lock(mu_);
+  return stats_;
+}
+
 namespace {
 
 class X86MemoryMng : public MemoryInterface {
@@ -56,10 +163,31 @@ class CudaMemoryMng : public MemoryInterface {
 }  // namespace
 
 MemoryManager::MemoryManager() {
+  // the architectures whose memory is managed by a caching allocator
+  std::vector<std::string> caching_archs;
+  if (!FLAGS_cinn_caching_allocator_archs.empty()) {
+    caching_archs = utils::Split(FLAGS_cinn_caching_allocator_archs, ",");
+  }
+  // bound the freed memory kept by each caching allocator, so the memory at the peak isn't held forever
+  size_t max_cached_bytes = FLAGS_cinn_caching_allocator_max_cached_mb < 0
+                                ? std::numeric_limits<size_t>::max()
+                                : static_cast<size_t>(FLAGS_cinn_caching_allocator_max_cached_mb) << 20;
+
+  auto maybe_caching = [&](key_t key, const std::string& arch_name, MemoryInterface* item) -> MemoryInterface* {
+    if (std::find(caching_archs.begin(), caching_archs.end(), arch_name) == caching_archs.end()) {
+      return item;
+    }
+    VLOG(3) << "Use CachingMemoryMng for architecture " << arch_name << ", caching at most " << max_cached_bytes
+            << " bytes";
+    auto* caching = new CachingMemoryMng(std::unique_ptr<MemoryInterface>(item), max_cached_bytes);
+    caching_mngs_.emplace(key, caching);
+    return caching;
+  };
+
   Register(Target::Arch::Unk, new X86MemoryMng);
-  Register(Target::Arch::X86, new X86MemoryMng);
+  Register(Target::Arch::X86, maybe_caching(Target::Arch::X86, "x86", new X86MemoryMng));
 #ifdef CINN_WITH_CUDA
-  Register(Target::Arch::NVGPU, new CudaMemoryMng);
+  Register(Target::Arch::NVGPU, maybe_caching(Target::Arch::NVGPU, "nvgpu", new CudaMemoryMng));
 #endif
 }
 
@@ -17,7 +17,11 @@
 #include <absl/container/flat_hash_map.h>
 #include <glog/logging.h>
 
+#include <limits>
 #include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
 
 #include "cinn/common/macros.h"
 #include "cinn/common/target.h"
@@ -34,6 +38,68 @@ class MemoryInterface {
   virtual ~MemoryInterface() {}
 };
 
+/**
+ * CachingMemoryMng is a thread-safe MemoryInterface which keeps the freed memory for reuse.
+ *
+ * Requested sizes are rounded up to size classes, and the freed blocks are cached in a free list for
+ * each pair of size class and alignment, so repeated allocations of the same size are served without
+ * calling the underlying MemoryInterface. The cached blocks are released when the total cached bytes
+ * exceed a limit, or explicitly by calling ReleaseCache.
+ */
+class CachingMemoryMng : public MemoryInterface {
+ public:
+  struct Stats {
+    // the number of allocations served from the cache
+    size_t hits{0};
+    // the number of allocations passed to the underlying allocator
+    size_t misses{0};
+    // the bytes of the freed blocks kept in the cache
+    size_t cached_bytes{0};
+    // the bytes of the blocks returned to users and not freed yet
+    size_t allocated_bytes{0};
+    // the peak of allocated_bytes + cached_bytes
+    size_t peak_bytes{0};
+  };
+
+  /**
+   * Constructor.
+   * @param underlying The allocator to allocate and free the real memory.
+   * @param max_cached_bytes The upper limit of bytes cached, the freed blocks beyond it are released directly.
+   */
+  explicit CachingMemoryMng(std::unique_ptr<MemoryInterface> underlying,
+                            size_t max_cached_bytes = std::numeric_limits<size_t>::max());
+  ~CachingMemoryMng();
+
+  void* malloc(size_t nbytes) override;
+  void free(void* data) override;
+  void* aligned_alloc(size_t alignment, size_t nbytes) override;
+
+  //! Release all the cached blocks to the underlying allocator.
+  void ReleaseCache();
+
+  Stats GetStats() const;
+
+  //! Get the size class which \p nbytes is rounded up to.
+  static size_t RoundUpSize(size_t nbytes);
+
+ private:
+  // a pair of size class and alignment, alignment is 0 for the blocks allocated by malloc
+  using BlockKey = std::pair<size_t, size_t>;
+
+  void* Allocate(size_t alignment, size_t nbytes);
+  void ReleaseCacheUnlocked();
+
+  std::unique_ptr<MemoryInterface> underlying_;
+  size_t max_cached_bytes_;
+
+  mutable std::mutex mu_;
+  absl::flat_hash_map<BlockKey, std::vector<void*>> free_blocks_;
+  absl::flat_hash_map<void*, BlockKey> allocated_blocks_;
+  Stats stats_;
+
+  CINN_DISALLOW_COPY_AND_ASSIGN(CachingMemoryMng);
+};
+
 /**
  * MemoryManager holds a map of MemoryInterface for each articture.
  */
@@ -58,6 +124,12 @@ class MemoryManager final {
     return res;
   }
 
+  //! Get the CachingMemoryMng of the architecture, nullptr if its memory isn't cached.
+  CachingMemoryMng* RetrieveCaching(key_t key) {
+    auto it = caching_mngs_.find(key);
+    return it != caching_mngs_.end() ? it->second : nullptr;
+  }
+
   MemoryInterface* Register(key_t key, MemoryInterface* item) {
     CHECK(!memory_mngs_.count(key)) << "Duplicate register [" << key << "]";
     memory_mngs_[key].reset(item);
@@ -68,6 +140,8 @@ class MemoryManager final {
   MemoryManager();
 
   absl::flat_hash_map<common::Target::Arch, std::unique_ptr<MemoryInterface>> memory_mngs_;
+  // the caching allocators owned by memory_mngs_, created by the flag cinn_caching_allocator_archs
+  absl::flat_hash_map<common::Target::Arch, CachingMemoryMng*> caching_mngs_;
 
   CINN_DISALLOW_COPY_AND_ASSIGN(MemoryManager);
 };
@@ -0,0 +1,82 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/memory_planner.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+namespace {
+size_t AlignUp(size_t value, size_t alignment) { return (value + alignment - 1) / alignment * alignment; }
+}  // namespace
+
+size_t StaticMemoryPlanner::Plan(std::vector<MemoryBlock>* blocks, size_t alignment) {
+  CHECK_GT(alignment, 0) << "alignment should be greater than 0";
+  // visit blocks from the largest one, and the earlier one first if the sizes are equal
+  std::vector<int> order(blocks->size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [blocks](int lhs, int rhs) {
+    const auto& a = blocks->at(lhs);
+    const auto& b = blocks->at(rhs);
+    return a.size != b.size ? a.size > b.size : a.first_use < b.first_use;
+  });
+
+  size_t arena_size = 0;
+  std::vector<const MemoryBlock*> placed;
+  for (int idx : order) {
+    auto& block = blocks->at(idx);
+    // collect the placed blocks alive at the same time, sorted by their offsets
+    std::vector<const MemoryBlock*> conflicts;
+    for (const auto* other : placed) {
+      if (block.OverlapInTime(*other)) {
+        conflicts.push_back(other);
+      }
+    }
+    std::sort(conflicts.begin(), conflicts.end(), [](const MemoryBlock* a, const MemoryBlock* b) {
+      return a->offset < b->offset;
+    });
+
+    // find the smallest gap which can hold the block, or append it to the end
+    size_t best_offset = std::numeric_limits<size_t>::max();
+    size_t best_gap    = std::numeric_limits<size_t>::max();
+    size_t cur_offset  = 0;
+    for (const auto* other : conflicts) {
+      if (other->offset >= cur_offset + block.size) {
+        size_t gap = other->offset - cur_offset;
+        if (gap < best_gap) {
+          best_gap    = gap;
+          best_offset = cur_offset;
+        }
+      }
+      cur_offset = std::max(cur_offset, AlignUp(other->offset + other->size, alignment));
+    }
+    block.offset = best_offset != std::numeric_limits<size_t>::max() ? best_offset : cur_offset;
+    arena_size   = std::max(arena_size, block.offset + block.size);
+    placed.push_back(&block);
+    VLOG(4) << "Plan memory block " << block.name << " of size " << block.size << " alive in [" << block.first_use
+            << ", " << block.last_use << "] at offset " << block.offset;
+  }
+  return AlignUp(arena_size, alignment);
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,64 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+/**
+ * The memory requirement of a variable, it is alive between the first and the last
+ * instruction(both inclusive) which use it.
+ */
+struct MemoryBlock {
+  std::string name;
+  size_t size;
+  int first_use;
+  int last_use;
+  // the offset in the arena, assigned by StaticMemoryPlanner
+  size_t offset{0};
+
+  MemoryBlock(const std::string& name, size_t size, int first_use, int last_use)
+      : name(name), size(size), first_use(first_use), last_use(last_use) {}
+
+  bool OverlapInTime(const MemoryBlock& other) const {
+    return first_use <= other.last_use && other.first_use <= last_use;
+  }
+};
+
+/**
+ * StaticMemoryPlanner packs a set of memory blocks into a single arena.
+ *
+ * Blocks are placed in the descending order of their size, every block is put into the smallest gap
+ * between the blocks already placed and alive at the same time, which is the greedy-by-size
+ * offset assignment. Blocks whose lifetimes are disjoint can share the same piece of memory.
+ */
+class StaticMemoryPlanner {
+ public:
+  /**
+   * Assign the offsets of \p blocks.
+   * @param blocks The memory blocks to be planned, the offset of each one will be set.
+   * @param alignment The alignment of every offset in bytes.
+   * @return The total size of the arena in bytes.
+   */
+  static size_t Plan(std::vector<MemoryBlock>* blocks, size_t alignment);
+};
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
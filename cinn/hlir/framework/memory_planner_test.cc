@@ -0,0 +1,59 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/memory_planner.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+TEST(StaticMemoryPlanner, ReuseDisjointBlocks) {
+  // a -> b -> c: a and c are never alive at the same time
+  std::vector<MemoryBlock> blocks = {{"a", 100, 0, 1}, {"b", 200, 1, 2}, {"c", 64, 2, 3}};
+  size_t arena_size               = StaticMemoryPlanner::Plan(&blocks, 64);
+
+  EXPECT_EQ(blocks[1].offset, 0);
+  EXPECT_EQ(blocks[0].offset, 256);
+  // c reuses the memory of a
+  EXPECT_EQ(blocks[2].offset, 256);
+  EXPECT_EQ(arena_size, 384);
+}
+
+TEST(StaticMemoryPlanner, NoOverlapOfAliveBlocks) {
+  std::vector<MemoryBlock> blocks = {
+      {"a", 128, 0, 5}, {"b", 64, 1, 2}, {"c", 256, 2, 4}, {"d", 64, 3, 5}, {"e", 512, 5, 6}, {"f", 32, 0, 6}};
+  size_t arena_size = StaticMemoryPlanner::Plan(&blocks, 32);
+
+  for (int i = 0; i < blocks.size(); ++i) {
+    EXPECT_EQ(blocks[i].offset % 32, 0);
+    EXPECT_LE(blocks[i].offset + blocks[i].size, arena_size);
+    for (int j = i + 1; j < blocks.size(); ++j) {
+      if (blocks[i].OverlapInTime(blocks[j])) {
+        bool disjoint = blocks[i].offset + blocks[i].size <= blocks[j].offset ||
+                        blocks[j].offset + blocks[j].size <= blocks[i].offset;
+        EXPECT_TRUE(disjoint) << blocks[i].name << " overlaps with " << blocks[j].name;
+      }
+    }
+  }
+  // the arena should be smaller than allocating every block separately
+  EXPECT_LT(arena_size, 128 + 64 + 256 + 64 + 512 + 32);
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
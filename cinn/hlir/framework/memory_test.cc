@@ -0,0 +1,133 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/memory.h"
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+
+DECLARE_string(cinn_caching_allocator_archs);
+DECLARE_int64(cinn_caching_allocator_max_cached_mb);
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+// a host allocator counting the calls
+class CountingMemoryMng : public MemoryInterface {
+ public:
+  void* malloc(size_t nbytes) override {
+    ++num_malloc;
+    return ::malloc(nbytes);
+  }
+  void free(void* data) override {
+    ++num_free;
+    ::free(data);
+  }
+  void* aligned_alloc(size_t alignment, size_t nbytes) override {
+    ++num_malloc;
+    return ::aligned_alloc(alignment, nbytes);
+  }
+
+  int num_malloc = 0;
+  int num_free   = 0;
+};
+
+TEST(CachingMemoryMng, RoundUpSize) {
+  EXPECT_EQ(CachingMemoryMng::RoundUpSize(1), 256);
+  EXPECT_EQ(CachingMemoryMng::RoundUpSize(256), 256);
+  EXPECT_EQ(CachingMemoryMng::RoundUpSize(257), 512);
+  EXPECT_EQ(CachingMemoryMng::RoundUpSize(1 << 20), 1 << 20);
+  EXPECT_EQ(CachingMemoryMng::RoundUpSize((1 << 20) + 1), 2 << 20);
+  EXPECT_EQ(CachingMemoryMng::RoundUpSize((3 << 20) - 1), 3 << 20);
+}
+
+TEST(CachingMemoryMng, ReuseFreedBlocks) {
+  auto* counter = new CountingMemoryMng;
+  CachingMemoryMng caching{std::unique_ptr<MemoryInterface>(counter)};
+
+  void* a = caching.malloc(1000);
+  caching.free(a);
+  // the same size class reuses the freed block
+  void* b = caching.malloc(800);
+  EXPECT_EQ(a, b);
+  EXPECT_EQ(counter->num_malloc, 1);
+
+  // the blocks with different alignment are not mixed up
+  void* c = caching.aligned_alloc(1024, 800);
+  EXPECT_NE(b, c);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(c) % 1024, 0);
+  caching.free(c);
+  void* d = caching.aligned_alloc(1024, 1000);
+  EXPECT_EQ(c, d);
+  EXPECT_EQ(counter->num_malloc, 2);
+
+  auto stats = caching.GetStats();
+  EXPECT_EQ(stats.hits, 2);
+  EXPECT_EQ(stats.misses, 2);
+  EXPECT_EQ(stats.allocated_bytes, 2048);
+  EXPECT_EQ(stats.cached_bytes, 0);
+  EXPECT_EQ(stats.peak_bytes, 2048);
+
+  caching.free(b);
+  caching.free(d);
+  stats = caching.GetStats();
+  EXPECT_EQ(stats.allocated_bytes, 0);
+  EXPECT_EQ(stats.cached_bytes, 2048);
+
+  caching.ReleaseCache();
+  EXPECT_EQ(counter->num_free, 2);
+  EXPECT_EQ(caching.GetStats().cached_bytes, 0);
+}
+
+TEST(CachingMemoryMng, MaxCachedBytes) {
+  auto* counter = new CountingMemoryMng;
+  CachingMemoryMng caching{std::unique_ptr<MemoryInterface>(counter), 512};
+
+  void* a = caching.malloc(512);
+  void* b = caching.malloc(512);
+  caching.free(a);
+  // exceeds the limit and is released directly
+  caching.free(b);
+  EXPECT_EQ(counter->num_free, 1);
+  EXPECT_EQ(caching.GetStats().cached_bytes, 512);
+}
+
+TEST(MemoryManager, CachingByFlags) {
+  // the flags take effect when the global MemoryManager is created
+  FLAGS_cinn_caching_allocator_archs         = "x86";
+  FLAGS_cinn_caching_allocator_max_cached_mb = 1;
+  auto& manager                              = MemoryManager::Global();
+  ASSERT_EQ(manager.RetrieveCaching(common::Target::Arch::Unk), nullptr);
+  auto* caching = manager.RetrieveCaching(common::Target::Arch::X86);
+  ASSERT_NE(caching, nullptr);
+  ASSERT_EQ(manager.Retrieve(common::Target::Arch::X86), caching);
+
+  auto stats = caching->GetStats();
+  void* a    = caching->malloc(1000);
+  void* b    = caching->malloc(2 << 20);
+  caching->free(a);
+  // beyond the limit of 1MB, so it is released directly
+  caching->free(b);
+  EXPECT_EQ(caching->GetStats().cached_bytes, stats.cached_bytes + 1024);
+  caching->ReleaseCache();
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -14,9 +14,17 @@
 
 #include "cinn/hlir/framework/op_lowering.h"
 
+#include "cinn/auto_schedule/tuning_artifact.h"
+#include "cinn/common/cas.h"
+#include "cinn/hlir/framework/kernel_cache.h"
+#include "cinn/ir/ir_arena.h"
+#include "cinn/ir/schedule_desc.h"
 #include "cinn/optim/transform_gpu_forloop.h"
 
 DECLARE_bool(cinn_ir_schedule);
+DECLARE_bool(cinn_enable_ir_arena);
+DECLARE_bool(cinn_ir_hash_consing);
+DECLARE_bool(cinn_enable_cas_simplify_cache);
 
 namespace cinn {
 namespace hlir {
@@ -105,7 +113,18 @@ std::vector<ir::LoweredFunc> OpLowerer::LowerWithoutSchedule(GroupPtr& group) {
 
 std::vector<ir::LoweredFunc> OpLowerer::Lower(GroupPtr& group) {
   VLOG(3) << "Lowering Group : " << group->group_id << " , Op Pattern : " << group->op_pattern_kind;
+  // the lowered functions may outlive the scope, which keeps the chunks they are allocated from
+  ir::IrArenaScope arena_scope(FLAGS_cinn_enable_ir_arena, FLAGS_cinn_ir_hash_consing);
+  common::CasSimplifyCacheScope cas_cache_scope(FLAGS_cinn_enable_cas_simplify_cache);
   if (FLAGS_cinn_ir_schedule) {
+    // apply the schedule tuned offline if the group is tuned
+    const auto* tuning_artifact = auto_schedule::TuningArtifact::Global();
+    if (tuning_artifact) {
+      auto funcs = IRLowerOpWithTuningArtifact(group, *tuning_artifact);
+      if (!funcs.empty()) {
+        return funcs;
+      }
+    }
     switch (group->op_pattern_kind) {
       case framework::kElementWise:
       case framework::kBroadcast:
@@ -221,6 +240,71 @@ std::vector<ir::LoweredFunc> OpLowerer::IRLowerOpWithoutSchedule(IRComputeFuncti
   return {func};
 }
 
+std::vector<ir::LoweredFunc> OpLowerer::IRLowerOpWithTuningArtifact(GroupPtr& group,
+                                                                      const auto_schedule::TuningArtifact& artifact) {
+  auto fingerprint = GroupFingerprint::Compute(group, type_dict_, shape_dict_, target_);
+  if (!artifact.Contains(fingerprint)) {
+    return {};
+  }
+  VLOG(3) << "Lowering Group : " << group->group_id << " with the tuned schedule";
+  // replay the trace on the same ModuleExpr the tuner started from
+  std::vector<ir::LoweredFunc> funcs = LowerWithoutSchedule(group);
+  std::vector<Expr> bodies;
+  for (auto& func : funcs) {
+    bodies.push_back(func->body);
+  }
+  std::vector<Expr> exprs;
+  if (!artifact.Apply(fingerprint, bodies, &exprs)) {
+    VLOG(3) << "Failed to apply the tuned schedule, lower Group : " << group->group_id << " with the default one";
+    return {};
+  }
+  CHECK_EQ(exprs.size(), funcs.size()) << "The replayed ModuleExpr should have one Expr for each function";
+  for (int i = 0; i < funcs.size(); ++i) {
+    funcs[i] = UpdateFuncWithNewBody(target_, funcs[i], exprs[i]);
+  }
+  VLOG(3) << "After replaying the tuned schedule, ir is: \n" << funcs.front();
+  return funcs;
+}
+
+ir::LoweredFunc UpdateFuncWithNewBody(const Target& target, const ir::LoweredFunc& old_func, ir::Expr& body) {
+  ir::ModuleExpr mod_expr(std::vector<ir::Expr>({body}));
+  ir::IRSchedule ir_sch(mod_expr);
+
+  // temp_bufs may be deleted during auto tuning (such as auto inline),
+  // we have to check from old temp bufs and set them as local buffer.
+  for (const ir::Buffer& buf : old_func->temp_bufs) {
+    const std::string& buf_name              = buf->name;
+    std::vector<ir::Expr> all_block_realizes = ir_sch.GetAllBlocks();
+    for (ir::Expr& e : all_block_realizes) {
+      const ir::ScheduleBlockRealize* sche_block_realize = e.As<ir::ScheduleBlockRealize>();
+      const std::string& sche_name = sche_block_realize->schedule_block.As<ir::ScheduleBlock>()->name;
+      if (buf_name == "_" + sche_name) {
+        VLOG(6) << "Set local buffer for temp buffer " << buf_name;
+        ir_sch.SetBuffer(e, "local", true);
+        break;
+      }
+    }
+  }
+
+  ir::Expr updated_body = ir_sch.GetModule().GetExprs()[0];
+#ifdef CINN_WITH_CUDA
+  optim::OptimizeExprGPU(&updated_body);
+#endif
+
+  // Get new temp bufs by analyzing.
+  std::vector<ir::Buffer> new_temp_bufs = lang::GetTempBuffers(old_func->args, updated_body);
+  ir::LoweredFunc new_func = ir::_LoweredFunc_::Make(old_func->name, old_func->args, updated_body, new_temp_bufs);
+#ifdef CINN_WITH_CUDA
+  if (target == common::DefaultNVGPUTarget()) {
+    new_func->PrepareCudaAxisInfoFromBody();
+  }
+#endif
+  new_func = optim::Optimize(Expr(new_func), target, false).as_lowered_func_ref();
+  new_func->PrepareBufferCastExprs(/*with_expr_gen_tensor = */ false);
+
+  return new_func;
+}
+
 std::vector<ir::LoweredFunc> OpLowerer::IRLowerOp(IRComputeFunction compute,
                                                   IRScheduleFunction schedule,
                                                   GroupPtr& group) {
@@ -32,6 +32,10 @@
 // Reduce,OutEWiseFusable,NonFusible are using different schedule.
 
 namespace cinn {
+namespace auto_schedule {
+class TuningArtifact;
+}  // namespace auto_schedule
+
 namespace hlir {
 namespace framework {
 
@@ -62,6 +66,9 @@ typedef void (OpLowerer::*ScheduleFunction)(poly::StageMap&,
                                             const GroupPtr&);
 NodeData* GetNodeData(const Node* node);
 
+// Build the function with the body scheduled from the body of old_func, which is lowered without schedule
+ir::LoweredFunc UpdateFuncWithNewBody(const Target& target, const ir::LoweredFunc& old_func, ir::Expr& body);
+
 std::vector<NodeData*> GetAllNodeData(const Node* node);
 class OpLowerer {
  public:
@@ -77,6 +84,9 @@ class OpLowerer {
   std::vector<ir::LoweredFunc> IRLowerOp(IRComputeFunction, IRScheduleFunction, GroupPtr&);
   std::vector<ir::LoweredFunc> IRLowerNonFusibleOp(GroupPtr&, bool);
   std::vector<ir::LoweredFunc> IRLowerOpWithoutSchedule(IRComputeFunction, GroupPtr&);
+  // lower the group without schedule and replay the tuned schedule in the artifact on it,
+  // return empty if the group isn't tuned or the tuned schedule doesn't apply to it
+  std::vector<ir::LoweredFunc> IRLowerOpWithTuningArtifact(GroupPtr&, const auto_schedule::TuningArtifact&);
 #define DEFINE_IR_COMPUTE_SCHDULE(type)                                                        \
   std::vector<Expr> IR##type##Compute(poly::StageMap& stages,                                  \
                                       std::vector<ir::Tensor>& func_args,                      \
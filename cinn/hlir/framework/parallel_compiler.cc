@@ -17,6 +17,7 @@
 #include <algorithm>
 #include <fstream>
 #include <thread>
+#include <unordered_set>
 
 #include "cinn/backends/codegen_cuda_dev.h"
 #include "cinn/backends/codegen_cuda_host.h"
@@ -26,10 +27,14 @@
 #include "cinn/backends/nvrtc/nvrtc_util.h"
 #include "cinn/common/context.h"
 #include "cinn/hlir/framework/pass.h"
+#include "cinn/ir/ir_arena.h"
 #include "cinn/ir/module.h"
 
 DECLARE_int32(cinn_parallel_compile_size);
+DECLARE_bool(cinn_enable_kernel_cache);
 DECLARE_string(cinn_source_code_save_path);
+DECLARE_bool(cinn_enable_ir_arena);
+DECLARE_bool(cinn_ir_hash_consing);
 
 namespace cinn {
 namespace hlir {
@@ -43,8 +48,14 @@ std::vector<std::unique_ptr<Instruction>> ParallelCompiler::operator()() {
   if (graph_->fusion_groups.size() == 0) {
     hlir::framework::ApplyPasses(graph_.get(), {"BuildNonFusedGroupsPass"});
   }
+  // reuse the compiled kernels
+  DeduplicateGroups();
   // Task Spilt
   SplitTask();
+  // the host modules of all tasks are compiled concurrently in one engine with one symbol table
+  if (target_.arch == Target::Arch::X86 && option_.execution_options.num_compile_threads > 0) {
+    engine_ = backends::ExecutionEngine::Create(option_.execution_options);
+  }
   // launch task
   LaunchTask();
   // merge instruction
@@ -66,13 +77,55 @@ OpPatternKind GetOpKind(const framework::Node* node) {
   return kind;
 }
 
+void ParallelCompiler::DeduplicateGroups() {
+  compile_gidx_.clear();
+  // the input lowered funcs may be tuned for every group, so they are compiled as they are
+  if (!FLAGS_cinn_enable_kernel_cache || option_.lowered_funcs.size()) {
+    for (int idx = 0; idx < graph_->fusion_groups.size(); ++idx) {
+      compile_gidx_.push_back(idx);
+    }
+    return;
+  }
+
+  auto& dtype_dict = graph_->GetMutableAttrs<absl::flat_hash_map<std::string, Type>>("inferdtype");
+  auto& shape_dict = graph_->GetMutableAttrs<absl::flat_hash_map<std::string, shape_t>>("infershape");
+  reused_kernels_.resize(graph_->fusion_groups.size());
+  std::unordered_set<std::string> compiling_keys;
+  for (int idx = 0; idx < graph_->fusion_groups.size(); ++idx) {
+    fingerprints_.emplace_back(
+        GroupFingerprint::Compute(graph_->fusion_groups[idx], dtype_dict, shape_dict, target_));
+    auto key = KernelKey(idx);
+    // the kernel is compiled by the previous graphs
+    reused_kernels_[idx] = KernelCache::Global().Find(key);
+    if (reused_kernels_[idx]) {
+      continue;
+    }
+    // the kernel will be compiled for a structurally identical group of this graph
+    if (compiling_keys.count(key)) {
+      continue;
+    }
+    compiling_keys.insert(key);
+    compile_gidx_.push_back(idx);
+  }
+  VLOG(2) << "Compile " << compile_gidx_.size() << " of " << graph_->fusion_groups.size()
+          << " groups, the others reuse the kernels in cache.";
+}
+
+std::string ParallelCompiler::KernelKey(int idx) const {
+  // the kernels compiled from the same group with different options, such as fast-math, are not interchangeable
+  return fingerprints_.at(idx).key + "|" + option_.execution_options.ToString();
+}
+
 void ParallelCompiler::SplitTask() {
   CHECK(graph_->fusion_groups.size());
   CHECK(graph_->fusion_groups.size() == option_.lowered_funcs.size() || option_.lowered_funcs.size() == 0);
+  if (compile_gidx_.empty()) {
+    return;
+  }
   // split task
-  int num_per_task = std::max((graph_->fusion_groups.size() - 1) / FLAGS_cinn_parallel_compile_size + 1, 16UL);
+  int num_per_task = std::max((compile_gidx_.size() - 1) / FLAGS_cinn_parallel_compile_size + 1, 16UL);
 
-  for (int idx = 0; idx < graph_->fusion_groups.size(); idx += num_per_task) {
+  for (int idx = 0; idx < compile_gidx_.size(); idx += num_per_task) {
     tasks_.emplace_back(this, scope_, graph_, option_, target_);
   }
   VLOG(2) << "Split task to " << tasks_.size() << " sub-task!";
@@ -80,6 +133,8 @@ void ParallelCompiler::SplitTask() {
 
 void RunTask(ParallelCompiler::Task* task) {
   VLOG(2) << "Stark run sub-task, Thread Id : " << std::this_thread::get_id();
+  // the groups of the task are lowered and compiled in one arena, which the scopes inside share
+  ir::IrArenaScope arena_scope(FLAGS_cinn_enable_ir_arena, FLAGS_cinn_ir_hash_consing);
   task->Lowering();
   task->CodegenAndJit();
   task->BuildInstruction();
@@ -87,6 +142,9 @@ void RunTask(ParallelCompiler::Task* task) {
 }
 
 void ParallelCompiler::LaunchTask() {
+  if (tasks_.empty()) {
+    return;
+  }
   // start sub-task.
   std::vector<std::thread> threads;
   for (int idx = 1; idx < tasks_.size(); ++idx) {
@@ -107,6 +165,33 @@ std::vector<std::unique_ptr<Instruction>> ParallelCompiler::MergeResult() {
       res[task.gidx[idx]] = std::move(task.instructions[idx]);
     }
   }
+
+  // build the instructions of the groups reusing kernels
+  for (int idx = 0; idx < res.size(); ++idx) {
+    if (res[idx]) {
+      continue;
+    }
+    auto& group  = graph_->fusion_groups[idx];
+    auto& kernel = reused_kernels_[idx];
+    if (!kernel) {
+      // compiled for a structurally identical group of this graph
+      auto it = compiled_kernels_.find(KernelKey(idx));
+      if (it != compiled_kernels_.end()) {
+        kernel = it->second;
+      }
+    }
+    CHECK(kernel) << "Can't find the kernel of group " << group->group_id << " in cache!";
+    CHECK(fingerprints_[idx].MapNames(kernel->fingerprint, kernel->input_names, &group->input_names) &&
+          fingerprints_[idx].MapNames(kernel->fingerprint, kernel->output_names, &group->output_names))
+        << "Can't map the arguments of kernel " << kernel->func_name << " to group " << group->group_id;
+    VLOG(3) << "Group " << group->group_id << " reuses kernel " << kernel->func_name;
+
+    auto instr = std::unique_ptr<Instruction>(
+        new Instruction(target_, scope_.get(), group->input_names, group->output_names, kernel->func_name));
+    instr->SetLoweredFunc(kernel->fn_ptr, kernel->func_name);
+    instr->Finalize();
+    res[idx] = std::move(instr);
+  }
   return std::move(res);
 }
 
@@ -188,36 +273,61 @@ void ParallelCompiler::Task::CodegenAndJit() {
       CHECK(cufunc);
       symbols.RegisterVar(fn->name + "_ptr_", reinterpret_cast<void*>(cufunc));
     }
-    engine = backends::ExecutionEngine::Create(backends::ExecutionOptions(), std::move(symbols));
+    engine = backends::ExecutionEngine::Create(options.execution_options, std::move(symbols));
     engine->Link<backends::CodeGenCUDA_Host>(hmodule);
 #endif
   } else {
-    engine = backends::ExecutionEngine::Create(backends::ExecutionOptions());
+    engine = compiler->engine_ ? compiler->engine_ : backends::ExecutionEngine::Create(options.execution_options);
     engine->Link<backends::CodeGenX86>(ir_module);
   }
 }
 
 void ParallelCompiler::Task::BuildInstruction() {
-  // create instruction.
+  // look up all the functions at once, so they can be materialized concurrently
+  std::vector<std::string> func_names;
   for (int idx : gidx) {
+    func_names.push_back(graph->fusion_groups[idx]->GetFuncName());
+  }
+  auto fn_ptrs = engine->Lookup(func_names);
+
+  // create instruction.
+  for (int i = 0; i < gidx.size(); ++i) {
+    int idx     = gidx[i];
     auto& group = graph->fusion_groups[idx];
     CHECK(group->input_names.size() > 0 || group->output_names.size() > 0);
     auto instr = std::unique_ptr<Instruction>(
         new Instruction(target, scope.get(), group->input_names, group->output_names, group->GetFuncName()));
 
-    auto fn_ptr = engine->Lookup(group->GetFuncName());
+    auto fn_ptr = fn_ptrs[i];
     CHECK(fn_ptr) << "Can't find jit function : " << group->GetFuncName();
     instr->SetLoweredFunc(reinterpret_cast<void*>(fn_ptr), group->GetFuncName());
 
     instr->Finalize();
     instructions.push_back(std::move(instr));
+
+    if (compiler->fingerprints_.size()) {
+      auto kernel          = std::make_shared<KernelCache::Kernel>();
+      kernel->fingerprint  = compiler->fingerprints_[idx];
+      kernel->input_names  = group->input_names;
+      kernel->output_names = group->output_names;
+      kernel->func_name    = group->GetFuncName();
+      kernel->fn_ptr       = reinterpret_cast<void*>(fn_ptr);
+      kernel->holders.push_back(engine);
+#ifdef CINN_WITH_CUDA
+      kernel->holders.push_back(cumodule);
+#endif
+      auto key = compiler->KernelKey(idx);
+      KernelCache::Global().Insert(key, kernel);
+      std::lock_guard<std::mutex> lock(compiler->mtx_);
+      compiler->compiled_kernels_.emplace(key, std::move(kernel));
+    }
   }
 }
 
 int ParallelCompiler::GetGroupIdx() {
   std::lock_guard<std::mutex> lock(mtx_);
-  if (index < graph_->fusion_groups.size()) {
-    return index++;
+  if (index < compile_gidx_.size()) {
+    return compile_gidx_[index++];
   } else {
     return -1;
   }
@@ -20,6 +20,7 @@
 #include "cinn/common/target.h"
 #include "cinn/hlir/framework/graph.h"
 #include "cinn/hlir/framework/instruction.h"
+#include "cinn/hlir/framework/kernel_cache.h"
 #include "cinn/hlir/framework/op_lowering.h"
 #include "cinn/ir/lowered_func.h"
 #ifdef CINN_WITH_CUDA
@@ -33,6 +34,8 @@ class ParallelCompiler {
  public:
   struct CompileOptions {
     std::vector<std::vector<ir::LoweredFunc>> lowered_funcs;
+    // the options of the LLVM optimization and code generation
+    backends::ExecutionOptions execution_options;
   };
 
  public:
@@ -45,6 +48,10 @@ class ParallelCompiler {
   std::vector<std::unique_ptr<Instruction>> operator()();
 
  private:
+  // find the groups which can reuse the kernels in KernelCache or of the structurally identical groups
+  void DeduplicateGroups();
+  // the key of the kernel of group idx in KernelCache
+  std::string KernelKey(int idx) const;
   void SplitTask();
   void LaunchTask();
   std::vector<std::unique_ptr<Instruction>> MergeResult();
@@ -58,6 +65,8 @@ class ParallelCompiler {
          const CompileOptions& cp,
          const Target& t)
         : compiler(p), scope(s), graph(g), options(cp), target(t) {}
+    // the tasks are moved when tasks_ grows, since the instructions can't be copied
+    Task(Task&&) = default;
     void Lowering();
     void CodegenAndJit();
     void BuildInstruction();
@@ -74,9 +83,10 @@ class ParallelCompiler {
     std::vector<std::vector<ir::LoweredFunc>> lowered_funcs;
 
    public:
-    std::unique_ptr<backends::ExecutionEngine> engine;
+    // shared with the kernels in KernelCache which are compiled by this task
+    std::shared_ptr<backends::ExecutionEngine> engine;
 #ifdef CINN_WITH_CUDA
-    std::unique_ptr<runtime::cuda::CUDAModule> cumodule;
+    std::shared_ptr<runtime::cuda::CUDAModule> cumodule;
 #endif
   };
   std::vector<Task> tasks_;
@@ -86,6 +96,17 @@ class ParallelCompiler {
   int index{0};
   std::mutex mtx_;
 
+  // the indices of the groups to be lowered and compiled
+  std::vector<int> compile_gidx_;
+  // the fingerprints of all groups, empty if the kernel cache is disabled
+  std::vector<GroupFingerprint> fingerprints_;
+  // the kernels reused by the groups not compiled, indexed by group
+  std::vector<std::shared_ptr<KernelCache::Kernel>> reused_kernels_;
+  // the kernels compiled by the tasks indexed by their keys, which may have been evicted from KernelCache
+  absl::flat_hash_map<std::string, std::shared_ptr<KernelCache::Kernel>> compiled_kernels_;
+  // the engine shared by all tasks if it has compile threads, otherwise every task creates its own engine
+  std::shared_ptr<backends::ExecutionEngine> engine_;
+
   const common::Target target_;
   const CompileOptions& option_;
   std::shared_ptr<Scope> scope_;
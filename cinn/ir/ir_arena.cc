@@ -0,0 +1,160 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/ir/ir_arena.h"
+
+#include <glog/logging.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <unordered_map>
+
+namespace cinn {
+namespace ir {
+
+namespace {
+
+// every allocation starts with a header pointing to its chunk, nullptr for the heap, which keeps the nodes aligned
+constexpr size_t kHeaderSize = 16;
+// the larger nodes are allocated from the heap to keep the chunks from being wasted
+constexpr size_t kMaxArenaNodeSize = IrArena::kMinChunkSize / 16;
+
+thread_local IrArena* current_arena = nullptr;
+
+size_t AlignUp(size_t size) { return (size + kHeaderSize - 1) / kHeaderSize * kHeaderSize; }
+
+}  // namespace
+
+struct IrArena::Chunk {
+  // the nodes alive in the chunk, plus one while the arena allocates from it
+  std::atomic<int64_t> num_refs{1};
+  size_t capacity = 0;
+  size_t used     = 0;
+
+  static Chunk* Create(size_t capacity) {
+    void* memory = std::malloc(AlignUp(sizeof(Chunk)) + capacity);
+    CHECK(memory) << "Failed to allocate a chunk of the IrArena";
+    Chunk* chunk    = new (memory) Chunk;
+    chunk->capacity = capacity;
+    return chunk;
+  }
+
+  char* data() { return reinterpret_cast<char*>(this) + AlignUp(sizeof(Chunk)); }
+
+  void Release() {
+    if (num_refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      this->~Chunk();
+      std::free(this);
+    }
+  }
+};
+
+struct IrArena::ImmTable {
+  struct Key {
+    int type;
+    int bits;
+    uint64_t value_bits;
+
+    bool operator==(const Key& other) const {
+      return type == other.type && bits == other.bits && value_bits == other.value_bits;
+    }
+  };
+
+  struct KeyHash {
+    size_t operator()(const Key& key) const {
+      return std::hash<uint64_t>()(key.value_bits) ^ (static_cast<size_t>(key.type) << 8 | key.bits);
+    }
+  };
+
+  // the interned immediates are held until the arena is destroyed
+  std::unordered_map<Key, Expr, KeyHash> imms;
+};
+
+IrArena::IrArena(bool hash_consing) : hash_consing_(hash_consing), imm_table_(new ImmTable) {}
+
+IrArena::~IrArena() {
+  // the interned immediates may be the last references to some chunks
+  imm_table_.reset();
+  if (chunk_) chunk_->Release();
+  VLOG(4) << "IrArena allocated " << allocated_bytes_ << " bytes of IR nodes in " << reserved_bytes_ << " bytes";
+}
+
+IrArena* IrArena::Current() { return current_arena; }
+
+void* IrArena::Allocate(size_t size) {
+  size = AlignUp(size) + kHeaderSize;
+  char* memory;
+  if (current_arena && size <= kMaxArenaNodeSize) {
+    memory = static_cast<char*>(current_arena->AllocateFromChunk(size));
+  } else {
+    memory = static_cast<char*>(std::malloc(size));
+    if (!memory) throw std::bad_alloc();
+    *reinterpret_cast<Chunk**>(memory) = nullptr;
+  }
+  return memory + kHeaderSize;
+}
+
+void IrArena::Deallocate(void* ptr) {
+  if (!ptr) return;
+  char* memory = static_cast<char*>(ptr) - kHeaderSize;
+  Chunk* chunk = *reinterpret_cast<Chunk**>(memory);
+  if (chunk) {
+    chunk->Release();
+  } else {
+    std::free(memory);
+  }
+}
+
+void* IrArena::AllocateFromChunk(size_t size) {
+  if (!chunk_ || chunk_->used + size > chunk_->capacity) {
+    // the full chunk is freed once the nodes in it are destroyed
+    if (chunk_) chunk_->Release();
+    chunk_ = Chunk::Create(next_chunk_size_);
+    reserved_bytes_ += next_chunk_size_;
+    if (next_chunk_size_ < kMaxChunkSize) next_chunk_size_ *= 2;
+  }
+  char* memory = chunk_->data() + chunk_->used;
+  chunk_->used += size;
+  chunk_->num_refs.fetch_add(1, std::memory_order_relaxed);
+  allocated_bytes_ += size;
+  *reinterpret_cast<Chunk**>(memory) = chunk_;
+  return memory;
+}
+
+IrNode* IrArena::InternImm(const Type& type, uint64_t value_bits, const std::function<IrNode*()>& create) {
+  ImmTable::Key key{static_cast<int>(type.type()), type.bits(), value_bits};
+  auto it = imm_table_->imms.find(key);
+  if (it != imm_table_->imms.end()) return it->second.ptr();
+  IrNode* node = create();
+  imm_table_->imms.emplace(key, Expr(node));
+  return node;
+}
+
+IrArenaScope::IrArenaScope(bool enabled, bool hash_consing) {
+  if (enabled && !current_arena) {
+    arena_.reset(new IrArena(hash_consing));
+    current_arena = arena_.get();
+  }
+}
+
+IrArenaScope::~IrArenaScope() {
+  if (arena_) {
+    current_arena = nullptr;
+    arena_.reset();
+  }
+}
+
+}  // namespace ir
+}  // namespace cinn
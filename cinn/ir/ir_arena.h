@@ -0,0 +1,103 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include "cinn/common/macros.h"
+#include "cinn/ir/ir_base.h"
+
+namespace cinn {
+namespace ir {
+
+/**
+ * A per-thread arena the IR nodes are allocated from while an IrArenaScope is alive.
+ *
+ * The nodes are bumped from chunks of memory instead of being allocated one by one, and a chunk is freed once all
+ * the nodes in it are destroyed and the arena doesn't allocate from it any more, so the nodes may outlive the scope
+ * and be destroyed on any thread. The chunks start small and double in size, so the nodes surviving a short scope
+ * don't keep a large chunk alive. The nodes allocated out of any scope come from the heap as before.
+ *
+ * With hash-consing, the immediates built by the Expr constructors in the scope are shared by value, so the many
+ * copies of the same constant cost no allocation. The shared immediates must not be mutated in place, the passes
+ * make a new immediate instead, such as by common::make_const.
+ */
+class IrArena {
+ public:
+  // the size of the first chunk the nodes are bumped from, the next chunks double it up to kMaxChunkSize
+  static constexpr size_t kMinChunkSize = 1 << 16;
+  static constexpr size_t kMaxChunkSize = 1 << 20;
+
+  explicit IrArena(bool hash_consing);
+  ~IrArena();
+
+  //! The arena of the current thread, nullptr if no IrArenaScope is alive.
+  static IrArena* Current();
+
+  //! Allocate the memory of a node from the arena of the current thread if any, otherwise from the heap.
+  static void* Allocate(size_t size);
+
+  //! Free the memory of a node allocated by Allocate.
+  static void Deallocate(void* ptr);
+
+  bool hash_consing() const { return hash_consing_; }
+
+  //! Get the immediate of \p type whose value has the bits \p value_bits, \p create it if not interned yet.
+  IrNode* InternImm(const Type& type, uint64_t value_bits, const std::function<IrNode*()>& create);
+
+  //! The bytes of the nodes allocated from the arena.
+  size_t allocated_bytes() const { return allocated_bytes_; }
+
+  //! The bytes of the chunks created by the arena.
+  size_t reserved_bytes() const { return reserved_bytes_; }
+
+ private:
+  struct Chunk;
+  struct ImmTable;
+
+  void* AllocateFromChunk(size_t size);
+
+  bool hash_consing_;
+  // the chunk the nodes are bumped from
+  Chunk* chunk_           = nullptr;
+  size_t next_chunk_size_ = kMinChunkSize;
+  size_t allocated_bytes_ = 0;
+  size_t reserved_bytes_  = 0;
+  std::unique_ptr<ImmTable> imm_table_;
+
+  CINN_DISALLOW_COPY_AND_ASSIGN(IrArena);
+};
+
+/**
+ * Allocate the IR nodes created in the current thread from an IrArena during the lifetime of this object if
+ * \p enabled, a nested scope shares the arena of the outermost one.
+ */
+class IrArenaScope {
+ public:
+  IrArenaScope(bool enabled, bool hash_consing);
+  ~IrArenaScope();
+
+ private:
+  // the arena opened by this scope, nullptr if an outer scope is alive
+  std::unique_ptr<IrArena> arena_;
+
+  CINN_DISALLOW_COPY_AND_ASSIGN(IrArenaScope);
+};
+
+}  // namespace ir
+}  // namespace cinn
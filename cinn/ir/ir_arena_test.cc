@@ -0,0 +1,125 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/ir/ir_arena.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "cinn/cinn.h"
+#include "cinn/common/ir_util.h"
+#include "cinn/ir/ir_operators.h"
+#include "cinn/utils/string.h"
+
+namespace cinn {
+namespace ir {
+
+TEST(IrArena, Allocate) {
+  Expr outside = Expr(1) + Expr(2);
+  ASSERT_EQ(IrArena::Current(), nullptr);
+
+  Expr inside;
+  {
+    IrArenaScope scope(true, false);
+    IrArena* arena = IrArena::Current();
+    ASSERT_NE(arena, nullptr);
+    {
+      // the nested scope shares the arena
+      IrArenaScope nested_scope(true, false);
+      ASSERT_EQ(IrArena::Current(), arena);
+    }
+    ASSERT_EQ(IrArena::Current(), arena);
+
+    inside = Expr(outside) * Expr(3);
+    EXPECT_GT(arena->allocated_bytes(), 0UL);
+    // the immediates are not shared without hash-consing
+    EXPECT_NE(Expr(3).ptr(), Expr(3).ptr());
+
+    // the nodes allocated in the heap and in the arena can be mixed and destroyed in any order
+    outside = Expr();
+  }
+  ASSERT_EQ(IrArena::Current(), nullptr);
+
+  // the nodes allocated in the scope are alive after it
+  EXPECT_EQ(utils::GetStreamCnt(inside), "((1 + 2) * 3)");
+}
+
+TEST(IrArena, Disabled) {
+  IrArenaScope scope(false, true);
+  EXPECT_EQ(IrArena::Current(), nullptr);
+  EXPECT_NE(Expr(1).ptr(), Expr(1).ptr());
+}
+
+TEST(IrArena, HashConsing) {
+  IrArenaScope scope(true, true);
+
+  EXPECT_EQ(Expr(1).ptr(), Expr(1).ptr());
+  EXPECT_EQ(Expr(1.5f).ptr(), Expr(1.5f).ptr());
+  EXPECT_EQ(Expr(true).ptr(), Expr(true).ptr());
+  // the immediates of different types or values are distinct
+  EXPECT_NE(Expr(1).ptr(), Expr(2).ptr());
+  EXPECT_NE(Expr(1).ptr(), Expr(int64_t(1)).ptr());
+  EXPECT_NE(Expr(1).ptr(), Expr(uint32_t(1)).ptr());
+  EXPECT_NE(Expr(0.f).ptr(), Expr(-0.f).ptr());
+  EXPECT_EQ(Expr(int64_t(1)).type(), Int(64));
+
+  // the helpers don't write the shared immediates
+  EXPECT_FALSE(common::is_zero(Expr(1.5f)));
+  EXPECT_EQ(Expr(1.5f).As<FloatImm>()->value, 1.5f);
+  EXPECT_TRUE(common::is_zero(Expr(0.f)));
+}
+
+TEST(IrArena, ChunkGrowth) {
+  const size_t min_chunk_size = IrArena::kMinChunkSize;
+  const size_t max_chunk_size = IrArena::kMaxChunkSize;
+  Expr survivor;
+  {
+    IrArenaScope scope(true, false);
+    // a small scope only reserves the first chunk, which is all its surviving nodes keep alive
+    survivor = Var("x") + Expr(1);
+    EXPECT_EQ(IrArena::Current()->reserved_bytes(), min_chunk_size);
+  }
+  EXPECT_EQ(utils::GetStreamCnt(survivor), "(x + 1)");
+
+  IrArenaScope scope(true, false);
+  IrArena* arena = IrArena::Current();
+  std::vector<Expr> exprs;
+  while (arena->reserved_bytes() < 4 * max_chunk_size) {
+    exprs.push_back(Var("x") + Expr(1));
+  }
+  // the chunks double up to the max size, so little memory is reserved ahead
+  EXPECT_LE(arena->reserved_bytes(), arena->allocated_bytes() + max_chunk_size);
+}
+
+TEST(IrArena, DestroyInOtherThread) {
+  std::vector<Expr> exprs;
+  {
+    IrArenaScope scope(true, true);
+    // larger than a chunk
+    for (int i = 0; i < 100000; ++i) {
+      exprs.push_back(Var("x") + Expr(i));
+    }
+  }
+  std::thread([&exprs]() {
+    for (int i = 0; i < 100000; i += 9999) {
+      EXPECT_EQ(utils::GetStreamCnt(exprs[i]), "(x + " + std::to_string(i) + ")");
+    }
+    exprs.clear();
+  }).join();
+}
+
+}  // namespace ir
+}  // namespace cinn
@@ -14,10 +14,13 @@
 
 #include "cinn/ir/ir_base.h"
 
+#include <cstring>
+
 #include "cinn/common/cinn_value.h"
 #include "cinn/common/common.h"
 #include "cinn/ir/buffer.h"
 #include "cinn/ir/ir.h"
+#include "cinn/ir/ir_arena.h"
 #include "cinn/ir/ir_printer.h"
 #include "cinn/ir/ir_visitor.h"
 #include "cinn/ir/module.h"
@@ -81,6 +84,33 @@ Expr One(const Type &type) {
   return Expr();
 }
 
+void *IrNode::operator new(size_t size) { return IrArena::Allocate(size); }
+
+void IrNode::operator delete(void *ptr) { IrArena::Deallocate(ptr); }
+
+namespace {
+
+// make an immediate, which is interned if the IrArena of the current thread hash-conses
+template <typename T, typename ValueT>
+IrNode *MakeImm(const Type &type, ValueT value) {
+  IrArena *arena = IrArena::Current();
+  if (!arena || !arena->hash_consing()) return new T(type, value);
+  uint64_t value_bits = 0;
+  std::memcpy(&value_bits, &value, sizeof(value));
+  return arena->InternImm(type, value_bits, [&] { return new T(type, value); });
+}
+
+}  // namespace
+
+Expr::Expr(bool x) : IrNodeRef(MakeImm<UIntImm>(UInt(1), static_cast<int64_t>(x))) {}
+Expr::Expr(int32_t x) : IrNodeRef(MakeImm<IntImm>(Int(32), static_cast<int64_t>(x))) {}
+Expr::Expr(uint32_t x) : IrNodeRef(MakeImm<UIntImm>(UInt(32), static_cast<int64_t>(x))) {}
+Expr::Expr(int64_t x) : IrNodeRef(MakeImm<IntImm>(Int(64), x)) {}
+Expr::Expr(uint64_t x) : IrNodeRef(MakeImm<UIntImm>(UInt(64), static_cast<int64_t>(x))) {}
+Expr::Expr(float16 x) : IrNodeRef(MakeImm<FloatImm>(Float(16), static_cast<float>(x))) {}
+Expr::Expr(float x) : IrNodeRef(MakeImm<FloatImm>(Float(32), x)) {}
+Expr::Expr(double x) : IrNodeRef(MakeImm<FloatImm>(Float(64), static_cast<float>(x))) {}
+
 Expr::Expr(const Var &var) { *static_cast<IrNodeRef *>(this) = *static_cast<const IrNodeRef *>(&var); }
 bool Expr::as_bool() const {
   CHECK(type().is_uint(1));
@@ -147,6 +147,12 @@ class IrNode : public common::Object {
   explicit IrNode(Type t) : type_(t) {}
   virtual ~IrNode() = default;
 
+  //! The nodes are allocated from the IrArena of the current thread if any, see ir_arena.h.
+  // @{
+  static void* operator new(size_t size);
+  static void operator delete(void* ptr);
+  // @}
+
   virtual IrNodeTy node_type() const { return IrNodeTy::kUnk; }
   virtual Type type() const { return type_; }
   void set_type(Type type) { type_ = type; }
@@ -289,16 +295,17 @@ struct Expr : public IrNodeRef {
   Expr(IrNode* p) : IrNodeRef(p) {}  // NOLINT
   explicit Expr(const Var& var);
 
-  //! Helper function to construct numeric constants of various types.
+  //! Helper function to construct numeric constants of various types, which are shared by value in an IrArenaScope
+  //! with hash-consing, see ir_arena.h.
   // @{
-  explicit Expr(bool x) : IrNodeRef(new UIntImm(UInt(1), x)) {}
-  explicit Expr(int32_t x) : IrNodeRef(new IntImm(Int(32), x)) {}
-  explicit Expr(uint32_t x) : IrNodeRef(new UIntImm(UInt(32), x)) {}
-  explicit Expr(int64_t x) : IrNodeRef(new IntImm(Int(64), x)) {}
-  explicit Expr(uint64_t x) : IrNodeRef(new UIntImm(UInt(64), x)) {}
-  explicit Expr(cinn::common::float16 x) : IrNodeRef(new FloatImm(Float(16), x)) {}
-  explicit Expr(float x) : IrNodeRef(new FloatImm(Float(32), x)) {}
-  explicit Expr(double x) : IrNodeRef(new FloatImm(Float(64), x)) {}
+  explicit Expr(bool x);
+  explicit Expr(int32_t x);
+  explicit Expr(uint32_t x);
+  explicit Expr(int64_t x);
+  explicit Expr(uint64_t x);
+  explicit Expr(cinn::common::float16 x);
+  explicit Expr(float x);
+  explicit Expr(double x);
   explicit Expr(const std::string& x) : IrNodeRef(new StringImm(x)) {}
   // @}
 
@@ -14,10 +14,13 @@
 
 #include "cinn/ir/ir_compare.h"
 
+#include <cctype>
 #include <regex>
+#include <string>
 
 #include "cinn/ir/ir_base.h"
 #include "cinn/ir/ir_printer.h"
+#include "cinn/utils/string.h"
 
 namespace cinn {
 namespace ir {
@@ -315,5 +318,50 @@ bool IrEqualVisitor::Visit(const ScheduleBlockRealize* lhs, const Expr* other) {
   return Compare(lhs->iter_values, rhs->iter_values) && Compare(lhs->schedule_block, rhs->schedule_block);
 }
 
+namespace {
+
+bool IsNameChar(char c) { return std::isalnum(static_cast<unsigned char>(c)) || c == '_'; }
+
+// remove the suffix "_[0-9]+" of the names in the code
+std::string RemoveNameSuffix(const std::string& code) {
+  std::string result;
+  result.reserve(code.size());
+  size_t i = 0;
+  while (i < code.size()) {
+    if (!std::isalpha(static_cast<unsigned char>(code[i])) && code[i] != '_') {
+      result.push_back(code[i++]);
+      continue;
+    }
+    size_t end = i;
+    while (end < code.size() && IsNameChar(code[end])) ++end;
+    size_t name_end = end;
+    while (name_end > i && std::isdigit(static_cast<unsigned char>(code[name_end - 1]))) --name_end;
+    if (name_end < end && name_end - 1 > i && code[name_end - 1] == '_') {
+      name_end -= 1;
+    } else {
+      name_end = end;
+    }
+    result.append(code, i, name_end - i);
+    i = end;
+  }
+  return result;
+}
+
+}  // namespace
+
+uint64_t IrCanonicalHash(const Expr& expr, bool allow_name_suffix_diff, uint64_t seed) {
+  std::string code = utils::GetStreamCnt(expr);
+  if (allow_name_suffix_diff) {
+    code = RemoveNameSuffix(code);
+  }
+  // FNV-1a, which doesn't depend on the implementation of std::hash
+  uint64_t hash = 14695981039346656037ULL ^ seed;
+  for (char c : code) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
 }  // namespace ir
 }  // namespace cinn
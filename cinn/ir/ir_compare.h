@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #pragma once
+#include <cstdint>
 #include <vector>
 
 #include "cinn/ir/ir.h"
@@ -42,5 +43,10 @@ class IrEqualVisitor : public IRVisitorBase<bool, const Expr*> {
   bool allow_name_suffix_diff_ = false;
 };
 
+// Compute a hash of the ir AST tree from its printed code, which is stable across processes so it can be persisted.
+// The trees equal under IrEqualVisitor(allow_name_suffix_diff) have the same hash, so if allow_name_suffix_diff
+// the suffix "_[0-9]+" of every name is removed before hashing.
+uint64_t IrCanonicalHash(const Expr& expr, bool allow_name_suffix_diff = false, uint64_t seed = 0);
+
 }  // namespace ir
 }  // namespace cinn
@@ -112,6 +112,12 @@ TEST(TestIrCompare, SingleFunction) {
 
   ASSERT_FALSE(compartor.Compare(funcs_1.front(), funcs_3.front()));
   ASSERT_FALSE(compartor_allow_suffix_diff.Compare(funcs_1.front(), funcs_3.front()));
+
+  // the canonical hash is consistent with the comparison
+  EXPECT_NE(IrCanonicalHash(funcs_1.front()), IrCanonicalHash(funcs_2.front()));
+  EXPECT_EQ(IrCanonicalHash(funcs_1.front(), true), IrCanonicalHash(funcs_2.front(), true));
+  EXPECT_NE(IrCanonicalHash(funcs_1.front(), true), IrCanonicalHash(funcs_3.front(), true));
+  EXPECT_NE(IrCanonicalHash(funcs_1.front(), true, 1), IrCanonicalHash(funcs_2.front(), true, 2));
 }
 
 }  // namespace ir
@@ -0,0 +1,293 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/optim/eliminate_common_subexpr.h"
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "cinn/common/context.h"
+#include "cinn/ir/collect_ir_nodes.h"
+#include "cinn/ir/ir_compare.h"
+#include "cinn/ir/ir_mutator.h"
+#include "cinn/ir/ir_printer.h"
+#include "cinn/optim/ir_copy.h"
+
+namespace cinn {
+namespace optim {
+
+namespace {
+
+void HashCombine(size_t* seed, size_t value) { *seed ^= value + 0x9e3779b9 + (*seed << 6) + (*seed >> 2); }
+
+// whether the node computes its value from the operands only
+bool IsPureOp(const Expr& expr) {
+  switch (expr->node_type()) {
+#define __(op__) case ir::IrNodeTy::op__:
+    NODETY_OP_FOR_EACH(__)
+#undef __
+    case ir::IrNodeTy::Cast:
+    case ir::IrNodeTy::Select:
+    case ir::IrNodeTy::Broadcast:
+    case ir::IrNodeTy::Ramp:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// whether the expression can be held by a Let, the vector types except the Broadcast ones can't be printed
+bool IsEliminableType(const Expr& expr) {
+  Type type = expr.type();
+  if (type.is_bool() || !(type.is_int() || type.is_uint() || type.is_float())) {
+    return false;
+  }
+  return type.lanes() == 1 || expr.As<ir::Broadcast>();
+}
+
+// the operands of the expression to scan, with whether they are evaluated conditionally
+std::vector<std::pair<Expr*, bool>> Operands(Expr* expr) {
+  std::vector<std::pair<Expr*, bool>> operands;
+  if (auto* load = expr->As<ir::Load>()) {
+    for (Expr& index : load->indices) operands.emplace_back(&index, false);
+  } else if (auto* store = expr->As<ir::Store>()) {
+    operands.emplace_back(&store->value, false);
+    for (Expr& index : store->indices) operands.emplace_back(&index, false);
+  } else if (auto* let = expr->As<ir::Let>()) {
+    if (let->body.defined()) operands.emplace_back(&let->body, false);
+  } else if (auto* select = expr->As<ir::Select>()) {
+    operands.emplace_back(&select->condition, false);
+    operands.emplace_back(&select->true_value, true);
+    operands.emplace_back(&select->false_value, true);
+  } else if (expr->As<ir::Call>() || IsPureOp(*expr)) {
+    for (Expr* field : expr->ptr()->expr_fields()) operands.emplace_back(field, false);
+  }
+  return operands;
+}
+
+// the vars which are declared by a Let without value or stored to, an expression on them can't be reused
+std::unordered_set<std::string> CollectMutableVars(Expr expr) {
+  std::unordered_set<std::string> names;
+  ir::CollectIRNodesWithoutTensor(expr, [&](const Expr* x) {
+    if (auto* let = x->As<ir::Let>()) {
+      if (!let->body.defined() && let->symbol.As<ir::_Var_>()) {
+        names.insert(let->symbol.As<ir::_Var_>()->name);
+      }
+    } else if (auto* store = x->As<ir::Store>()) {
+      if (store->tensor.As<ir::_Var_>()) {
+        names.insert(store->tensor.As<ir::_Var_>()->name);
+      }
+    }
+    return false;
+  });
+  return names;
+}
+
+class CommonSubexprEliminator {
+ public:
+  explicit CommonSubexprEliminator(const std::unordered_set<std::string>& mutable_vars)
+      : mutable_vars_(mutable_vars) {}
+
+  // eliminate the common subexpressions of the statements in a Block
+  void operator()(std::vector<Expr>* stmts) {
+    // a Let redefining a var which is used before starts a new segment, the expressions on the var are different
+    // in the two segments
+    std::vector<Expr> result;
+    std::vector<Expr> segment;
+    std::unordered_set<std::string> used_vars;
+    for (Expr& stmt : *stmts) {
+      auto* let = stmt.As<ir::Let>();
+      if (let && let->symbol.As<ir::_Var_>() && used_vars.count(let->symbol.As<ir::_Var_>()->name)) {
+        EliminateInSegment(&segment);
+        result.insert(result.end(), segment.begin(), segment.end());
+        segment.clear();
+        used_vars.clear();
+      }
+      ir::CollectIRNodesWithoutTensor(stmt, [&](const Expr* x) {
+        if (x->As<ir::_Var_>()) used_vars.insert(x->As<ir::_Var_>()->name);
+        return false;
+      });
+      segment.push_back(stmt);
+    }
+    EliminateInSegment(&segment);
+    result.insert(result.end(), segment.begin(), segment.end());
+    *stmts = std::move(result);
+  }
+
+ private:
+  struct Candidate {
+    Expr expr;
+    // the number of nodes
+    int size;
+    int count;
+  };
+
+  void EliminateInSegment(std::vector<Expr>* segment) {
+    candidates_.clear();
+    buckets_.clear();
+    for (Expr& stmt : *segment) {
+      if (IsScanned(stmt)) {
+        size_t hash = 0;
+        int size    = 0;
+        Collect(&stmt, false, &hash, &size);
+      }
+    }
+
+    std::vector<int> order;
+    for (int i = 0; i < candidates_.size(); ++i) {
+      if (candidates_[i].count > 1) order.push_back(i);
+    }
+    // eliminate the larger ones first, so their subexpressions are computed once in their Lets
+    std::stable_sort(order.begin(), order.end(), [this](int a, int b) {
+      return candidates_[a].size > candidates_[b].size;
+    });
+
+    for (int i : order) {
+      const Expr& target = candidates_[i].expr;
+      // some occurrences may have been replaced by the eliminated larger expressions
+      int first_use = -1;
+      int count     = 0;
+      for (int j = 0; j < segment->size(); ++j) {
+        int n = IsScanned(segment->at(j)) ? Replace(&segment->at(j), target, Expr(), false) : 0;
+        if (n > 0 && first_use < 0) first_use = j;
+        count += n;
+      }
+      if (count < 2) continue;
+
+      Var var(common::UniqName("cse"), target.type());
+      Expr value = optim::IRCopy(target);
+      for (int j = first_use; j < segment->size(); ++j) {
+        if (IsScanned(segment->at(j))) Replace(&segment->at(j), target, var, false);
+      }
+      VLOG(4) << "Eliminate " << count << " occurrences of " << value << " by " << var;
+      segment->insert(segment->begin() + first_use, ir::Let::Make(var, value));
+    }
+  }
+
+  static bool IsScanned(const Expr& stmt) {
+    return stmt.As<ir::Store>() || (stmt.As<ir::Let>() && stmt.As<ir::Let>()->body.defined());
+  }
+
+  // collect the candidates in *expr, return whether it is pure, and its structural hash and number of nodes
+  bool Collect(Expr* expr, bool conditional, size_t* hash, int* size) {
+    *hash = 0;
+    *size = 0;
+    if (!expr->defined()) return true;
+
+    *hash = static_cast<size_t>((*expr)->node_type());
+    HashCombine(hash, static_cast<size_t>(expr->type().type()));
+    HashCombine(hash, expr->type().bits());
+    HashCombine(hash, expr->type().lanes());
+    *size = 1;
+    if (auto* var = expr->As<ir::_Var_>()) {
+      HashCombine(hash, std::hash<std::string>()(var->name));
+      return !mutable_vars_.count(var->name);
+    }
+    if (auto* imm = expr->As<ir::IntImm>()) {
+      HashCombine(hash, std::hash<int64_t>()(imm->value));
+      return true;
+    }
+    if (auto* imm = expr->As<ir::UIntImm>()) {
+      HashCombine(hash, std::hash<uint64_t>()(imm->value));
+      return true;
+    }
+    if (auto* imm = expr->As<ir::FloatImm>()) {
+      HashCombine(hash, std::hash<double>()(imm->value));
+      return true;
+    }
+
+    bool pure = IsPureOp(*expr);
+    for (auto& operand : Operands(expr)) {
+      size_t operand_hash = 0;
+      int operand_size    = 0;
+      pure = Collect(operand.first, conditional || operand.second, &operand_hash, &operand_size) && pure;
+      HashCombine(hash, operand_hash);
+      *size += operand_size;
+    }
+    // only the expressions evaluated unconditionally can be computed ahead
+    if (pure && !conditional && *size > 1 && IsEliminableType(*expr)) {
+      AddCandidate(*expr, *hash, *size);
+    }
+    return pure;
+  }
+
+  void AddCandidate(const Expr& expr, size_t hash, int size) {
+    auto& bucket = buckets_[hash];
+    for (int i : bucket) {
+      if (Equal(candidates_[i].expr, expr)) {
+        candidates_[i].count += 1;
+        return;
+      }
+    }
+    bucket.push_back(candidates_.size());
+    candidates_.push_back(Candidate{expr, size, 1});
+  }
+
+  // replace the unconditional occurrences of target in *expr with var, only count them if var is undefined,
+  // return the number of them
+  int Replace(Expr* expr, const Expr& target, const Expr& var, bool conditional) {
+    if (!expr->defined()) return 0;
+    if (!conditional && Equal(*expr, target)) {
+      if (var.defined()) *expr = var;
+      return 1;
+    }
+    int count = 0;
+    for (auto& operand : Operands(expr)) {
+      count += Replace(operand.first, target, var, conditional || operand.second);
+    }
+    return count;
+  }
+
+  static bool Equal(const Expr& a, const Expr& b) {
+    return a->node_type() == b->node_type() && a.type() == b.type() && ir::IrEqualVisitor().Compare(a, b);
+  }
+
+  const std::unordered_set<std::string>& mutable_vars_;
+  std::vector<Candidate> candidates_;
+  // the candidates with the same structural hash
+  std::unordered_map<size_t, std::vector<int>> buckets_;
+};
+
+struct EliminateCommonSubexprMutator : public ir::IRMutator<> {
+  using ir::IRMutator<>::Visit;
+
+  explicit EliminateCommonSubexprMutator(const std::unordered_set<std::string>& mutable_vars)
+      : eliminator(mutable_vars) {}
+
+  void operator()(Expr* expr) { ir::IRMutator<>::Visit(expr, expr); }
+
+  void Visit(const ir::Block* op, Expr* expr) override {
+    ir::IRMutator<>::Visit(op, expr);
+    eliminator(&expr->As<ir::Block>()->stmts);
+  }
+
+  CommonSubexprEliminator eliminator;
+};
+
+}  // namespace
+
+void EliminateCommonSubexpr(Expr* expr) {
+  CHECK(expr);
+  std::unordered_set<std::string> mutable_vars = CollectMutableVars(*expr);
+  EliminateCommonSubexprMutator mutator(mutable_vars);
+  mutator(expr);
+}
+
+}  // namespace optim
+}  // namespace cinn
@@ -0,0 +1,45 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include "cinn/ir/ir.h"
+
+namespace cinn {
+namespace optim {
+
+/**
+ * Eliminate the common subexpressions of the statements in every Block.
+ *
+ * The pure scalar expressions (the arithmetic on vars and constants, without Load or Call) and the Broadcasts of
+ * them which occur more than once in the Store and Let statements of a Block are computed once by a Let inserted
+ * before their first use, and the occurrences are replaced with the var of the Let. The larger expressions are
+ * eliminated first, and the structural equality is decided by ir::IrEqualVisitor.
+ *
+ * For example:
+ *
+ * \code
+ * C[(500 * i) + (16 * j)] = A[(500 * i) + (16 * j)] * 2
+ * \endcode
+ *
+ * is transformed to
+ *
+ * \code
+ * int32 cse_0 = (500 * i) + (16 * j)
+ * C[cse_0] = A[cse_0] * 2
+ * \endcode
+ */
+void EliminateCommonSubexpr(Expr* expr);
+
+}  // namespace optim
+}  // namespace cinn
@@ -0,0 +1,88 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/optim/eliminate_common_subexpr.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "cinn/cinn.h"
+#include "cinn/ir/collect_ir_nodes.h"
+#include "cinn/ir/ir_operators.h"
+#include "cinn/ir/ir_printer.h"
+#include "cinn/utils/string.h"
+
+namespace cinn {
+namespace optim {
+
+TEST(EliminateCommonSubexpr, index) {
+  Placeholder<float> A("A", std::vector<int>{{1024}});
+  Placeholder<float> C("C", std::vector<int>{{1024}});
+  Placeholder<float> D("D", std::vector<int>{{1024}});
+
+  Var i("i");
+  Var j("j");
+  auto index = [&]() { return Expr(i) * 16 + Expr(j); };
+
+  Expr e = ir::Block::Make({
+      ir::Store::Make(ir::Tensor(C), ir::Load::Make(ir::Tensor(A), {index()}) * Expr(2.f), {index()}),
+      ir::Store::Make(ir::Tensor(D), ir::Load::Make(ir::Tensor(A), {index()}) + Expr(1.f), {index()}),
+  });
+  LOG(INFO) << "Before:\n" << e;
+
+  EliminateCommonSubexpr(&e);
+  LOG(INFO) << "After:\n" << e;
+
+  // the index is computed once, and (i * 16) is not eliminated since it only occurs in the Let of the index
+  auto& stmts = e.As<ir::Block>()->stmts;
+  ASSERT_EQ(stmts.size(), 3UL);
+  auto* let = stmts[0].As<ir::Let>();
+  ASSERT_TRUE(let);
+  EXPECT_EQ(utils::GetStreamCnt(let->body), "((i * 16) + j)");
+  Var var = let->symbol.as_var_ref();
+  for (int k = 1; k < 3; ++k) {
+    auto* store = stmts[k].As<ir::Store>();
+    ASSERT_TRUE(store);
+    EXPECT_EQ(store->indices[0].as_var_ref()->name, var->name);
+    auto loads = ir::CollectIRNodesWithoutTensor(store->value, [](const Expr* x) { return x->As<ir::Load>(); });
+    ASSERT_EQ(loads.size(), 1UL);
+    EXPECT_EQ(loads.begin()->As<ir::Load>()->indices[0].as_var_ref()->name, var->name);
+  }
+}
+
+TEST(EliminateCommonSubexpr, conditional_and_mutable) {
+  Placeholder<float> C("C", std::vector<int>{{1024}});
+
+  Var n("n");
+  Var x("x");
+  Var k("k");
+  Expr value = ir::Select::Make(ir::NE::Make(Expr(n), Expr(0)), Expr(k) / Expr(n), Expr(0));
+
+  Expr e = ir::Block::Make({
+      ir::Let::Make(Expr(x), Expr()),
+      ir::Store::Make(ir::Tensor(C), ir::Cast::Make(Float(32), value), {Expr(x) * 2}),
+      ir::Store::Make(ir::Tensor(C), ir::Cast::Make(Float(32), Expr(k) / Expr(n) + 1), {Expr(x) * 2 + 1}),
+  });
+  LOG(INFO) << "Before:\n" << e;
+
+  EliminateCommonSubexpr(&e);
+  LOG(INFO) << "After:\n" << e;
+
+  // (k / n) is computed conditionally in the first Store and x is mutable, so nothing is eliminated
+  ASSERT_EQ(e.As<ir::Block>()->stmts.size(), 3UL);
+}
+
+}  // namespace optim
+}  // namespace cinn
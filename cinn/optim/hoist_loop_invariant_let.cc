@@ -0,0 +1,245 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/optim/hoist_loop_invariant_let.h"
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "cinn/common/context.h"
+#include "cinn/ir/collect_ir_nodes.h"
+#include "cinn/ir/ir_compare.h"
+#include "cinn/ir/ir_mutator.h"
+#include "cinn/ir/ir_printer.h"
+#include "cinn/optim/ir_copy.h"
+
+namespace cinn {
+namespace optim {
+
+namespace {
+
+// whether the value of the Let can be computed before the forloop
+bool IsHoistableValue(const Expr& value) {
+  Type type = value.type();
+  if (type.is_bool() || !(type.is_int() || type.is_uint() || type.is_float())) {
+    return false;
+  }
+  auto unsafe_nodes = ir::CollectIRNodesWithoutTensor(value, [](const Expr* x) {
+    if (x->As<ir::Load>() || x->As<ir::Call>() || x->As<ir::_Tensor_>() || x->As<ir::_Buffer_>()) {
+      return true;
+    }
+    if (x->As<ir::Div>() && !x->As<ir::Div>()->b().is_constant()) {
+      return true;
+    }
+    if (x->As<ir::Mod>() && !x->As<ir::Mod>()->b().is_constant()) {
+      return true;
+    }
+    return false;
+  });
+  return unsafe_nodes.empty();
+}
+
+// whether the node computes its value from the operands only
+bool IsPureOp(const Expr& expr) {
+  switch (expr->node_type()) {
+#define __(op__) case ir::IrNodeTy::op__:
+    NODETY_OP_FOR_EACH(__)
+#undef __
+    case ir::IrNodeTy::Cast:
+    case ir::IrNodeTy::Select:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// the operands of the expression in which the invariant subexpressions are extracted
+std::vector<Expr*> Operands(Expr* expr) {
+  std::vector<Expr*> operands;
+  if (auto* load = expr->As<ir::Load>()) {
+    for (Expr& index : load->indices) operands.push_back(&index);
+  } else if (auto* store = expr->As<ir::Store>()) {
+    operands.push_back(&store->value);
+    for (Expr& index : store->indices) operands.push_back(&index);
+  } else if (auto* let = expr->As<ir::Let>()) {
+    if (let->body.defined()) operands.push_back(&let->body);
+  } else if (expr->As<ir::Call>() || IsPureOp(*expr)) {
+    for (Expr* field : expr->ptr()->expr_fields()) operands.push_back(field);
+  }
+  return operands;
+}
+
+// Replace the maximal loop invariant subexpressions in the statements of a forloop with the vars of new Lets,
+// so they are hoisted like the Lets written explicitly, even if they are used only once
+class InvariantSubexprExtractor {
+ public:
+  explicit InvariantSubexprExtractor(const std::unordered_map<std::string, int>& var_updates)
+      : var_updates_(var_updates) {}
+
+  void operator()(Expr* stmt) {
+    auto* let = stmt->As<ir::Let>();
+    // the whole value of the Let is hoisted if it is invariant
+    if (let && let->body.defined() && IsExtractable(let->body)) return;
+    if (stmt->As<ir::Store>() || (let && let->body.defined())) {
+      for (Expr* operand : Operands(stmt)) Extract(operand);
+    }
+  }
+
+  // the Lets of the extracted subexpressions, in the order of their first uses
+  const std::vector<Expr>& lets() const { return lets_; }
+
+ private:
+  void Extract(Expr* expr) {
+    if (!expr->defined()) return;
+    if (IsExtractable(*expr)) {
+      *expr = GetVar(*expr);
+      return;
+    }
+    for (Expr* operand : Operands(expr)) Extract(operand);
+  }
+
+  bool IsExtractable(const Expr& expr) const {
+    if (expr.is_constant() || expr.As<ir::_Var_>() || expr.type().lanes() != 1 || !IsHoistableValue(expr)) {
+      return false;
+    }
+    bool has_var   = false;
+    bool invariant = true;
+    ir::CollectIRNodesWithoutTensor(expr, [&](const Expr* x) {
+      if (auto* var = x->As<ir::_Var_>()) {
+        has_var = true;
+        auto it = var_updates_.find(var->name);
+        if (it != var_updates_.end() && it->second > 0) invariant = false;
+      }
+      return false;
+    });
+    // the expressions on constants only are left to be folded
+    return has_var && invariant;
+  }
+
+  // the var of the Let computing the expression, the structurally equal expressions share one
+  Expr GetVar(const Expr& expr) {
+    for (auto& value_and_var : extracted_) {
+      const Expr& value = value_and_var.first;
+      if (value->node_type() == expr->node_type() && value.type() == expr.type() &&
+          ir::IrEqualVisitor().Compare(value, expr)) {
+        return value_and_var.second;
+      }
+    }
+    Var var(common::UniqName("hoisted"), expr.type());
+    Expr value = optim::IRCopy(expr);
+    extracted_.emplace_back(value, var);
+    lets_.push_back(ir::Let::Make(var, value));
+    return var;
+  }
+
+  const std::unordered_map<std::string, int>& var_updates_;
+  std::vector<std::pair<Expr, Expr>> extracted_;
+  std::vector<Expr> lets_;
+};
+
+struct HoistLoopInvariantLetMutator : public ir::IRMutator<> {
+  using ir::IRMutator<>::Visit;
+
+  void operator()(Expr* expr) { ir::IRMutator<>::Visit(expr, expr); }
+
+  void Visit(const ir::For* op, Expr* expr) override {
+    // hoist the Lets in the inner forloops first, they are placed before the inner forloops in the body
+    ir::IRMutator<>::Visit(op, expr);
+
+    auto* node  = expr->As<ir::For>();
+    auto* block = node->body.As<ir::Block>();
+    // the parallel and GPU forloops may run their bodies in other functions
+    if (!node->is_serial() || !block) return;
+
+    // the times every var is defined or stored to in the forloop
+    std::unordered_map<std::string, int> var_updates;
+    var_updates[node->loop_var->name] += 1;
+    ir::CollectIRNodesWithoutTensor(node->body, [&](const Expr* x) {
+      if (auto* let = x->As<ir::Let>()) {
+        if (let->symbol.As<ir::_Var_>()) var_updates[let->symbol.As<ir::_Var_>()->name] += 1;
+      } else if (auto* store = x->As<ir::Store>()) {
+        if (store->tensor.As<ir::_Var_>()) var_updates[store->tensor.As<ir::_Var_>()->name] += 1;
+      } else if (auto* for_n = x->As<ir::For>()) {
+        var_updates[for_n->loop_var->name] += 1;
+      } else if (auto* poly_for = x->As<ir::PolyFor>()) {
+        var_updates[poly_for->iterator->name] += 1;
+      } else if (auto* schedule_block = x->As<ir::ScheduleBlock>()) {
+        for (const Var& iter_var : schedule_block->iter_vars) var_updates[iter_var->name] += 1;
+      }
+      return false;
+    });
+
+    std::vector<Expr> stmts;
+    for (Expr& stmt : block->stmts) {
+      // the nested blocks are left by hoisting from the inner forloops
+      auto* nested_block = stmt.As<ir::Block>();
+      if (nested_block) {
+        stmts.insert(stmts.end(), nested_block->stmts.begin(), nested_block->stmts.end());
+      } else {
+        stmts.push_back(stmt);
+      }
+    }
+
+    std::vector<Expr> hoisted;
+    std::vector<Expr> kept;
+    for (Expr& stmt : stmts) {
+      auto* let = stmt.As<ir::Let>();
+      if (let && let->body.defined() && let->symbol.As<ir::_Var_>() &&
+          var_updates[let->symbol.As<ir::_Var_>()->name] == 1 && IsHoistableValue(let->body)) {
+        auto used_vars = ir::CollectIRNodesWithoutTensor(let->body, [&](const Expr* x) {
+          return x->As<ir::_Var_>() && var_updates.count(x->As<ir::_Var_>()->name) &&
+                 var_updates[x->As<ir::_Var_>()->name] > 0;
+        });
+        if (used_vars.empty()) {
+          VLOG(4) << "Hoist " << stmt << " out of the forloop over " << node->loop_var;
+          // the var is not changed in the forloop any more
+          var_updates[let->symbol.As<ir::_Var_>()->name] = 0;
+          hoisted.push_back(stmt);
+          continue;
+        }
+      }
+      kept.push_back(stmt);
+    }
+
+    // the subexpressions may use the vars of the hoisted Lets, so they are extracted after hoisting
+    InvariantSubexprExtractor extract(var_updates);
+    for (Expr& stmt : kept) {
+      extract(&stmt);
+    }
+    for (const Expr& let : extract.lets()) {
+      VLOG(4) << "Hoist the extracted " << let << " out of the forloop over " << node->loop_var;
+      hoisted.push_back(let);
+    }
+    // the nested blocks are flattened even if nothing is hoisted
+    block->stmts = kept;
+    if (hoisted.empty()) return;
+
+    hoisted.push_back(*expr);
+    *expr = ir::Block::Make(hoisted);
+  }
+};
+
+}  // namespace
+
+void HoistLoopInvariantLet(Expr* expr) {
+  CHECK(expr);
+  HoistLoopInvariantLetMutator mutator;
+  mutator(expr);
+}
+
+}  // namespace optim
+}  // namespace cinn
@@ -0,0 +1,55 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include "cinn/ir/ir.h"
+
+namespace cinn {
+namespace optim {
+
+/**
+ * Hoist the loop invariant Lets in the bodies of the serial forloops out of the forloops.
+ *
+ * A Let is invariant in a forloop if its value only computes on the vars not changed in the forloop, that is, not
+ * the loop var and not the vars defined or stored to in the forloop except the hoisted ones. The values with Load or
+ * Call are never hoisted, neither are the ones dividing by a non-constant, since the value is computed even if the
+ * forloop runs no iteration after hoisting. The Lets are hoisted from the inner forloops to the outer ones, until
+ * they depend on the forloop.
+ *
+ * Before hoisting, the maximal loop invariant subexpressions in the Store and Let statements of a forloop are
+ * extracted into new Lets, even if they are used only once, and the structurally equal ones share one Let.
+ *
+ * For example:
+ *
+ * \code
+ * for (j, 0, 16) {
+ *   int32 a = (n * 16)
+ *   C[(a + j)] = A[((i * 16) + j)]
+ * }
+ * \endcode
+ *
+ * is transformed to
+ *
+ * \code
+ * int32 a = (n * 16)
+ * int32 hoisted_0 = (i * 16)
+ * for (j, 0, 16) {
+ *   C[(a + j)] = A[(hoisted_0 + j)]
+ * }
+ * \endcode
+ */
+void HoistLoopInvariantLet(Expr* expr);
+
+}  // namespace optim
+}  // namespace cinn
@@ -0,0 +1,138 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/optim/hoist_loop_invariant_let.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "cinn/cinn.h"
+#include "cinn/ir/ir_operators.h"
+#include "cinn/ir/ir_printer.h"
+
+namespace cinn {
+namespace optim {
+
+TEST(HoistLoopInvariantLet, nested_loops) {
+  Placeholder<float> A("A", std::vector<int>{{1024}});
+  Placeholder<float> C("C", std::vector<int>{{1024}});
+
+  Var n("n");
+  Var i("i");
+  Var j("j");
+  Var a("a");
+  Var b("b");
+  Var c("c");
+  Var d("d");
+
+  // a is invariant in both the forloops, b is invariant in the inner one, c varies with j and d loads memory
+  Expr inner_body = ir::Block::Make({
+      ir::Let::Make(Expr(a), Expr(n) * 16),
+      ir::Let::Make(Expr(b), Expr(a) + Expr(i)),
+      ir::Let::Make(Expr(c), Expr(b) + Expr(j)),
+      ir::Let::Make(Expr(d), ir::Cast::Make(Int(32), ir::Load::Make(ir::Tensor(A), {Expr(a)}))),
+      ir::Store::Make(ir::Tensor(C), ir::Load::Make(ir::Tensor(A), {Expr(c)}), {Expr(c) + Expr(d)}),
+  });
+  Expr inner_loop = ir::For::Make(j, Expr(0), Expr(16), ir::ForType::Serial, ir::DeviceAPI::UNK, inner_body);
+  Expr e =
+      ir::For::Make(i, Expr(0), Expr(64), ir::ForType::Serial, ir::DeviceAPI::UNK, ir::Block::Make({inner_loop}));
+  LOG(INFO) << "Before:\n" << e;
+
+  HoistLoopInvariantLet(&e);
+  LOG(INFO) << "After:\n" << e;
+
+  auto* outer_block = e.As<ir::Block>();
+  ASSERT_TRUE(outer_block);
+  ASSERT_EQ(outer_block->stmts.size(), 2UL);
+  ASSERT_TRUE(outer_block->stmts[0].As<ir::Let>());
+  EXPECT_EQ(outer_block->stmts[0].As<ir::Let>()->symbol.as_var_ref()->name, "a");
+
+  auto* outer_loop = outer_block->stmts[1].As<ir::For>();
+  ASSERT_TRUE(outer_loop);
+  auto& outer_stmts = outer_loop->body.As<ir::Block>()->stmts;
+  ASSERT_EQ(outer_stmts.size(), 2UL);
+  ASSERT_TRUE(outer_stmts[0].As<ir::Let>());
+  EXPECT_EQ(outer_stmts[0].As<ir::Let>()->symbol.as_var_ref()->name, "b");
+
+  auto* loop = outer_stmts[1].As<ir::For>();
+  ASSERT_TRUE(loop);
+  auto& stmts = loop->body.As<ir::Block>()->stmts;
+  ASSERT_EQ(stmts.size(), 3UL);
+  EXPECT_EQ(stmts[0].As<ir::Let>()->symbol.as_var_ref()->name, "c");
+  EXPECT_EQ(stmts[1].As<ir::Let>()->symbol.as_var_ref()->name, "d");
+}
+
+TEST(HoistLoopInvariantLet, parallel_loop) {
+  Placeholder<float> C("C", std::vector<int>{{1024}});
+
+  Var n("n");
+  Var i("i");
+  Var a("a");
+
+  Expr body = ir::Block::Make({
+      ir::Let::Make(Expr(a), Expr(n) * 16),
+      ir::Store::Make(ir::Tensor(C), Expr(1.f), {Expr(a) + Expr(i)}),
+  });
+  Expr e = ir::For::Make(i, Expr(0), Expr(16), ir::ForType::Parallel, ir::DeviceAPI::UNK, body);
+
+  HoistLoopInvariantLet(&e);
+
+  // the body of a parallel forloop may run in another function, so nothing is hoisted
+  ASSERT_TRUE(e.As<ir::For>());
+  EXPECT_EQ(e.As<ir::For>()->body.As<ir::Block>()->stmts.size(), 2UL);
+}
+
+TEST(HoistLoopInvariantLet, single_use_subexpr) {
+  Placeholder<float> A("A", std::vector<int>{{1024}});
+  Placeholder<float> C("C", std::vector<int>{{1024}});
+
+  Var i("i");
+  Var j("j");
+
+  // i * 16 is used once by the Store and once by the Load, without any Let
+  Expr inner_body = ir::Block::Make({
+      ir::Store::Make(ir::Tensor(C),
+                      ir::Load::Make(ir::Tensor(A), {Expr(i) * 16 + Expr(j)}),
+                      {Expr(i) * 16 + Expr(j) * 2}),
+  });
+  Expr inner_loop = ir::For::Make(j, Expr(0), Expr(16), ir::ForType::Serial, ir::DeviceAPI::UNK, inner_body);
+  Expr e =
+      ir::For::Make(i, Expr(0), Expr(64), ir::ForType::Serial, ir::DeviceAPI::UNK, ir::Block::Make({inner_loop}));
+
+  HoistLoopInvariantLet(&e);
+  LOG(INFO) << "After:\n" << e;
+
+  // the extracted Let depends on i, so it stays in the outer forloop
+  auto* outer_loop = e.As<ir::For>();
+  ASSERT_TRUE(outer_loop);
+  auto& outer_stmts = outer_loop->body.As<ir::Block>()->stmts;
+  ASSERT_EQ(outer_stmts.size(), 2UL);
+  auto* let = outer_stmts[0].As<ir::Let>();
+  ASSERT_TRUE(let);
+  EXPECT_EQ(utils::GetStreamCnt(let->body), "(i * 16)");
+
+  auto* loop = outer_stmts[1].As<ir::For>();
+  ASSERT_TRUE(loop);
+  auto& stmts = loop->body.As<ir::Block>()->stmts;
+  ASSERT_EQ(stmts.size(), 1UL);
+  auto* store = stmts[0].As<ir::Store>();
+  ASSERT_TRUE(store);
+  Expr var = let->symbol;
+  EXPECT_EQ(utils::GetStreamCnt(store->indices[0]), "(" + var.as_var_ref()->name + " + (j * 2))");
+  EXPECT_EQ(utils::GetStreamCnt(store->value.As<ir::Load>()->indices[0]), "(" + var.as_var_ref()->name + " + j)");
+}
+
+}  // namespace optim
+}  // namespace cinn
@@ -20,8 +20,10 @@
 #include "cinn/optim/cast_bool_to_int8.h"
 #include "cinn/optim/cast_simplify.h"
 #include "cinn/optim/eliminate_broadcast_in_forloop.h"
+#include "cinn/optim/eliminate_common_subexpr.h"
 #include "cinn/optim/extern_call_process.h"
 #include "cinn/optim/fold_cinn_call_arguments.h"
+#include "cinn/optim/hoist_loop_invariant_let.h"
 #include "cinn/optim/if_simplify.h"
 #include "cinn/optim/insert_debug_log_callee.h"
 #include "cinn/optim/ir_copy.h"
@@ -29,6 +31,7 @@
 #include "cinn/optim/lower_function_call_bind_vars.h"
 #include "cinn/optim/lower_intrin.h"
 #include "cinn/optim/map_extern_call.h"
+#include "cinn/optim/reduce_index_strength.h"
 #include "cinn/optim/remove_nested_block.h"
 #include "cinn/optim/remove_schedule_block.h"
 #include "cinn/optim/replace_const_param_to_integer.h"
@@ -38,6 +41,8 @@
 #include "cinn/optim/vectorize_loops.h"
 
 DECLARE_bool(cinn_ir_schedule);
+DECLARE_bool(cinn_enable_cse_licm);
+DECLARE_bool(cinn_enable_index_strength_reduction);
 
 namespace cinn {
 namespace optim {
@@ -68,6 +73,12 @@ Expr Optimize(Expr e, Target target, bool runtime_debug_info) {
   Simplify(&copied);
   IfSimplify(&copied);
 
+  if (FLAGS_cinn_enable_cse_licm) {
+    EliminateCommonSubexpr(&copied);
+    HoistLoopInvariantLet(&copied);
+    RemoveNestedBlock(&copied);
+  }
+
   if (runtime_debug_info) {
     LOG(WARNING) << "Turn on runtime debug information output";
     InsertDebugLogCallee(&copied);
@@ -82,6 +93,10 @@ ir::Module Optimize(const ir::Module& module, const Target& target) {
     VectorizeLoops(&copied, Target());
   }
   RemoveScheduleBlock(&copied);
+  // the indices are computed from the loop vars only after the schedule blocks are removed
+  if (FLAGS_cinn_enable_index_strength_reduction) {
+    ReduceIndexStrength(&copied);
+  }
   LowerFunctionCallBindVars(&copied);
   CallArgListToPodValue(&copied);
   LowerIntrin(&copied, target);
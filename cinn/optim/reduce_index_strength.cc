@@ -0,0 +1,432 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/optim/reduce_index_strength.h"
+
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "cinn/common/context.h"
+#include "cinn/common/ir_util.h"
+#include "cinn/ir/collect_ir_nodes.h"
+#include "cinn/ir/ir_compare.h"
+#include "cinn/ir/ir_mutator.h"
+#include "cinn/ir/ir_printer.h"
+#include "cinn/optim/ir_copy.h"
+
+namespace cinn {
+namespace optim {
+
+namespace detail {
+
+bool FindDivisionMagic(int64_t divisor, int64_t max_dividend, uint64_t* multiplier, int* shift) {
+  CHECK_GT(divisor, 0);
+  CHECK_GE(max_dividend, 0);
+  constexpr uint64_t kLimit = uint64_t(1) << 63;
+  for (int s = 0; s < 63; ++s) {
+    uint64_t power = uint64_t(1) << s;
+    uint64_t m     = (power + divisor - 1) / divisor;
+    // x * m / 2^s = x / divisor + x * error / (divisor * 2^s), which keeps the floor if x * error < 2^s
+    uint64_t error = m * divisor - power;
+    if (max_dividend > 0 && m > (kLimit - 1) / max_dividend) {
+      return false;
+    }
+    if (error == 0 || static_cast<uint64_t>(max_dividend) < (power + error - 1) / error) {
+      *multiplier = m;
+      *shift      = s;
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace detail
+
+namespace {
+
+struct Interval {
+  int64_t lower;
+  int64_t upper;
+};
+
+// the bound of the intervals, to keep the arithmetic on them from overflowing
+constexpr int64_t kMaxBound = int64_t(1) << 40;
+
+// compute the interval of an integer expression from the intervals of the vars, return false if unknown
+bool EvaluateInterval(const Expr& expr, const std::unordered_map<std::string, Interval>& var_intervals, Interval* res) {
+  if (auto* imm = expr.As<ir::IntImm>()) {
+    *res = Interval{imm->value, imm->value};
+  } else if (auto* var = expr.As<ir::_Var_>()) {
+    auto it = var_intervals.find(var->name);
+    if (it == var_intervals.end()) return false;
+    *res = it->second;
+  } else if (auto* cast = expr.As<ir::Cast>()) {
+    if (!cast->type().is_int() || !cast->v().type().is_int()) return false;
+    if (!EvaluateInterval(cast->v(), var_intervals, res)) return false;
+  } else if (expr.As<ir::Add>() || expr.As<ir::Sub>() || expr.As<ir::Mul>() || expr.As<ir::Min>() ||
+             expr.As<ir::Max>() || expr.As<ir::Div>() || expr.As<ir::Mod>()) {
+    Interval a, b;
+    if (!EvaluateInterval(expr->operand(0), var_intervals, &a) ||
+        !EvaluateInterval(expr->operand(1), var_intervals, &b)) {
+      return false;
+    }
+    if (expr.As<ir::Add>()) {
+      *res = Interval{a.lower + b.lower, a.upper + b.upper};
+    } else if (expr.As<ir::Sub>()) {
+      *res = Interval{a.lower - b.upper, a.upper - b.lower};
+    } else if (expr.As<ir::Mul>()) {
+      // the operands are bounded by kMaxBound, whose products may still overflow
+      int64_t products[4];
+      if (__builtin_mul_overflow(a.lower, b.lower, &products[0]) ||
+          __builtin_mul_overflow(a.lower, b.upper, &products[1]) ||
+          __builtin_mul_overflow(a.upper, b.lower, &products[2]) ||
+          __builtin_mul_overflow(a.upper, b.upper, &products[3])) {
+        return false;
+      }
+      *res = Interval{*std::min_element(products, products + 4), *std::max_element(products, products + 4)};
+    } else if (expr.As<ir::Min>()) {
+      *res = Interval{std::min(a.lower, b.lower), std::min(a.upper, b.upper)};
+    } else if (expr.As<ir::Max>()) {
+      *res = Interval{std::max(a.lower, b.lower), std::max(a.upper, b.upper)};
+    } else {
+      // only the non-negative dividends and positive constant divisors are supported
+      if (a.lower < 0 || b.lower != b.upper || b.lower <= 0) return false;
+      if (expr.As<ir::Div>()) {
+        *res = Interval{a.lower / b.lower, a.upper / b.lower};
+      } else {
+        *res = a.upper < b.lower ? a : Interval{0, b.lower - 1};
+      }
+    }
+  } else {
+    return false;
+  }
+  return res->lower > -kMaxBound && res->upper < kMaxBound;
+}
+
+// the names of the buffers and vars stored to in expr, a Let of the same name defines a local variable which
+// changes after the Let, so its initial value doesn't bound it
+std::unordered_set<std::string> CollectStoredNames(const Expr& expr) {
+  std::unordered_set<std::string> names;
+  ir::CollectIRNodesWithoutTensor(expr, [&](const Expr* x) {
+    if (auto* store = x->As<ir::Store>()) {
+      if (store->tensor.As<ir::_Var_>()) {
+        names.insert(store->tensor.As<ir::_Var_>()->name);
+      } else if (store->tensor.As<ir::_Tensor_>()) {
+        names.insert(store->tensor.As<ir::_Tensor_>()->name);
+      }
+    }
+    return false;
+  });
+  return names;
+}
+
+// make_const doesn't support the unsigned types except bool
+Expr MakeUIntConst(const Type& type, uint64_t value) { return make_shared<ir::UIntImm>(type, value); }
+
+// rewrite the divisions and modulos by constants on non-negative dividends
+struct DivisionMutator : public ir::IRMutator<> {
+  using ir::IRMutator<>::Visit;
+
+  void operator()(Expr* expr) {
+    stored_names_ = CollectStoredNames(*expr);
+    ir::IRMutator<>::Visit(expr, expr);
+  }
+
+  void Visit(const ir::For* op, Expr* expr) override {
+    auto* node = expr->As<ir::For>();
+    ir::IRMutator<>::Visit(&node->min, &node->min);
+    ir::IRMutator<>::Visit(&node->extent, &node->extent);
+    Interval min, extent;
+    bool known = EvaluateInterval(node->min, var_intervals_, &min) &&
+                 EvaluateInterval(node->extent, var_intervals_, &extent) && extent.upper > min.lower;
+    if (known) {
+      var_intervals_[node->loop_var->name] = Interval{min.lower, extent.upper - 1};
+    }
+    ir::IRMutator<>::Visit(&node->body, &node->body);
+    var_intervals_.erase(node->loop_var->name);
+  }
+
+  void Visit(const ir::Let* op, Expr* expr) override {
+    ir::IRMutator<>::Visit(op, expr);
+    auto* node = expr->As<ir::Let>();
+    Interval interval;
+    // the interval of the initial value is stale for the uses after a Store to the var, which may precede
+    // the Store in the text, such as in a forloop
+    if (node->body.defined() && node->symbol.As<ir::_Var_>() && node->symbol.type().is_int() &&
+        !stored_names_.count(node->symbol.As<ir::_Var_>()->name) &&
+        EvaluateInterval(node->body, var_intervals_, &interval)) {
+      var_intervals_[node->symbol.As<ir::_Var_>()->name] = interval;
+    }
+  }
+
+  void Visit(const ir::Div* op, Expr* expr) override {
+    ir::IRMutator<>::Visit(op, expr);
+    ReduceDivOrMod(expr);
+  }
+
+  void Visit(const ir::Mod* op, Expr* expr) override {
+    ir::IRMutator<>::Visit(op, expr);
+    ReduceDivOrMod(expr);
+  }
+
+ private:
+  void ReduceDivOrMod(Expr* expr) {
+    Type type = expr->type();
+    if (!(type.is_int(32) || type.is_int(64)) || type.lanes() != 1) return;
+    Expr a                    = (*expr)->operand(0);
+    const ir::IntImm* divisor = (*expr)->operand(1).As<ir::IntImm>();
+    Interval interval;
+    if (!divisor || divisor->value <= 1 || !EvaluateInterval(a, var_intervals_, &interval) || interval.lower < 0) {
+      return;
+    }
+    int64_t d = divisor->value;
+    if ((d & (d - 1)) == 0) {
+      // the unsigned division and modulo by a power of two are a shift and a mask
+      Type unsigned_type = common::UInt(type.bits());
+      Expr unsigned_a    = ir::Cast::Make(unsigned_type, a);
+      Expr unsigned_d    = MakeUIntConst(unsigned_type, d);
+      *expr              = ir::Cast::Make(type,
+                                         expr->As<ir::Div>() ? ir::Div::Make(unsigned_a, unsigned_d)
+                                                             : ir::Mod::Make(unsigned_a, unsigned_d));
+      return;
+    }
+
+    uint64_t multiplier = 0;
+    int shift           = 0;
+    if (!detail::FindDivisionMagic(d, interval.upper, &multiplier, &shift)) return;
+    // compute in 32 bits if the product fits
+    int bits = static_cast<uint64_t>(interval.upper) * multiplier <= std::numeric_limits<uint32_t>::max() &&
+                       shift < 32
+                   ? 32
+                   : 64;
+    Type unsigned_type = common::UInt(bits);
+    Expr quotient      = ir::Cast::Make(
+        type,
+        ir::Div::Make(ir::Mul::Make(ir::Cast::Make(unsigned_type, a), MakeUIntConst(unsigned_type, multiplier)),
+                      MakeUIntConst(unsigned_type, uint64_t(1) << shift)));
+    VLOG(4) << "Reduce " << *expr << " to the quotient " << quotient;
+    if (expr->As<ir::Div>()) {
+      *expr = quotient;
+    } else {
+      *expr = ir::Sub::Make(optim::IRCopy(a), ir::Mul::Make(quotient, common::make_const(type, d)));
+    }
+  }
+
+  std::unordered_map<std::string, Interval> var_intervals_;
+  std::unordered_set<std::string> stored_names_;
+};
+
+// split expr * scale into the terms of a sum, distributing the constant factors over Add and Sub,
+// the constant terms are summed up to constant
+void SplitTerms(const Expr& expr, int64_t scale, std::vector<std::pair<Expr, int64_t>>* terms, int64_t* constant) {
+  if (auto* imm = expr.As<ir::IntImm>()) {
+    *constant += imm->value * scale;
+  } else if (auto* add = expr.As<ir::Add>()) {
+    SplitTerms(add->a(), scale, terms, constant);
+    SplitTerms(add->b(), scale, terms, constant);
+  } else if (auto* sub = expr.As<ir::Sub>()) {
+    SplitTerms(sub->a(), scale, terms, constant);
+    SplitTerms(sub->b(), -scale, terms, constant);
+  } else if (expr.As<ir::Mul>() && expr.As<ir::Mul>()->b().As<ir::IntImm>()) {
+    SplitTerms(expr.As<ir::Mul>()->a(), scale * expr.As<ir::Mul>()->b().As<ir::IntImm>()->value, terms, constant);
+  } else if (expr.As<ir::Mul>() && expr.As<ir::Mul>()->a().As<ir::IntImm>()) {
+    SplitTerms(expr.As<ir::Mul>()->b(), scale * expr.As<ir::Mul>()->a().As<ir::IntImm>()->value, terms, constant);
+  } else {
+    terms->emplace_back(expr, scale);
+  }
+}
+
+// sum up the terms and the constant
+Expr SumTerms(const std::vector<std::pair<Expr, int64_t>>& terms, int64_t constant, const Type& type) {
+  Expr sum;
+  for (auto& term : terms) {
+    if (term.second == 0) continue;
+    int64_t magnitude = term.second > 0 ? term.second : -term.second;
+    Expr value        = magnitude == 1 ? term.first : ir::Mul::Make(common::make_const(type, magnitude), term.first);
+    if (!sum.defined()) {
+      sum = term.second > 0 ? value : ir::Sub::Make(common::make_const(type, 0), value);
+    } else {
+      sum = term.second > 0 ? ir::Add::Make(sum, value) : ir::Sub::Make(sum, value);
+    }
+  }
+  if (!sum.defined()) return common::make_const(type, constant);
+  if (constant > 0) return ir::Add::Make(sum, common::make_const(type, constant));
+  if (constant < 0) return ir::Sub::Make(sum, common::make_const(type, -constant));
+  return sum;
+}
+
+// split the loop invariant part of the affine indices into the Lets before serial forloops
+struct InvariantOffsetMutator : public ir::IRMutator<> {
+  using ir::IRMutator<>::Visit;
+
+  void operator()(Expr* expr) { ir::IRMutator<>::Visit(expr, expr); }
+
+  void Visit(const ir::For* op, Expr* expr) override {
+    // the inner forloops first, their offsets are placed before them in the body
+    ir::IRMutator<>::Visit(op, expr);
+
+    auto* node  = expr->As<ir::For>();
+    auto* block = node->body.As<ir::Block>();
+    // the parallel and GPU forloops may run their bodies in other functions
+    if (!node->is_serial() || !block) return;
+
+    // the vars which vary in the iterations
+    std::unordered_set<std::string> variant_vars = {node->loop_var->name};
+    std::unordered_set<std::string> stored_vars  = CollectStoredNames(node->body);
+    ir::CollectIRNodesWithoutTensor(node->body, [&](const Expr* x) {
+      if (auto* let = x->As<ir::Let>()) {
+        if (let->symbol.As<ir::_Var_>()) variant_vars.insert(let->symbol.As<ir::_Var_>()->name);
+      } else if (auto* for_n = x->As<ir::For>()) {
+        variant_vars.insert(for_n->loop_var->name);
+      } else if (auto* poly_for = x->As<ir::PolyFor>()) {
+        variant_vars.insert(poly_for->iterator->name);
+      } else if (auto* schedule_block = x->As<ir::ScheduleBlock>()) {
+        for (const Var& iter_var : schedule_block->iter_vars) variant_vars.insert(iter_var->name);
+      }
+      return false;
+    });
+    variant_vars.insert(stored_vars.begin(), stored_vars.end());
+
+    std::vector<Expr> stmts;
+    for (Expr& stmt : block->stmts) {
+      // the nested blocks are left by splitting the offsets of the inner forloops
+      if (auto* nested_block = stmt.As<ir::Block>()) {
+        stmts.insert(stmts.end(), nested_block->stmts.begin(), nested_block->stmts.end());
+      } else {
+        stmts.push_back(stmt);
+      }
+    }
+
+    OffsetSplitter splitter(&variant_vars);
+    std::vector<Expr> new_stmts;
+    for (Expr& stmt : stmts) {
+      auto* let = stmt.As<ir::Let>();
+      if (let && let->symbol.As<ir::_Var_>() && let->body.defined() && let->body.type().is_int() &&
+          let->body.type().lanes() == 1) {
+        // the offsets split from the inner forloops are hoisted as a whole or split further,
+        // but the vars stored to are initialized in every iteration
+        if (!stored_vars.count(let->symbol.as_var_ref()->name) && splitter.IsInvariant(let->body)) {
+          splitter.offsets.push_back(stmt);
+          continue;
+        }
+        splitter.Split(&let->body);
+      }
+      splitter(&stmt);
+      new_stmts.push_back(stmt);
+    }
+    if (splitter.offsets.empty()) return;
+
+    block->stmts = new_stmts;
+    splitter.offsets.push_back(*expr);
+    *expr = ir::Block::Make(splitter.offsets);
+  }
+
+ private:
+  // split the invariant parts of the indices in the body of a forloop except its inner forloops
+  struct OffsetSplitter : public ir::IRMutator<> {
+    using ir::IRMutator<>::Visit;
+
+    explicit OffsetSplitter(const std::unordered_set<std::string>* variant_vars) : variant_vars(variant_vars) {}
+
+    void operator()(Expr* expr) { ir::IRMutator<>::Visit(expr, expr); }
+
+    void Visit(const ir::For* op, Expr* expr) override {}
+
+    void Visit(const ir::PolyFor* op, Expr* expr) override {}
+
+    void Visit(const ir::Load* op, Expr* expr) override {
+      ir::IRMutator<>::Visit(op, expr);
+      for (Expr& index : expr->As<ir::Load>()->indices) SplitIndex(&index);
+    }
+
+    void Visit(const ir::Store* op, Expr* expr) override {
+      ir::IRMutator<>::Visit(op, expr);
+      for (Expr& index : expr->As<ir::Store>()->indices) SplitIndex(&index);
+    }
+
+    void SplitIndex(Expr* index) {
+      if (auto* ramp = index->As<ir::Ramp>()) {
+        Split(&ramp->base);
+      } else {
+        Split(index);
+      }
+    }
+
+    // replace the invariant terms of the integer expression with a var defined by the Lets in offsets
+    void Split(Expr* expr) {
+      Type type = expr->type();
+      if (!type.is_int() || type.lanes() != 1) return;
+
+      std::vector<std::pair<Expr, int64_t>> terms;
+      int64_t constant = 0;
+      SplitTerms(*expr, 1, &terms, &constant);
+      std::vector<std::pair<Expr, int64_t>> invariant_terms, variant_terms;
+      for (auto& term : terms) {
+        (IsInvariant(term.first) ? invariant_terms : variant_terms).push_back(term);
+      }
+      // it's useless to compute a var or a constant ahead
+      if (invariant_terms.empty() || (invariant_terms.size() == 1 && invariant_terms[0].second == 1 &&
+                                      invariant_terms[0].first.As<ir::_Var_>() && constant == 0)) {
+        return;
+      }
+
+      Expr offset = SumTerms(invariant_terms, constant, type);
+      Var offset_var;
+      for (auto& let : offsets) {
+        if (ir::IrEqualVisitor().Compare(let.As<ir::Let>()->body, offset)) {
+          offset_var = let.As<ir::Let>()->symbol.as_var_ref();
+          break;
+        }
+      }
+      if (!offset_var.defined()) {
+        offset_var = Var(common::UniqName("offset"), type);
+        offsets.push_back(ir::Let::Make(offset_var, offset));
+      }
+      variant_terms.insert(variant_terms.begin(), std::make_pair(Expr(offset_var), int64_t(1)));
+      VLOG(4) << "Split the invariant offset " << offset << " of " << *expr;
+      *expr = SumTerms(variant_terms, 0, type);
+    }
+
+    bool IsInvariant(const Expr& term) {
+      auto variant_nodes = ir::CollectIRNodesWithoutTensor(term, [&](const Expr* x) {
+        return x->As<ir::Load>() || x->As<ir::Call>() || x->As<ir::_Tensor_>() || x->As<ir::_Buffer_>() ||
+               (x->As<ir::_Var_>() && variant_vars->count(x->As<ir::_Var_>()->name)) ||
+               // the division by zero is not safe to compute if the forloop runs no iteration
+               (x->As<ir::Div>() && !x->As<ir::Div>()->b().is_constant()) ||
+               (x->As<ir::Mod>() && !x->As<ir::Mod>()->b().is_constant());
+      });
+      return variant_nodes.empty();
+    }
+
+    const std::unordered_set<std::string>* variant_vars;
+    // the Lets of the invariant offsets
+    std::vector<Expr> offsets;
+  };
+};
+
+}  // namespace
+
+void ReduceIndexStrength(Expr* expr) {
+  CHECK(expr);
+  DivisionMutator()(expr);
+  InvariantOffsetMutator()(expr);
+}
+
+}  // namespace optim
+}  // namespace cinn
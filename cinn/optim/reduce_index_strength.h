@@ -0,0 +1,66 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <cstdint>
+
+#include "cinn/ir/ir.h"
+
+namespace cinn {
+namespace optim {
+
+/**
+ * Reduce the strength of the integer index arithmetic in the lowered IR.
+ *
+ * 1. The divisions and modulos by a positive constant whose dividends are proven non-negative by the ranges of the
+ *    forloops are computed in unsigned arithmetic, a power of two becomes a shift or mask, and the others become a
+ *    multiplication by a magic number and a shift, without the sign fix-up the backends emit for the signed ones.
+ * 2. The terms of the affine indices of Load and Store which are invariant in a serial forloop are summed up by a
+ *    Let before the forloop, so the index in the body only adds the terms on the loop var to the offset, which the
+ *    backends turn into an increment carried across the iterations. The Lets are hoisted level by level, so every
+ *    level of a loop nest computes its part of the offset once.
+ *
+ * For example:
+ *
+ * \code
+ * for (i, 0, 64) {
+ *   for (j, 0, 768) {
+ *     B[((768 * i) + j)] = A[(((768 * i) + j) / 3)]
+ *   }
+ * }
+ * \endcode
+ *
+ * is transformed to
+ *
+ * \code
+ * for (i, 0, 64) {
+ *   int32 offset = (768 * i)
+ *   for (j, 0, 768) {
+ *     B[(offset + j)] = A[int32(((uint32(((768 * i) + j)) * 43691) / 131072))]
+ *   }
+ * }
+ * \endcode
+ */
+void ReduceIndexStrength(Expr* expr);
+
+namespace detail {
+
+//! Find the magic number \p multiplier and \p shift, such that x / divisor == (x * multiplier) >> shift for every x in
+//! [0, max_dividend] without overflowing 63 bits, return false if not found.
+bool FindDivisionMagic(int64_t divisor, int64_t max_dividend, uint64_t* multiplier, int* shift);
+
+}  // namespace detail
+
+}  // namespace optim
+}  // namespace cinn
@@ -0,0 +1,203 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/optim/reduce_index_strength.h"
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "cinn/backends/compiler.h"
+#include "cinn/cinn.h"
+#include "cinn/common/test_helper.h"
+#include "cinn/ir/collect_ir_nodes.h"
+#include "cinn/ir/ir_operators.h"
+#include "cinn/ir/ir_printer.h"
+#include "cinn/utils/string.h"
+
+DECLARE_bool(cinn_enable_index_strength_reduction);
+
+namespace cinn {
+namespace optim {
+
+TEST(ReduceIndexStrength, division_magic) {
+  for (int64_t divisor = 1; divisor <= 100; ++divisor) {
+    for (int64_t max_dividend : {0, 1, 255, 4096, 100000}) {
+      uint64_t multiplier = 0;
+      int shift           = 0;
+      ASSERT_TRUE(detail::FindDivisionMagic(divisor, max_dividend, &multiplier, &shift));
+      for (uint64_t x = 0; x <= static_cast<uint64_t>(max_dividend); ++x) {
+        ASSERT_EQ((x * multiplier) >> shift, x / divisor) << x << " / " << divisor;
+      }
+    }
+  }
+}
+
+TEST(ReduceIndexStrength, basic) {
+  Placeholder<float> A("A", std::vector<int>{{8192}});
+  Placeholder<float> B("B", std::vector<int>{{24576}});
+  Placeholder<float> C("C", std::vector<int>{{8}});
+
+  Var i("i");
+  Var j("j");
+  Expr index = Expr(i) * 768 + Expr(j);
+
+  Expr value = ir::Load::Make(ir::Tensor(A), {index / 3}) + ir::Load::Make(ir::Tensor(C), {index % 8});
+  Expr inner = ir::For::Make(j,
+                             Expr(0),
+                             Expr(768),
+                             ir::ForType::Serial,
+                             ir::DeviceAPI::Host,
+                             ir::Block::Make({ir::Store::Make(ir::Tensor(B), value, {index})}));
+  Expr e     = ir::For::Make(i, Expr(0), Expr(32), ir::ForType::Serial, ir::DeviceAPI::Host, ir::Block::Make({inner}));
+  LOG(INFO) << "Before:\n" << e;
+
+  ReduceIndexStrength(&e);
+  LOG(INFO) << "After:\n" << e;
+
+  // the divisions and modulos are computed in unsigned arithmetic
+  auto div_or_mods =
+      ir::CollectIRNodesWithoutTensor(e, [](const Expr* x) { return x->As<ir::Div>() || x->As<ir::Mod>(); });
+  ASSERT_EQ(div_or_mods.size(), 2UL);
+  for (auto& div_or_mod : div_or_mods) {
+    EXPECT_TRUE(div_or_mod.type().is_uint()) << div_or_mod;
+  }
+
+  // the invariant offset of the index of B is computed once for every i
+  auto* outer_loop = e.As<ir::For>();
+  ASSERT_TRUE(outer_loop);
+  auto& outer_stmts = outer_loop->body.As<ir::Block>()->stmts;
+  ASSERT_EQ(outer_stmts.size(), 2UL);
+  auto* let = outer_stmts[0].As<ir::Let>();
+  ASSERT_TRUE(let);
+  EXPECT_EQ(utils::GetStreamCnt(let->body), "(768 * i)");
+
+  auto* loop = outer_stmts[1].As<ir::For>();
+  ASSERT_TRUE(loop);
+  auto* store = loop->body.As<ir::Block>()->stmts[0].As<ir::Store>();
+  ASSERT_TRUE(store);
+  EXPECT_EQ(utils::GetStreamCnt(store->indices[0]), "(" + let->symbol.as_var_ref()->name + " + j)");
+}
+
+TEST(ReduceIndexStrength, negative_dividend) {
+  Placeholder<float> A("A", std::vector<int>{{16}});
+  Placeholder<float> C("C", std::vector<int>{{16}});
+
+  Var i("i");
+  Expr body = ir::Block::Make(
+      {ir::Store::Make(ir::Tensor(C), ir::Load::Make(ir::Tensor(A), {(Expr(i) - 8) / 3 + 8}), {Expr(i)})});
+  Expr e = ir::For::Make(i, Expr(0), Expr(16), ir::ForType::Serial, ir::DeviceAPI::Host, body);
+
+  ReduceIndexStrength(&e);
+
+  // the signed division rounds towards zero, which differs from the unsigned one for negative dividends
+  auto divs = ir::CollectIRNodesWithoutTensor(e, [](const Expr* x) { return x->As<ir::Div>(); });
+  ASSERT_EQ(divs.size(), 1UL);
+  EXPECT_TRUE(divs.begin()->type().is_int(32));
+}
+
+TEST(ReduceIndexStrength, overflowed_interval) {
+  Placeholder<float> A("A", std::vector<int>{{16}});
+  Placeholder<float> C("C", std::vector<int>{{1048576}});
+
+  // both the factors are less than 2^39, but their product overflows int64
+  Var i("i");
+  Expr factor = Expr(i) * 524288;
+  Expr body   = ir::Block::Make(
+      {ir::Store::Make(ir::Tensor(C), ir::Load::Make(ir::Tensor(A), {(factor * factor) / 3 % 16}), {Expr(i)})});
+  Expr e = ir::For::Make(i, Expr(0), Expr(1048576), ir::ForType::Serial, ir::DeviceAPI::Host, body);
+
+  ReduceIndexStrength(&e);
+  LOG(INFO) << "After:\n" << e;
+
+  // the interval of the product is unknown, so the division and modulo are kept signed
+  auto div_or_mods =
+      ir::CollectIRNodesWithoutTensor(e, [](const Expr* x) { return x->As<ir::Div>() || x->As<ir::Mod>(); });
+  ASSERT_EQ(div_or_mods.size(), 2UL);
+  for (auto& div_or_mod : div_or_mods) {
+    EXPECT_TRUE(div_or_mod.type().is_int(32)) << div_or_mod;
+  }
+}
+
+TEST(ReduceIndexStrength, stored_let) {
+  Placeholder<float> A("A", std::vector<int>{{16}});
+  Placeholder<float> C("C", std::vector<int>{{16}});
+  // the local variable x is defined by the Let, and incremented by the Store to it in every iteration
+  Placeholder<int> X("x", std::vector<int>{{1}});
+
+  Var i("i");
+  Var x("x", Int(32));
+  Expr body = ir::Block::Make({ir::Store::Make(ir::Tensor(C), ir::Load::Make(ir::Tensor(A), {Expr(x) / 3}), {Expr(i)}),
+                               ir::Store::Make(ir::Tensor(X), Expr(x) + 1, {Expr(0)})});
+  Expr e    = ir::Block::Make({ir::Let::Make(x, Expr(0)),
+                            ir::For::Make(i, Expr(0), Expr(16), ir::ForType::Serial, ir::DeviceAPI::Host, body)});
+
+  ReduceIndexStrength(&e);
+  LOG(INFO) << "After:\n" << e;
+
+  // the initial value 0 of x doesn't bound x / 3, which is kept
+  auto divs = ir::CollectIRNodesWithoutTensor(e, [](const Expr* node) { return node->As<ir::Div>(); });
+  ASSERT_EQ(divs.size(), 1UL);
+  EXPECT_EQ(utils::GetStreamCnt(*divs.begin()), "(x / 3)");
+}
+
+TEST(ReduceIndexStrength, optimize_and_codegen) {
+  bool enabled                               = FLAGS_cinn_enable_index_strength_reduction;
+  FLAGS_cinn_enable_index_strength_reduction = true;
+  Expr M(96);
+  Placeholder<float> A("A", std::vector<int>{{32}});
+  Placeholder<float> B("B", std::vector<int>{{8}});
+  auto C = Compute(
+      {M}, [&](Expr i) { return A(i / 3) + B(i % 8); }, "C");
+  auto stages = CreateStages({C});
+  auto fn     = Lower("fn", stages, {A, B, C});
+
+  ir::Module::Builder builder("reduce_index_strength_module", common::DefaultHostTarget());
+  builder.AddFunction(fn);
+  ir::Module module                          = builder.Build();
+  FLAGS_cinn_enable_index_strength_reduction = enabled;
+
+  // i / 3 is a multiplication and an unsigned division by a power of two, and i % 8 is an unsigned modulo
+  ASSERT_EQ(module.functions().size(), 1UL);
+  Expr optimized = module.functions()[0]->body;
+  LOG(INFO) << "Optimized:\n" << optimized;
+  auto div_or_mods = ir::CollectIRNodesWithoutTensor(
+      optimized, [](const Expr* x) { return x->As<ir::Div>() || x->As<ir::Mod>(); });
+  ASSERT_EQ(div_or_mods.size(), 2UL);
+  for (auto& div_or_mod : div_or_mods) {
+    EXPECT_TRUE(div_or_mod.type().is_uint()) << div_or_mod;
+  }
+
+  auto compiler = backends::Compiler::Create(common::DefaultHostTarget());
+  compiler->Build(module);
+  auto* fnp = compiler->Lookup("fn");
+  ASSERT_TRUE(fnp);
+
+  auto* Ab  = common::BufferBuilder(Float(32), {32}).set_random().Build();
+  auto* Bb  = common::BufferBuilder(Float(32), {8}).set_random().Build();
+  auto* Cb  = common::BufferBuilder(Float(32), {96}).set_zero().Build();
+  auto args = common::ArgsBuilder().Add(Ab).Add(Bb).Add(Cb).Build();
+  reinterpret_cast<void (*)(void*, int)>(fnp)(args.data(), args.size());
+
+  auto* Ad = reinterpret_cast<float*>(Ab->memory);
+  auto* Bd = reinterpret_cast<float*>(Bb->memory);
+  auto* Cd = reinterpret_cast<float*>(Cb->memory);
+  for (int i = 0; i < 96; ++i) {
+    ASSERT_FLOAT_EQ(Cd[i], Ad[i / 3] + Bd[i % 8]) << "index " << i;
+  }
+}
+
+}  // namespace optim
+}  // namespace cinn
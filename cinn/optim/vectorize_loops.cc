@@ -634,32 +634,43 @@ struct VectorizeLoops_ : public IRMutator<Expr *> {
       CHECK(is_zero(forloop->min));
       Expr for_extent = common::AutoSimplify(forloop->extent);
       Simplify(&for_extent);
-      node->extent     = for_extent;
-      auto *extent_min = for_extent.As<Min>();
-      auto *extent_max = for_extent.As<Max>();
+      node->extent = for_extent;
 
       vectorizable_ = true;
       IRMutator<>::Visit(&node->body, &node->body);
 
+      const int factor = forloop->vectorize_info().factor;
       if (target == common::DefaultNVGPUTarget()) {
-        if (!forloop->extent.As<IntImm>() || forloop->extent.as_int32() % forloop->vectorize_info().factor != 0) {
+        if (!forloop->extent.As<IntImm>()) {
           vectorizable_ = false;
-          VLOG(5) << "GPU vectorize only support extent is a multiple of factor";
+          VLOG(5) << "GPU vectorize only support constant extent";
         }
       }
+      if (forloop->extent.As<IntImm>() && forloop->extent.as_int32() < factor) {
+        vectorizable_ = false;
+        VLOG(5) << "The extent " << forloop->extent << " is less than the vectorize factor " << factor;
+      }
 
-      if (extent_min || extent_max || !vectorizable_) {
-        // not vectorize if has tail blocks, for llvm to optimize
+      if (!vectorizable_) {
         node->reset_vectorize_info();
         var_intervals.erase(forloop->loop_var->name);
         return;
       }
 
-      const int factor  = forloop->vectorize_info().factor;
+      // the iterations of the tail blocks or the ones beyond a multiple of factor run in a scalar epilogue,
+      // the epilogue is appended after the vectorized forloop on every return
+      Expr epilogue        = PeelTailLoop(node, factor);
+      auto append_epilogue = [&]() {
+        if (epilogue.defined()) {
+          *expr = Block::Make({*expr, epilogue});
+        }
+      };
+
       auto _new_forloop = SplitForLoop(node, factor);
       if (!_new_forloop.defined()) {
         IRMutator<>::Visit(&node->body, &node->body);
         var_intervals.erase(forloop->loop_var->name);
+        append_epilogue();
         return;
       }
 
@@ -674,6 +685,7 @@ struct VectorizeLoops_ : public IRMutator<Expr *> {
       if (!extent_int) {
         IRMutator<>::Visit(&node->body, &node->body);
         var_intervals.erase(forloop->loop_var->name);
+        append_epilogue();
         return;
       }
 
@@ -710,6 +722,7 @@ struct VectorizeLoops_ : public IRMutator<Expr *> {
       } else {
         node->body = new_forloop->body;
       }
+      append_epilogue();
     } else {
       IRMutator::Visit(forloop, expr);
     }
@@ -781,6 +794,34 @@ struct VectorizeLoops_ : public IRMutator<Expr *> {
     return false;
   }
 
+  //! Peel the iterations of the forloop beyond the largest multiple of \p factor into a scalar forloop,
+  //! and shrink the extent of the forloop to that multiple, so it can be split by \p factor exactly.
+  //! @return The scalar forloop, or an undefined Expr if the extent is a multiple of \p factor.
+  Expr PeelTailLoop(For *forloop, int factor) {
+    CHECK_GT(factor, 1);
+    Type extent_type = forloop->extent->type();
+    Expr main_extent;
+    if (forloop->extent.As<IntImm>()) {
+      int extent_int = forloop->extent.as_int32();
+      if (extent_int % factor == 0) return Expr();
+      main_extent = make_const(extent_type, extent_int / factor * factor);
+    } else {
+      Expr factor_expr = make_const(extent_type, factor);
+      main_extent      = Mul::Make(Div::Make(forloop->extent, factor_expr), factor_expr);
+    }
+    VLOG(3) << "Peel the iterations of " << forloop->loop_var << " from " << main_extent << " to " << forloop->extent;
+
+    // the epilogue is a sibling of the forloop, so it can reuse the loop var
+    Expr epilogue = For::Make(forloop->loop_var,
+                              IRCopy(main_extent),
+                              IRCopy(forloop->extent),
+                              ForType::Serial,
+                              forloop->device_api,
+                              IRCopy(forloop->body));
+    forloop->extent = main_extent;
+    return epilogue;
+  }
+
   //! Split the forloop with size \p factor.
   //! @return The new forloop.
   Expr SplitForLoop(For *forloop, int factor) {
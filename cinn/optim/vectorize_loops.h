@@ -21,6 +21,8 @@ namespace optim {
 
 /**
  * Vectorize the forloops(For) if its for_type is marked as kVectorize.
+ * If the extent is not a multiple of the vectorize factor, the iterations beyond the largest multiple are peeled
+ * into a scalar forloop after the vectorized one.
  * @param expr
  * @param target
  */
@@ -21,6 +21,7 @@
 #include "cinn/cinn.h"
 #include "cinn/common/common.h"
 #include "cinn/common/ir_util.h"
+#include "cinn/ir/collect_ir_nodes.h"
 #include "cinn/ir/ir_operators.h"
 #include "cinn/optim/ir_simplify.h"
 #include "cinn/optim/optimize.h"
@@ -79,9 +80,12 @@ void matmul(void* _args, int32_t num_args)
   const float* B = ((const float*)(_B->memory));
   float* C = ((float*)(_C->memory));
   for (int32_t i = 0; i < 100; i += 1) {
-    for (int32_t j = 0; j < 32; j += 1) {
+    for (int32_t j = 0; j < 31; j += 1) {
       C[StackVec<16,int32_t>::Ramp(((500 * i) + (16 * j)), 1, 16)] = (StackedVec<float,16>::Load(A,((500 * i) + (16 * j))) * StackedVec<float,16>::Load(B,((500 * i) + (16 * j))));
     };
+    for (int32_t j = 496; j < 500; j += 1) {
+      C[((500 * i) + j)] = (A[((500 * i) + j)] * B[((500 * i) + j)]);
+    };
   };
   cinn_buffer_free((void*)(0), _C);
 }
@@ -232,6 +236,111 @@ TEST(Vectorize, single_for) {
   LOG(INFO) << "Forloop\n" << forloop;
 }
 
+TEST(Vectorize, tail_loop) {
+  Placeholder<float> A("A", std::vector<int>{{10}});
+  Placeholder<float> B("B", std::vector<int>{{10}});
+  Placeholder<float> C("C", std::vector<int>{{10}});
+
+  Var loop_var("k0");
+
+  Expr body = Store::Make(ir::Tensor(C),
+                          ir::Add::Make(  //
+                              ir::Load::Make(ir::Tensor(A), {Expr(loop_var)}),
+                              ir::Load::Make(ir::Tensor(B), {Expr(loop_var)})),
+                          {Expr(loop_var)});
+  body      = ir::Block::Make({body});
+
+  VectorizeInfo vectorize_info(0, 4);
+  auto forloop = ir::For::Make(loop_var,
+                               common::make_const(0),
+                               common::make_const(10),
+                               ir::ForType::Vectorized,
+                               ir::DeviceAPI::UNK,
+                               body,
+                               vectorize_info);
+
+  optim::VectorizeLoops(&forloop, common::DefaultHostTarget());
+  LOG(INFO) << "Forloop\n" << forloop;
+
+  // the first 8 iterations are vectorized, and the last 2 ones are peeled into a scalar forloop
+  auto *block = forloop.As<ir::Block>();
+  ASSERT_TRUE(block);
+  ASSERT_EQ(block->stmts.size(), 2UL);
+  auto *main_loop = block->stmts[0].As<ir::For>();
+  ASSERT_TRUE(main_loop);
+  ASSERT_FALSE(main_loop->is_vectorized());
+  ASSERT_EQ(main_loop->extent.as_int32(), 2);
+  auto stores = ir::CollectIRNodesWithoutTensor(main_loop->body, [](const Expr *x) { return x->As<ir::Store>(); });
+  ASSERT_EQ(stores.size(), 1UL);
+  ASSERT_EQ(stores.begin()->As<ir::Store>()->value.type().lanes(), 4);
+
+  auto *tail_loop = block->stmts[1].As<ir::For>();
+  ASSERT_TRUE(tail_loop);
+  ASSERT_TRUE(tail_loop->is_serial());
+  ASSERT_EQ(tail_loop->min.as_int32(), 8);
+  ASSERT_EQ(tail_loop->extent.as_int32(), 10);
+  stores = ir::CollectIRNodesWithoutTensor(tail_loop->body, [](const Expr *x) { return x->As<ir::Store>(); });
+  ASSERT_EQ(stores.size(), 1UL);
+  ASSERT_EQ(stores.begin()->As<ir::Store>()->value.type().lanes(), 1);
+}
+
+TEST(Vectorize, tail_loop_with_variable_extent) {
+  Placeholder<float> A("A", std::vector<int>{{10}});
+  Placeholder<float> B("B", std::vector<int>{{10}});
+  Placeholder<float> C("C", std::vector<int>{{10}});
+
+  Var n("n");
+  // the extents generated by poly for the tail blocks are like min(n, 10)
+  std::vector<Expr> extents = {ir::Min::Make(Expr(n), Expr(10)), ir::Max::Make(Expr(n), Expr(6))};
+  for (const Expr &extent : extents) {
+    Var loop_var("k0");
+    Expr body = Store::Make(ir::Tensor(C),
+                            ir::Add::Make(  //
+                                ir::Load::Make(ir::Tensor(A), {Expr(loop_var)}),
+                                ir::Load::Make(ir::Tensor(B), {Expr(loop_var)})),
+                            {Expr(loop_var)});
+    body      = ir::Block::Make({body});
+
+    VectorizeInfo vectorize_info(0, 4);
+    auto forloop = ir::For::Make(
+        loop_var, common::make_const(0), extent, ir::ForType::Vectorized, ir::DeviceAPI::UNK, body, vectorize_info);
+
+    optim::VectorizeLoops(&forloop, common::DefaultHostTarget());
+    LOG(INFO) << "Forloop\n" << forloop;
+
+    // the iterations before the multiple of 4 are vectorized, and the others are peeled into a scalar forloop
+    auto *block = forloop.As<ir::Block>();
+    ASSERT_TRUE(block);
+    ASSERT_EQ(block->stmts.size(), 2UL);
+    auto *main_loop = block->stmts[0].As<ir::For>();
+    ASSERT_TRUE(main_loop);
+    ASSERT_FALSE(main_loop->is_vectorized());
+    ASSERT_FALSE(main_loop->extent.is_constant());
+    auto stores = ir::CollectIRNodesWithoutTensor(main_loop->body, [](const Expr *x) { return x->As<ir::Store>(); });
+    ASSERT_EQ(stores.size(), 1UL);
+    auto *vector_store = stores.begin()->As<ir::Store>();
+    ASSERT_EQ(vector_store->value.type().lanes(), 4);
+    ASSERT_EQ(vector_store->indices.size(), 1UL);
+    ASSERT_TRUE(vector_store->indices[0].As<ir::Ramp>());
+
+    // the epilogue runs from the multiple of 4 to the original extent
+    auto *tail_loop = block->stmts[1].As<ir::For>();
+    ASSERT_TRUE(tail_loop);
+    ASSERT_TRUE(tail_loop->is_serial());
+    ASSERT_EQ(tail_loop->loop_var->name, loop_var->name);
+    auto *tail_min = tail_loop->min.As<ir::Mul>();
+    ASSERT_TRUE(tail_min);
+    ASSERT_TRUE(tail_min->a().As<ir::Div>());
+    ASSERT_EQ(tail_min->b().as_int32(), 4);
+    ASSERT_EQ(tail_loop->extent.node_type(), extent.node_type());
+    stores = ir::CollectIRNodesWithoutTensor(tail_loop->body, [](const Expr *x) { return x->As<ir::Store>(); });
+    ASSERT_EQ(stores.size(), 1UL);
+    auto *scalar_store = stores.begin()->As<ir::Store>();
+    ASSERT_EQ(scalar_store->value.type().lanes(), 1);
+    ASSERT_EQ(GetStreamCnt(scalar_store->indices[0]), loop_var->name);
+  }
+}
+
 TEST(Vectorize, cuda_vectorize) {
   Expr M(100);
   Expr N(500);
@@ -19,6 +19,7 @@
 #include <utility>
 
 #include "cinn/common/common.h"
+#include "cinn/common/ir_util.h"
 #include "cinn/ir/ir.h"
 
 namespace cinn {
@@ -426,9 +427,18 @@ void IslAstExprToCinnExpr(const isl::ast_expr& node, ir::Expr* expr) {
         ops.push_back(op);
       }
 
+      // the integers may be shared by the hash-consing of IrArena, so they are remade instead of mutated
+      auto set_op_type = [](ir::Expr* op, ir::Type type) {
+        if (op->type() == type) return;
+        if (auto* imm = op->As<ir::IntImm>()) {
+          *op = common::make_const(type, imm->value);
+        } else {
+          (*op)->set_type(type);
+        }
+      };
       auto set_ops_ptype = [&](ir::Type type) {
         for (auto& op : ops) {
-          op->set_type(type);
+          set_op_type(&op, type);
         }
       };
 
@@ -501,7 +511,7 @@ void IslAstExprToCinnExpr(const isl::ast_expr& node, ir::Expr* expr) {
           break;
         case isl_ast_op_select:
           CHECK_EQ(ops.size(), 3UL) << "In ir::Select, the ops size should be 3";
-          ops[0]->set_type(Bool());
+          set_op_type(&ops[0], Bool());
           *expr = ir::Select::Make(ops[0], ops[1], ops[2]);
           break;
         default:
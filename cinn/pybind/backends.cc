@@ -38,7 +38,15 @@ void BindExecutionEngine(py::module *m) {
   py::class_<ExecutionOptions> options(*m, "ExecutionOptions");
   options.def(py::init<>())
       .def_readwrite("opt_level", &ExecutionOptions::opt_level)
-      .def_readwrite("enable_debug_info", &ExecutionOptions::enable_debug_info);
+      .def_readwrite("enable_debug_info", &ExecutionOptions::enable_debug_info)
+      .def_readwrite("object_cache_dir", &ExecutionOptions::object_cache_dir)
+      .def_readwrite("use_new_pass_manager", &ExecutionOptions::use_new_pass_manager)
+      .def_readwrite("enable_fast_math", &ExecutionOptions::enable_fast_math)
+      .def_readwrite("loop_vectorize", &ExecutionOptions::loop_vectorize)
+      .def_readwrite("slp_vectorize", &ExecutionOptions::slp_vectorize)
+      .def_readwrite("target_cpu", &ExecutionOptions::target_cpu)
+      .def_readwrite("target_features", &ExecutionOptions::target_features)
+      .def_readwrite("num_compile_threads", &ExecutionOptions::num_compile_threads);
 
   auto lookup = [](ExecutionEngine &self, absl::string_view name) {
     auto *function_ptr    = reinterpret_cast<void (*)(void **, int32_t)>(self.Lookup(name));
@@ -69,8 +77,8 @@ void BindExecutionEngine(py::module *m) {
 
     py::class_<Compiler> compiler(*m, "Compiler");
     compiler
-        .def_static("create", &Compiler::Create)  //
-        .def("build", &Compiler::BuildDefault)    //
+        .def_static("create", &Compiler::Create, py::arg("target"), py::arg("options") = ExecutionOptions())  //
+        .def("build", &Compiler::BuildDefault)                                                                //
         .def("lookup", lookup);
   }
 }
@@ -0,0 +1,255 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/runtime/cpu/parallel_launcher.h"
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <mutex>
+#include <new>
+#if defined(_M_X64) || defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+DECLARE_string(cinn_parallel_launch_schedule);
+DECLARE_bool(cinn_parallel_launch_bind_cores);
+DECLARE_int32(cinn_parallel_launch_spin_count);
+
+namespace cinn {
+namespace runtime {
+namespace cpu {
+
+namespace {
+
+// whether the current thread is running the tasks of a launch, the nested launches run in serial
+thread_local bool in_parallel_region = false;
+
+// the number of the forks the process has gone through, increased in the child process
+std::atomic<int> num_forks{0};
+
+void RegisterForkHandler() {
+#if defined(__linux__)
+  static std::once_flag flag;
+  std::call_once(flag, [] {
+    pthread_atfork(nullptr, nullptr, [] { num_forks.fetch_add(1, std::memory_order_relaxed); });
+  });
+#endif
+}
+
+inline void CpuRelax() {
+#if defined(_M_X64) || defined(__x86_64__)
+  _mm_pause();
+#else
+  std::this_thread::yield();
+#endif
+}
+
+int RunSerial(FCINNParallelLambda flambda, void* datas, int num_task) {
+  int ret_code = 0;
+  for (int task_id = 0; task_id < num_task; ++task_id) {
+    int ret = (*flambda)(task_id, num_task, datas);
+    if (ret != 0) {
+      ret_code = ret;
+    }
+  }
+  return ret_code;
+}
+
+void BindCore(int worker_id) {
+#if defined(__linux__)
+  // choose among the cores the process is allowed to run on
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+    LOG(WARNING) << "Failed to get the CPU affinity of the process, worker " << worker_id << " is not bound";
+    return;
+  }
+  std::vector<int> cores;
+  for (int i = 0; i < CPU_SETSIZE; ++i) {
+    if (CPU_ISSET(i, &allowed)) {
+      cores.push_back(i);
+    }
+  }
+  if (cores.empty()) {
+    return;
+  }
+  cpu_set_t cpuset;
+  CPU_ZERO(&cpuset);
+  CPU_SET(cores[worker_id % cores.size()], &cpuset);
+  if (pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset) != 0) {
+    LOG(WARNING) << "Failed to bind worker " << worker_id << " to core " << cores[worker_id % cores.size()];
+  }
+#else
+  VLOG(3) << "Binding workers to cores is only supported on Linux";
+#endif
+}
+
+}  // namespace
+
+ParallelLauncher::ParallelLauncher(const Config& config) : config_(config) {
+  CHECK_GT(config_.num_threads, 0) << "The number of threads should be greater than 0";
+  CHECK_GT(config_.chunks_per_thread, 0) << "The number of chunks per thread should be greater than 0";
+  RegisterForkHandler();
+  fork_epoch_ = num_forks.load(std::memory_order_relaxed);
+  workers_.reserve(config_.num_threads - 1);
+  for (int worker_id = 1; worker_id < config_.num_threads; ++worker_id) {
+    workers_.emplace_back(&ParallelLauncher::WorkerLoop, this, worker_id);
+  }
+  VLOG(4) << "ParallelLauncher launched with " << config_.num_threads << " workers";
+}
+
+ParallelLauncher::~ParallelLauncher() {
+  if (InForkedChild()) {
+    // neither the threads of the workers nor the parked waiters of park_cv_ exist in this process, so the threads
+    // are abandoned instead of joined, and park_cv_ is reset, otherwise destroying it waits for the waiters forever
+    new std::vector<std::thread>(std::move(workers_));
+    new (&park_cv_) std::condition_variable();
+    return;
+  }
+  stop_.store(true);
+  {
+    std::lock_guard<std::mutex> lock(park_mtx_);
+  }
+  park_cv_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+ParallelLauncher& ParallelLauncher::Global() {
+  static ParallelLauncher launcher([] {
+    Config config;
+    config.num_threads = max_concurrency();
+    config.schedule    = ParseSchedule(FLAGS_cinn_parallel_launch_schedule);
+    config.bind_cores  = FLAGS_cinn_parallel_launch_bind_cores;
+    config.spin_count  = FLAGS_cinn_parallel_launch_spin_count;
+    return config;
+  }());
+  return launcher;
+}
+
+ParallelLauncher::Schedule ParallelLauncher::ParseSchedule(const std::string& schedule) {
+  if (schedule == "static") {
+    return Schedule::kStatic;
+  } else if (schedule == "chunked") {
+    return Schedule::kChunked;
+  }
+  LOG(FATAL) << "Unknown schedule of parallel launch: " << schedule << ", only static and chunked are supported";
+  return Schedule::kStatic;
+}
+
+int ParallelLauncher::Launch(FCINNParallelLambda flambda, void* datas, int num_task) {
+  if (num_task == 0) {
+    num_task = config_.num_threads;
+    if (config_.schedule == Schedule::kChunked) {
+      num_task *= config_.chunks_per_thread;
+    }
+  }
+  if (config_.num_threads == 1 || num_task == 1 || in_parallel_region || InForkedChild()) {
+    return RunSerial(flambda, datas, num_task);
+  }
+  std::unique_lock<std::mutex> launch_lock(launch_mtx_, std::try_to_lock);
+  if (!launch_lock.owns_lock()) {
+    // the pool is used by a launch from another thread, such as the instructions executed concurrently
+    return RunSerial(flambda, datas, num_task);
+  }
+
+  flambda_  = flambda;
+  datas_    = datas;
+  num_task_ = num_task;
+  next_task_.store(0, std::memory_order_relaxed);
+  ret_code_.store(0, std::memory_order_relaxed);
+  unfinished_workers_.store(config_.num_threads - 1, std::memory_order_relaxed);
+  generation_.fetch_add(1);
+  if (num_parked_.load() > 0) {
+    {
+      std::lock_guard<std::mutex> lock(park_mtx_);
+    }
+    park_cv_.notify_all();
+  }
+
+  in_parallel_region = true;
+  RunTasks(0);
+  in_parallel_region = false;
+
+  for (int spins = 0; unfinished_workers_.load(std::memory_order_acquire) > 0; ++spins) {
+    if (spins < config_.spin_count) {
+      CpuRelax();
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  return ret_code_.load(std::memory_order_relaxed);
+}
+
+bool ParallelLauncher::InForkedChild() const {
+  return num_forks.load(std::memory_order_relaxed) != fork_epoch_;
+}
+
+void ParallelLauncher::RunTasks(int worker_id) {
+  auto run_task = [this](int task_id) {
+    int ret = (*flambda_)(task_id, num_task_, datas_);
+    if (ret != 0) {
+      ret_code_.store(ret, std::memory_order_relaxed);
+    }
+  };
+  if (config_.schedule == Schedule::kStatic) {
+    for (int task_id = worker_id; task_id < num_task_; task_id += config_.num_threads) {
+      run_task(task_id);
+    }
+  } else {
+    int task_id;
+    while ((task_id = next_task_.fetch_add(1, std::memory_order_relaxed)) < num_task_) {
+      run_task(task_id);
+    }
+  }
+}
+
+void ParallelLauncher::WorkerLoop(int worker_id) {
+  if (config_.bind_cores) {
+    BindCore(worker_id);
+  }
+  in_parallel_region = true;
+  uint64_t seen      = 0;
+  while (true) {
+    // spin for a while to catch the next launch quickly, then park until woken up
+    int spins = 0;
+    while (generation_.load(std::memory_order_acquire) == seen && !stop_.load(std::memory_order_acquire)) {
+      if (++spins < config_.spin_count) {
+        CpuRelax();
+        continue;
+      }
+      std::unique_lock<std::mutex> lock(park_mtx_);
+      num_parked_.fetch_add(1);
+      park_cv_.wait(lock, [this, seen] { return generation_.load() != seen || stop_.load(); });
+      num_parked_.fetch_sub(1);
+    }
+    if (stop_.load(std::memory_order_acquire)) {
+      return;
+    }
+    seen = generation_.load(std::memory_order_acquire);
+    RunTasks(worker_id);
+    unfinished_workers_.fetch_sub(1, std::memory_order_release);
+  }
+}
+
+}  // namespace cpu
+}  // namespace runtime
+}  // namespace cinn
@@ -0,0 +1,121 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cinn/common/macros.h"
+#include "cinn/runtime/cpu/thread_backend.h"
+
+namespace cinn {
+namespace runtime {
+namespace cpu {
+
+/**
+ * ParallelLauncher runs the parallel lambdas generated for the parallel loops on a persistent pool of workers.
+ *
+ * The calling thread works as the 0-th worker, and the other workers spin for a while after finishing a launch
+ * before parking themselves, so the back-to-back small parallel loops of a kernel don't pay for the fork/join
+ * of threads. Launches from multiple threads are serialized, a launch happening while the pool is busy or
+ * nested in a parallel lambda runs all its tasks on the calling thread. A child process forked after the
+ * launcher is created doesn't inherit the workers, so the launches in it run on the calling thread too.
+ */
+class ParallelLauncher {
+ public:
+  enum class Schedule {
+    // the i-th worker runs the tasks i, i + num_threads, i + 2 * num_threads, ...
+    kStatic,
+    // the tasks are split finer and the workers fetch them one by one, to balance the uneven tasks
+    kChunked,
+  };
+
+  struct Config {
+    // the number of workers including the calling thread
+    int num_threads = 1;
+    Schedule schedule = Schedule::kStatic;
+    // the number of tasks per worker when the schedule is kChunked and the number of tasks is not specified
+    int chunks_per_thread = 4;
+    // whether to pin every background worker to a CPU core
+    bool bind_cores = false;
+    // the number of spinning iterations before a waiting thread parks or yields
+    int spin_count = 10000;
+  };
+
+  explicit ParallelLauncher(const Config& config);
+
+  ~ParallelLauncher();
+
+  // the launcher configured by max_concurrency() and the cinn_parallel_launch_* flags
+  static ParallelLauncher& Global();
+
+  static Schedule ParseSchedule(const std::string& schedule);
+
+  /**
+   * Run flambda(task_id, num_task, datas) for every task_id in [0, num_task) and wait for them.
+   * @param num_task The number of tasks, 0 means deciding by the number of workers and the schedule.
+   * @return 0 if all the tasks succeed, otherwise the non-zero code returned by a failed task.
+   */
+  int Launch(FCINNParallelLambda flambda, void* datas, int num_task);
+
+  int num_threads() const { return config_.num_threads; }
+
+ private:
+  // the main loop of the background workers, worker_id starts from 1
+  void WorkerLoop(int worker_id);
+
+  // run the tasks of the current launch assigned to the worker
+  void RunTasks(int worker_id);
+
+  // whether the launcher is used in a child process forked after it was created, where the workers don't exist
+  bool InForkedChild() const;
+
+  Config config_;
+  std::vector<std::thread> workers_;
+  // the number of forks the process had gone through when the workers were created
+  int fork_epoch_{0};
+
+  // the current launch, written before increasing generation_ and read by the workers after observing it
+  FCINNParallelLambda flambda_{nullptr};
+  void* datas_{nullptr};
+  int num_task_{0};
+
+  // increased by every launch to wake up the workers
+  std::atomic<uint64_t> generation_{0};
+  // the next task to fetch for the kChunked schedule
+  std::atomic<int> next_task_{0};
+  // the number of background workers that have not finished the current launch
+  std::atomic<int> unfinished_workers_{0};
+  std::atomic<int> ret_code_{0};
+  std::atomic<bool> stop_{false};
+
+  // serializes the launches from different threads
+  std::mutex launch_mtx_;
+  // the parked workers wait on park_cv_ for the next launch
+  std::mutex park_mtx_;
+  std::condition_variable park_cv_;
+  std::atomic<int> num_parked_{0};
+
+  CINN_DISALLOW_COPY_AND_ASSIGN(ParallelLauncher);
+};
+
+}  // namespace cpu
+}  // namespace runtime
+}  // namespace cinn
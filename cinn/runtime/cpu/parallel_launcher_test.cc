@@ -0,0 +1,106 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/runtime/cpu/parallel_launcher.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <vector>
+
+namespace cinn {
+namespace runtime {
+namespace cpu {
+
+namespace {
+
+struct TaskRecord {
+  std::vector<std::atomic<int>> counts;
+  std::atomic<int> num_task_seen{0};
+
+  explicit TaskRecord(int max_tasks) : counts(max_tasks) {}
+};
+
+int RecordTask(int task_id, int num_task, void* datas) {
+  auto* record = static_cast<TaskRecord*>(datas);
+  record->counts[task_id]++;
+  record->num_task_seen = num_task;
+  return 0;
+}
+
+int FailOddTask(int task_id, int num_task, void* datas) { return task_id % 2 ? -1 : 0; }
+
+ParallelLauncher* nested_launcher = nullptr;
+int LaunchNested(int task_id, int num_task, void* datas) {
+  return nested_launcher->Launch(&RecordTask, datas, 2);
+}
+
+}  // namespace
+
+TEST(ParallelLauncher, StaticSchedule) {
+  ParallelLauncher::Config config;
+  config.num_threads = 4;
+  ParallelLauncher launcher(config);
+
+  // every task runs exactly once in each launch, and the workers are reused
+  TaskRecord record(64);
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_EQ(launcher.Launch(&RecordTask, &record, 0), 0);
+  }
+  EXPECT_EQ(record.num_task_seen, 4);
+  for (int task_id = 0; task_id < 4; ++task_id) {
+    EXPECT_EQ(record.counts[task_id], 100);
+  }
+
+  TaskRecord record2(64);
+  ASSERT_EQ(launcher.Launch(&RecordTask, &record2, 37), 0);
+  for (int task_id = 0; task_id < 37; ++task_id) {
+    EXPECT_EQ(record2.counts[task_id], 1);
+  }
+  EXPECT_EQ(record2.counts[37], 0);
+}
+
+TEST(ParallelLauncher, ChunkedSchedule) {
+  ParallelLauncher::Config config;
+  config.num_threads       = 3;
+  config.schedule          = ParallelLauncher::ParseSchedule("chunked");
+  config.chunks_per_thread = 4;
+  config.spin_count        = 0;
+  ParallelLauncher launcher(config);
+
+  TaskRecord record(64);
+  ASSERT_EQ(launcher.Launch(&RecordTask, &record, 0), 0);
+  EXPECT_EQ(record.num_task_seen, 12);
+  for (int task_id = 0; task_id < 12; ++task_id) {
+    EXPECT_EQ(record.counts[task_id], 1);
+  }
+}
+
+TEST(ParallelLauncher, ErrorAndNestedLaunch) {
+  ParallelLauncher::Config config;
+  config.num_threads = 4;
+  ParallelLauncher launcher(config);
+  EXPECT_NE(launcher.Launch(&FailOddTask, nullptr, 8), 0);
+
+  // the nested launches run in serial on the workers
+  nested_launcher = &launcher;
+  TaskRecord record(64);
+  ASSERT_EQ(launcher.Launch(&LaunchNested, &record, 4), 0);
+  EXPECT_EQ(record.counts[0], 4);
+  EXPECT_EQ(record.counts[1], 4);
+}
+
+}  // namespace cpu
+}  // namespace runtime
+}  // namespace cinn
@@ -20,9 +20,12 @@
 #include "cinn/backends/extern_func_jit_register.h"
 #include "cinn/backends/llvm/runtime_symbol_registry.h"
 #include "cinn/common/cas.h"
+#include "cinn/runtime/cpu/parallel_launcher.h"
 #include "cinn/runtime/intrinsic.h"
 
-int max_concurrency() {
+namespace {
+
+int GetMaxConcurrency() {
   int max_concurrency = 1;
   const char* val     = getenv("CINN_NUM_THREADS");
   if (val == nullptr) {
@@ -39,16 +42,16 @@ int max_concurrency() {
   return std::max(max_concurrency, 1);
 }
 
+}  // namespace
+
+int max_concurrency() {
+  // read the environment only once, as it is called by every parallel loop
+  static int max_concurrency = GetMaxConcurrency();
+  return max_concurrency;
+}
+
 int cinn_backend_parallel_launch(FCINNParallelLambda flambda, void* datas, int num_task) {
-  int num_workers = max_concurrency();
-  if (num_task == 0) num_task = num_workers;
-  omp_set_num_threads(num_task);
-#pragma omp parallel num_threads(num_task)
-  {
-    int thread_num = omp_get_thread_num();
-    (*flambda)(thread_num, num_task, datas);
-  }
-  return 0;
+  return cinn::runtime::cpu::ParallelLauncher::Global().Launch(flambda, datas, num_task);
 }
 
 CINN_REGISTER_HELPER(cinn_backend_parallel) {
@@ -37,6 +37,60 @@ DEFINE_int32(cinn_parallel_compile_size,
              Int32FromEnv("FLAGS_cinn_parallel_compile_size", 0),
              "When use parallel compile, set the number of group compiled by each thread.");
 
+DEFINE_int32(cinn_parallel_execute_threads,
+             Int32FromEnv("FLAGS_cinn_parallel_execute_threads", 0),
+             "The number of threads used to run independent instructions of a Program concurrently on CPU, "
+             "0 means running all instructions in order on the calling thread.");
+
+DEFINE_string(cinn_parallel_launch_schedule,
+              StringFromEnv("FLAGS_cinn_parallel_launch_schedule", "static"),
+              "How the tasks of a parallel loop on CPU are distributed over the workers, \"static\" assigns them in a "
+              "round-robin way and \"chunked\" lets the workers fetch finer tasks one by one.");
+
+DEFINE_bool(cinn_parallel_launch_bind_cores,
+            BoolFromEnv("FLAGS_cinn_parallel_launch_bind_cores", false),
+            "Whether to pin the workers running the parallel loops on CPU to cores.");
+
+DEFINE_int32(cinn_parallel_launch_spin_count,
+             Int32FromEnv("FLAGS_cinn_parallel_launch_spin_count", 10000),
+             "The number of iterations the workers running the parallel loops on CPU spin for the next loop before "
+             "sleeping.");
+
+DEFINE_string(cinn_caching_allocator_archs,
+              StringFromEnv("FLAGS_cinn_caching_allocator_archs", ""),
+              "The architectures whose memory is managed by a caching allocator which keeps the freed memory for "
+              "reuse, separated by comma, such as \"x86,nvgpu\". Empty means using the plain allocators.");
+
+DEFINE_int64(cinn_caching_allocator_max_cached_mb,
+             Int64FromEnv("FLAGS_cinn_caching_allocator_max_cached_mb", 1024L),
+             "The maximum size(in MB) of the freed memory kept by the caching allocator of each architecture, the "
+             "blocks freed beyond it are released directly. Negative means unlimited.");
+
+DEFINE_string(cinn_jit_object_cache_dir,
+              StringFromEnv("FLAGS_cinn_jit_object_cache_dir", ""),
+              "The directory to persist the objects compiled by the JIT ExecutionEngine, so they can be reused across "
+              "processes. Empty means only caching the objects in memory.");
+
+DEFINE_int64(cinn_jit_object_cache_capacity_mb,
+             Int64FromEnv("FLAGS_cinn_jit_object_cache_capacity_mb", 1024L),
+             "The maximum size(in MB) of the directory of the JIT object cache, the least recently used objects are "
+             "evicted when exceeding it.");
+
+DEFINE_string(cinn_tuning_artifact,
+              StringFromEnv("FLAGS_cinn_tuning_artifact", ""),
+              "The file of the tuning artifact exported by AutoTuner, the groups matching its fingerprints are lowered "
+              "with the tuned schedules replayed from the artifact. Empty means lowering with the default schedules.");
+
+DEFINE_bool(cinn_enable_kernel_cache,
+            BoolFromEnv("FLAGS_cinn_enable_kernel_cache", false),
+            "Whether to compile the structurally identical fused groups only once and share the kernel among them, "
+            "the kernels compiled by the parallel compiler are also reused by the later graphs in the process.");
+
+DEFINE_int32(cinn_kernel_cache_capacity,
+             Int32FromEnv("FLAGS_cinn_kernel_cache_capacity", 1024),
+             "The maximum number of kernels kept by the kernel cache, the least recently used ones are evicted when "
+             "exceeding it. 0 means unlimited.");
+
 DEFINE_bool(cinn_use_op_fusion, BoolFromEnv("FLAGS_cinn_use_op_fusion", true), "Whether to use op fusion pass.");
 
 DEFINE_bool(cinn_use_cudnn_conv, BoolFromEnv("FLAGS_cinn_use_cudnn_conv", true), "Whether to use cudnn convolution.");
@@ -56,6 +110,28 @@ DEFINE_bool(cinn_use_cuda_vectorize,
             BoolFromEnv("FLAGS_cinn_use_cuda_vectorize", false),
             "Whether use cuda vectroize on schedule config");
 
+DEFINE_bool(cinn_enable_cse_licm,
+            BoolFromEnv("FLAGS_cinn_enable_cse_licm", false),
+            "Whether to eliminate the common subexpressions and hoist the loop invariant Lets out of the forloops "
+            "when optimizing the lowered IR.");
+
+DEFINE_bool(cinn_enable_index_strength_reduction,
+            BoolFromEnv("FLAGS_cinn_enable_index_strength_reduction", false),
+            "Whether to compute the divisions and modulos of the non-negative indices by constants with shifts, masks "
+            "and multiplications, and hoist the loop invariant offsets of the indices out of the forloops.");
+
+DEFINE_bool(cinn_enable_ir_arena,
+            BoolFromEnv("FLAGS_cinn_enable_ir_arena", false),
+            "Whether to allocate the IR nodes from a per-thread arena while lowering and building the modules.");
+
+DEFINE_bool(cinn_ir_hash_consing,
+            BoolFromEnv("FLAGS_cinn_ir_hash_consing", false),
+            "Whether to share the IR immediates of the same value in the arena enabled by FLAGS_cinn_enable_ir_arena.");
+
+DEFINE_bool(cinn_enable_cas_simplify_cache,
+            BoolFromEnv("FLAGS_cinn_enable_cas_simplify_cache", false),
+            "Whether to cache the results of the CAS simplification of the expressions while lowering a group.");
+
 DEFINE_bool(cinn_ir_schedule,
             BoolFromEnv("FLAGS_cinn_ir_schedule", true),
             "Whether use reconstructed schedule primitives.");
@@ -0,0 +1,138 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/utils/thread_pool.h"
+
+#include <glog/logging.h>
+
+#include <utility>
+
+namespace cinn {
+namespace utils {
+
+namespace {
+// the pool and the index of the worker which the current thread belongs to
+thread_local const ThreadPool* current_pool = nullptr;
+thread_local int current_worker_id          = -1;
+}  // namespace
+
+ThreadPool::ThreadPool(int num_threads) {
+  if (num_threads == -1 || num_threads > std::thread::hardware_concurrency()) {
+    num_threads = std::thread::hardware_concurrency();
+  }
+  CHECK_GT(num_threads, 0) << "num_threads should be greater than 0";
+
+  queues_.reserve(num_threads);
+  for (int tid = 0; tid < num_threads; ++tid) {
+    queues_.emplace_back(std::make_unique<WorkQueue>());
+  }
+  threads_.reserve(num_threads);
+  for (int tid = 0; tid < num_threads; ++tid) {
+    threads_.emplace_back(&ThreadPool::WorkerLoop, this, tid);
+  }
+  VLOG(4) << "ThreadPool launched with " << num_threads << " workers";
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    stop_ = true;
+  }
+  worker_cv_.notify_all();
+  for (auto&& thread : threads_) {
+    thread.join();
+  }
+}
+
+void ThreadPool::Submit(TaskType task) {
+  auto& queue = current_pool == this ? *queues_[current_worker_id] : shared_queue_;
+  ++unfinished_tasks_;
+  {
+    std::lock_guard<std::mutex> lock(queue.mu);
+    queue.tasks.emplace_back(std::move(task));
+  }
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    ++queued_tasks_;
+  }
+  worker_cv_.notify_one();
+}
+
+void ThreadPool::Wait() {
+  CHECK(current_pool != this) << "ThreadPool::Wait can't be called from its own worker";
+  std::unique_lock<std::mutex> lock(mu_);
+  finished_cv_.wait(lock, [this] { return unfinished_tasks_ == 0; });
+}
+
+bool ThreadPool::PopTask(int tid, TaskType* task) {
+  // the local queue is accessed from the back to keep locality
+  {
+    auto& local = *queues_[tid];
+    std::lock_guard<std::mutex> lock(local.mu);
+    if (!local.tasks.empty()) {
+      *task = std::move(local.tasks.back());
+      local.tasks.pop_back();
+      return true;
+    }
+  }
+  // the tasks submitted from outside are started in order
+  {
+    std::lock_guard<std::mutex> lock(shared_queue_.mu);
+    if (!shared_queue_.tasks.empty()) {
+      *task = std::move(shared_queue_.tasks.front());
+      shared_queue_.tasks.pop_front();
+      return true;
+    }
+  }
+  // steal the oldest task of other workers
+  for (int i = 1; i < queues_.size(); ++i) {
+    auto& victim = *queues_[(tid + i) % queues_.size()];
+    std::lock_guard<std::mutex> lock(victim.mu);
+    if (!victim.tasks.empty()) {
+      *task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      return true;
+    }
+  }
+  return false;
+}
+
+void ThreadPool::WorkerLoop(int tid) {
+  current_pool      = this;
+  current_worker_id = tid;
+
+  TaskType task;
+  while (true) {
+    if (PopTask(tid, &task)) {
+      --queued_tasks_;
+      task();
+      task = nullptr;
+      if (--unfinished_tasks_ == 0) {
+        // take the lock to avoid missing the notification by a waiter
+        std::lock_guard<std::mutex> lock(mu_);
+        finished_cv_.notify_all();
+      }
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(mu_);
+    worker_cv_.wait(lock, [this] { return stop_ || queued_tasks_ > 0; });
+    if (stop_ && queued_tasks_ == 0) {
+      break;
+    }
+  }
+}
+
+}  // namespace utils
+}  // namespace cinn
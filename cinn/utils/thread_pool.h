@@ -0,0 +1,88 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cinn {
+namespace utils {
+
+/**
+ * A thread pool with work stealing.
+ *
+ * Every worker owns a task queue. A task submitted from a worker thread is pushed to the local queue of
+ * that worker and popped in LIFO order, so a chain of dependent tasks tends to stay on the same core.
+ * Tasks submitted from outside the pool are pushed to a shared queue and popped in FIFO order, so they
+ * start in the order of submission. A worker runs its local tasks first, then the shared ones, and an
+ * idle worker steals the oldest task from the queues of other workers.
+ */
+class ThreadPool {
+ public:
+  using TaskType = std::function<void()>;
+
+  /**
+   * Constructor.
+   * @param num_threads The number of worker threads, -1 means utilizing the maximum limit of hardware.
+   */
+  explicit ThreadPool(int num_threads = -1);
+
+  ~ThreadPool();
+
+  // Add a task into the pool, it will be executed by a worker asynchronously
+  void Submit(TaskType task);
+
+  // Block the calling thread until all the submitted tasks are finished.
+  // Attention!! this interface can't be called from a task running in this pool.
+  void Wait();
+
+  int num_threads() const { return threads_.size(); }
+
+ private:
+  struct WorkQueue {
+    std::mutex mu;
+    std::deque<TaskType> tasks;
+  };
+
+  // the main loop of the tid-th worker
+  void WorkerLoop(int tid);
+
+  // pop a task from the local queue of the tid-th worker, or steal one from the others
+  bool PopTask(int tid, TaskType* task);
+
+  std::vector<std::unique_ptr<WorkQueue>> queues_;
+  // the tasks submitted from outside the pool
+  WorkQueue shared_queue_;
+  std::vector<std::thread> threads_;
+
+  // protects the sleeping and waking up of workers and waiters
+  std::mutex mu_;
+  std::condition_variable worker_cv_;
+  std::condition_variable finished_cv_;
+  // the number of tasks which have been pushed into queues but not popped yet
+  std::atomic<int> queued_tasks_{0};
+  // the number of tasks which have been submitted but not finished yet
+  std::atomic<int> unfinished_tasks_{0};
+  bool stop_{false};
+};
+
+}  // namespace utils
+}  // namespace cinn
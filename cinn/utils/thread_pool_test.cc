@@ -0,0 +1,84 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/utils/thread_pool.h"
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace cinn {
+namespace utils {
+
+TEST(ThreadPool, Basic) {
+  ThreadPool pool(4);
+  // the number of workers is limited by the hardware
+  ASSERT_GT(pool.num_threads(), 0);
+  ASSERT_LE(pool.num_threads(), 4);
+
+  std::vector<int> results(100, -1);
+  for (int i = 0; i < 100; ++i) {
+    pool.Submit([&results, i]() { results[i] = i; });
+  }
+  pool.Wait();
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_EQ(results[i], i);
+  }
+}
+
+TEST(ThreadPool, SubmitFromWorker) {
+  ThreadPool pool(3);
+  std::atomic<int> counter{0};
+  // every task spawns its children, the pool should wait all of them finished
+  std::function<void(int)> spawn = [&](int depth) {
+    ++counter;
+    if (depth > 0) {
+      pool.Submit([&spawn, depth]() { spawn(depth - 1); });
+      pool.Submit([&spawn, depth]() { spawn(depth - 1); });
+    }
+  };
+  pool.Submit([&spawn]() { spawn(6); });
+  pool.Wait();
+  // a full binary tree with depth 6 has 2^7 - 1 nodes
+  ASSERT_EQ(counter.load(), 127);
+
+  // the pool can be reused after waiting
+  pool.Submit([&counter]() { ++counter; });
+  pool.Wait();
+  ASSERT_EQ(counter.load(), 128);
+}
+
+TEST(ThreadPool, SubmitFromOutsideInOrder) {
+  ThreadPool pool(1);
+  // hold the only worker until all the tasks are queued
+  std::atomic<bool> released{false};
+  pool.Submit([&released]() {
+    while (!released) {
+      std::this_thread::yield();
+    }
+  });
+  std::vector<int> order;
+  for (int i = 0; i < 10; ++i) {
+    pool.Submit([&order, i]() { order.push_back(i); });
+  }
+  released = true;
+  pool.Wait();
+  ASSERT_EQ(order, std::vector<int>({0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+}
+
+}  // namespace utils
+}  // namespace cinn